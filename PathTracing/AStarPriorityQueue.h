@@ -0,0 +1,171 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <cassert>
+#include <vector>
+
+constexpr int32_t InvalidHeapIndex = -1;
+
+/* Entry of open list, allocated once for every cell discovered during search */
+struct Node
+{
+    PathFindingPoint Point;
+    PathCost Heuristics = 0;
+    PathCost EvaluationFunc = 0;
+
+    /* Slot in open list heap, InvalidHeapIndex when node is not in open list */
+    int32_t HeapIndex = InvalidHeapIndex;
+
+    Node(PathFindingPoint p) :
+        Point(p)
+    {
+    }
+};
+
+struct CompareNode
+{
+    /* Returns true when a should be popped before b. On equal evaluation
+       prefer node with smaller heuristics, as it lies closer to the goal */
+    bool operator()(const Node* a, const Node* b) const
+    {
+        if (a->EvaluationFunc != b->EvaluationFunc)
+        {
+            return a->EvaluationFunc < b->EvaluationFunc;
+        }
+
+        return a->Heuristics < b->Heuristics;
+    }
+};
+
+/* Binary min heap of nodes. Every node remembers its own slot in heap, so
+   node already present in open list can be moved up in O(log n) when cheaper
+   path to it is found, instead of searching for it and pushing duplicate */
+class AStarPriorityQueue
+{
+public:
+    void Push(Node* node)
+    {
+        assert(node->HeapIndex == InvalidHeapIndex);
+        m_Heap.push_back(node);
+        SiftUp(static_cast<int32_t>(m_Heap.size()) - 1);
+    }
+
+    Node* Pop()
+    {
+        Node* top = m_Heap.front();
+        Node* last = m_Heap.back();
+        m_Heap.pop_back();
+
+        if (!m_Heap.empty())
+        {
+            Place(last, 0);
+            SiftDown(0);
+        }
+
+        top->HeapIndex = InvalidHeapIndex;
+        return top;
+    }
+
+    Node* Top() const
+    {
+        return m_Heap.front();
+    }
+
+    /* Lowers evaluation of node already in open list */
+    void DecreaseKey(Node* node, PathCost evaluationFunc)
+    {
+        assert(Contains(node) && evaluationFunc <= node->EvaluationFunc);
+        node->EvaluationFunc = evaluationFunc;
+        SiftUp(node->HeapIndex);
+    }
+
+    bool Contains(const Node* node) const
+    {
+        return node->HeapIndex != InvalidHeapIndex;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_Heap.empty();
+    }
+
+    void Clear()
+    {
+        m_Heap.clear();
+    }
+
+    /* Visits nodes in no particular order */
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        for (const Node* node : m_Heap)
+        {
+            func(node);
+        }
+    }
+
+private:
+    std::vector<Node*> m_Heap;
+    CompareNode m_Compare;
+
+private:
+    void Place(Node* node, int32_t index)
+    {
+        m_Heap[index] = node;
+        node->HeapIndex = index;
+    }
+
+    void SiftUp(int32_t index)
+    {
+        Node* node = m_Heap[index];
+
+        while (index > 0)
+        {
+            int32_t parentIndex = (index - 1) / 2;
+            Node* parent = m_Heap[parentIndex];
+
+            if (!m_Compare(node, parent))
+            {
+                break;
+            }
+
+            Place(parent, index);
+            index = parentIndex;
+        }
+
+        Place(node, index);
+    }
+
+    void SiftDown(int32_t index)
+    {
+        Node* node = m_Heap[index];
+        int32_t size = static_cast<int32_t>(m_Heap.size());
+
+        while (true)
+        {
+            int32_t childIndex = 2 * index + 1;
+
+            if (childIndex >= size)
+            {
+                break;
+            }
+
+            /* Pick better of two children */
+            if (childIndex + 1 < size && m_Compare(m_Heap[childIndex + 1], m_Heap[childIndex]))
+            {
+                ++childIndex;
+            }
+
+            if (!m_Compare(m_Heap[childIndex], node))
+            {
+                break;
+            }
+
+            Place(m_Heap[childIndex], index);
+            index = childIndex;
+        }
+
+        Place(node, index);
+    }
+};
@@ -1,6 +1,12 @@
 #include <glad/glad.h>
 #include "Application.h"
 #include "PathFindingAlgorithm.h"
+#include "JumpPointTable.h"
+#include "HierarchicalMap.h"
+#include "LandmarkTable.h"
+#include "ContractionHierarchy.h"
+#include "PathCache.h"
+#include "GeneticPathFinder.h"
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_glfw.h"
@@ -8,6 +14,7 @@
 
 #include "Renderer.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cstdlib>
 
 static float SnapToGrid(float value, float gridSize)
@@ -72,6 +79,9 @@ Application::Application(int width, int height, const char* title) :
 
     Renderer::Initialize();
     PathFindingAlgorithm::Initialize();
+
+    /* JPS+ table takes few milliseconds, so it is ready along with map */
+    PathFindingAlgorithm::UpdateTables(EPathFindingMode::JumpPointSearchPlus);
     s_AppInstance = this;
 }
 
@@ -99,6 +109,8 @@ void Application::Run()
         glfwPollEvents();
         Renderer::Clear();
 
+        StepPathSearches();
+
         if (IsAiUpdateFrame())
         {
             AiUpdate();
@@ -118,8 +130,6 @@ void Application::Run()
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        static int selectedPathAlgo;
-
         ImGui::Begin("Settings");
 
         static int rightClickOperationIndex = 1;
@@ -161,6 +171,17 @@ void Application::Run()
                 }
             }
             else if (rightClickOperationIndex == 2)
+            {
+                /* Painting with the same cost again resets cell back to default terrain */
+                uint8_t cost = static_cast<uint8_t>(m_TerrainBrushCost);
+                if (m_Map->GetTerrainCost(cursorPosSnapped) == cost)
+                {
+                    cost = DefaultTerrainCost;
+                }
+
+                m_Map->SetTerrainCost(cursorPosSnapped, cost);
+            }
+            else if (rightClickOperationIndex == 3)
             {
                 if (m_Map->GetFieldAt(cursorPosSnapped) == EFieldType::Player)
                 {
@@ -197,12 +218,18 @@ void Application::Run()
                     m_NumRightClickOptions = IM_ARRAYSIZE(m_Modes) - 1;
                 }
             }
-            else if (rightClickOperationIndex == 3)
+            else if (rightClickOperationIndex == 4)
             {
                 if (m_Players.size() < MaxAgents && m_Map->GetFieldAt(cursorPosSnapped) == EFieldType::Empty)
                 {
                     m_TargetPlayer = (int)m_Players.size();
                     m_Players.emplace_back(cursorPosSnapped, cursorPosSnapped);
+                    m_Players.back().SetNeighborhood(static_cast<ENeighborhood>(m_SelectedNeighborhood));
+                    m_Players.back().SetBackgroundPathSearch(m_bBackgroundPathSearch);
+                    m_Players.back().SetGeneticPathFinding(m_SelectedPathFindingMode == 1);
+                    m_Players.back().SetAnyAnglePathFinding(m_SelectedPathFindingMode == 2);
+                    m_Players.back().SetSearchMode(m_SearchModeValues[m_SelectedSearchMode]);
+                    m_Players.back().SetSuboptimalityBound(m_SuboptimalityBound);
 
                     if (bAutoSwitchToSelectingDestination)
                     {
@@ -219,13 +246,191 @@ void Application::Run()
         }
 
         ImGui::Checkbox("bAutoSwitchToTargetPostAddedAgent", &bAutoSwitchToSelectingDestination);
+        ImGui::SliderInt("Terrain brush cost", &m_TerrainBrushCost, DefaultTerrainCost, 255);
+
+        if (ImGui::Combo("Agent movement", &m_SelectedNeighborhood, m_Neighborhoods, IM_ARRAYSIZE(m_Neighborhoods)))
+        {
+            for (Player& player : m_Players)
+            {
+                player.SetNeighborhood(static_cast<ENeighborhood>(m_SelectedNeighborhood));
+            }
+        }
+
+        if (ImGui::Combo("Path finding", &m_SelectedPathFindingMode, m_PathFindingModes, IM_ARRAYSIZE(m_PathFindingModes)))
+        {
+            for (Player& player : m_Players)
+            {
+                player.SetGeneticPathFinding(m_SelectedPathFindingMode == 1);
+                player.SetAnyAnglePathFinding(m_SelectedPathFindingMode == 2);
+            }
+        }
+
+        if (m_SelectedPathFindingMode == 0 &&
+            ImGui::Combo("Grid search", &m_SelectedSearchMode, m_SearchModes, IM_ARRAYSIZE(m_SearchModes)))
+        {
+            /* Tables of selected mode start building before agents ask for paths */
+            EPathFindingMode mode = m_SearchModeValues[m_SelectedSearchMode];
+            PathFindingAlgorithm::UpdateTables(mode);
+
+            for (Player& player : m_Players)
+            {
+                player.SetSearchMode(mode);
+            }
+        }
+
+        const GeneticStats& geneticStats = PathFindingAlgorithm::GetLastGeneticStats();
+        if (m_SelectedPathFindingMode == 1 && geneticStats.Generations > 0)
+        {
+            ImGui::Text("Genetic: %d generations in %.1f ms (%.0f per second), goal first reached in generation %d",
+                geneticStats.Generations, geneticStats.WallTimeMs, geneticStats.GenerationsPerSecond, geneticStats.GoalReachedGeneration);
+            ImGui::Text("Genetic path cost %d, A* path cost %d found in %.3f ms",
+                geneticStats.FoundCost, geneticStats.ReferenceCost, geneticStats.ReferenceTimeMs);
+
+            /* Only generations that reached goal have scores comparable to path costs */
+            std::vector<float> convergence;
+            for (int32_t score : geneticStats.BestScores)
+            {
+                if (score < GeneticUnreachedPenalty)
+                {
+                    convergence.push_back(static_cast<float>(score));
+                }
+            }
+
+            if (!convergence.empty())
+            {
+                ImGui::PlotLines("Best path cost per generation", convergence.data(), static_cast<int>(convergence.size()));
+            }
+        }
+
         ImGui::Combo("Agents", &m_TargetPlayer, m_AgentsName, (int)m_Players.size());
 
         if (!m_Players.empty())
         {
             m_Players[m_TargetPlayer].DrawImGuiLineColorSelection();
+
+            if (const PathSearch* pathSearch = m_Players[m_TargetPlayer].GetPathSearch())
+            {
+                const PathSearchProgress& progress = pathSearch->GetProgress();
+                ImGui::ProgressBar(progress.Fraction);
+                ImGui::Text("Searching path: %zu nodes in %d frames, %.3f ms",
+                    progress.NodesExpanded, progress.NumSteps, progress.SearchTimeMs);
+            }
+            else if (m_Players[m_TargetPlayer].IsSearchingPath())
+            {
+                ImGui::Text("Searching path on background worker");
+            }
+            else if (m_Players[m_TargetPlayer].GetLastCostRatioBound() > 0.0f)
+            {
+                ImGui::Text("Path cost at most %.3fx shortest", m_Players[m_TargetPlayer].GetLastCostRatioBound());
+            }
+        }
+
+        ImGui::Combo("Memory bounded search", &m_SelectedMemoryBoundedMode, m_MemoryBoundedModes, IM_ARRAYSIZE(m_MemoryBoundedModes));
+
+        if (!m_Players.empty() && ImGui::Button("Measure memory bounded search on path of agent"))
+        {
+            EPathFindingMode mode = m_SelectedMemoryBoundedMode == 0 ? EPathFindingMode::IterativeDeepening : EPathFindingMode::SMAStar;
+            const Player& player = m_Players[m_TargetPlayer];
+            PathFindingAlgorithm::MeasureMemoryBoundedSearch(player.GetGridPosition(), player.GetGoal(), mode);
+        }
+
+        const MemoryBoundedStats& memoryBoundedStats = PathFindingAlgorithm::GetLastMemoryBoundedStats();
+        if (!memoryBoundedStats.Samples.empty())
+        {
+            ImGui::Text("A*: %zu nodes expanded, %.1f KB, path cost %d, %.3f ms",
+                memoryBoundedStats.ReferenceNodesExpanded, memoryBoundedStats.ReferenceMemoryUsage / 1024.0f,
+                memoryBoundedStats.ReferenceCost, memoryBoundedStats.ReferenceTimeMs);
+
+            /* Every node A* expands once, memory bounded search expands more often the less memory it has */
+            for (const MemoryBoundedSample& sample : memoryBoundedStats.Samples)
+            {
+                const char* status = sample.Status == EPathFindingStatus::Found ? "found" :
+                    sample.Status == EPathFindingStatus::BudgetExceeded ? "gave up" : "no path";
+
+                ImGui::Text("%6.0f KB budget: %s, %.1f KB used, %zu nodes expanded (%.1fx A*), path cost %d, %.3f ms",
+                    sample.MemoryBudget / 1024.0f, status, sample.PeakMemoryUsage / 1024.0f, sample.NodesExpanded,
+                    static_cast<double>(sample.NodesExpanded) / std::max<size_t>(memoryBoundedStats.ReferenceNodesExpanded, 1),
+                    sample.FoundCost, sample.TimeMs);
+            }
+        }
+
+        if (ImGui::Checkbox("Search paths on background workers", &m_bBackgroundPathSearch))
+        {
+            for (Player& player : m_Players)
+            {
+                player.SetBackgroundPathSearch(m_bBackgroundPathSearch);
+            }
+        }
+
+        if (!m_bBackgroundPathSearch)
+        {
+            ImGui::SliderInt("Path search budget per frame (us)", &m_SearchBudgetUs, 100, 16000);
+        }
+
+        /* Background searches run weighted A* above bound of 1, bounded suboptimal grid searches use it on main thread */
+        bool bBoundedSearch = m_bBackgroundPathSearch || IsBoundedSuboptimal(m_SearchModeValues[m_SelectedSearchMode]);
+        if (bBoundedSearch && ImGui::SliderFloat("Accepted path cost over shortest", &m_SuboptimalityBound, 1.0f, 1.5f))
+        {
+            for (Player& player : m_Players)
+            {
+                player.SetSuboptimalityBound(m_SuboptimalityBound);
+            }
+        }
+
+        const JumpPointTable& jumpPointTable = PathFindingAlgorithm::GetJumpPointTable();
+        if (jumpPointTable.IsBuilt())
+        {
+            ImGui::Text("JPS+ table: %.1f KB, last update %.3f ms (%d rows, %d columns)",
+                jumpPointTable.GetMemoryUsage() / 1024.0f, jumpPointTable.GetLastUpdateTimeMs(),
+                jumpPointTable.GetLastUpdateNumRows(), jumpPointTable.GetLastUpdateNumColumns());
+        }
+
+        const HierarchicalMap& hierarchicalMap = PathFindingAlgorithm::GetHierarchicalMap();
+        if (hierarchicalMap.IsBuilt())
+        {
+            ImGui::Text("HPA* graph: %zu nodes, %.1f KB, last update %.3f ms (%d clusters)",
+                hierarchicalMap.GetNumNodes(), hierarchicalMap.GetMemoryUsage() / 1024.0f,
+                hierarchicalMap.GetLastUpdateTimeMs(), hierarchicalMap.GetLastUpdateNumClusters());
+        }
+
+        const LandmarkTable& landmarkTable = PathFindingAlgorithm::GetLandmarkTable();
+        if (landmarkTable.IsBuilt())
+        {
+            ImGui::Text("ALT table: %zu landmarks, %.1f KB, last build %.3f ms%s",
+                landmarkTable.GetLandmarks().size(), landmarkTable.GetMemoryUsage() / 1024.0f,
+                landmarkTable.GetLastBuildTimeMs(), landmarkTable.IsRebuilding() ? ", rebuilding" : "");
         }
 
+        const ContractionHierarchy& contractionHierarchy = PathFindingAlgorithm::GetContractionHierarchy();
+        if (contractionHierarchy.IsBuilt())
+        {
+            ImGui::Text("CH: %zu shortcuts, %.1f KB, last build %.1f ms%s",
+                contractionHierarchy.GetNumShortcuts(), contractionHierarchy.GetMemoryUsage() / 1024.0f,
+                contractionHierarchy.GetLastBuildTimeMs(), contractionHierarchy.IsRebuilding() ? ", rebuilding" : "");
+        }
+
+        PathCache& pathCache = PathFindingAlgorithm::GetPathCache();
+        const PathCacheStats& cacheStats = pathCache.GetStats();
+        ImGui::Text("Path cache: %zu/%zu paths, %zu hits, %zu misses, %zu evictions, %zu invalidations",
+            pathCache.GetSize(), pathCache.GetCapacity(), cacheStats.Hits, cacheStats.Misses,
+            cacheStats.Evictions, cacheStats.Invalidations);
+
+        if (ImGui::Button("Reset path cache statistics"))
+        {
+            pathCache.ResetStats();
+        }
+
+        size_t pathBytes = 0;
+        size_t pathCells = 0;
+        for (const Player& player : m_Players)
+        {
+            pathBytes += player.GetPathMemoryUsage();
+            pathCells += player.GetPathLength();
+        }
+
+        ImGui::Text("Agent paths: %zu cells in %zu bytes, %zu bytes as point lists",
+            pathCells, pathBytes, pathCells * sizeof(PathFindingPoint) + m_Players.size() * sizeof(Path));
+
         ImGui::End();
 
         ImGui::Render();
@@ -263,6 +468,35 @@ void Application::AiUpdate()
     }
 }
 
+void Application::StepPathSearches()
+{
+    typedef std::chrono::steady_clock Clock;
+
+    if (m_Players.empty())
+    {
+        return;
+    }
+
+    Clock::time_point frameStart = Clock::now();
+    size_t numPlayers = m_Players.size();
+
+    for (size_t i = 0; i < numPlayers; ++i)
+    {
+        double remainingUs = m_SearchBudgetUs - std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count();
+        if (remainingUs <= 0.0)
+        {
+            break;
+        }
+
+        SearchBudget budget;
+        budget.MaxMicroseconds = remainingUs;
+        m_Players[(m_FirstSearchingPlayer + i) % numPlayers].StepPathSearch(budget);
+    }
+
+    /* Agent that went first leaves the whole budget to others next frame */
+    m_FirstSearchingPlayer = (m_FirstSearchingPlayer + 1) % numPlayers;
+}
+
 bool Application::IsAiUpdateFrame() const
 { 
     return SystemClock::now() - m_StartTime >= std::chrono::milliseconds{300};
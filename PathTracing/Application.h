@@ -32,26 +32,79 @@ private:
     bool m_bClickedMouseLastFrame = false;
     std::shared_ptr<Map> m_Map;
 
-    const char* m_PathFindingModes[2] = {
+    const char* m_PathFindingModes[3] = {
         "A* Path finding",
-        "Genetic path finding (Not deterministics, may be not sufficient to implement this in game)"
+        "Genetic path finding (4 neighbors only, paths usually longer than A*, may be not sufficient to implement this in game)",
+        "Any-angle path finding (Lazy Theta*, 4 neighbors setting only, agents walk straight lines between few waypoints)"
     };
 
-    const char* m_Modes[4] = {
+    /* Grid searches offered for A* path finding, most of them search 4 neighbors only and run AStar otherwise */
+    const char* m_SearchModes[10] = {
+        "A* (background or time sliced, D* Lite when blocked)",
+        "Jump point search",
+        "Jump point search with precomputed table (JPS+)",
+        "Hierarchical (HPA*, paths close to shortest)",
+        "Bidirectional A*",
+        "Bidirectional A* on two threads",
+        "A* with landmarks (ALT)",
+        "Contraction hierarchy (ignores agents)",
+        "Weighted A* (accepted path cost below)",
+        "Focal search (accepted path cost below)"
+    };
+
+    const EPathFindingMode m_SearchModeValues[10] = {
+        EPathFindingMode::AStar,
+        EPathFindingMode::JumpPointSearch,
+        EPathFindingMode::JumpPointSearchPlus,
+        EPathFindingMode::Hierarchical,
+        EPathFindingMode::Bidirectional,
+        EPathFindingMode::BidirectionalParallel,
+        EPathFindingMode::Landmarks,
+        EPathFindingMode::ContractionHierarchy,
+        EPathFindingMode::WeightedAStar,
+        EPathFindingMode::FocalSearch
+    };
+
+    const char* m_MemoryBoundedModes[2] = {
+        "IDA* with transposition table",
+        "SMA*"
+    };
+
+    const char* m_Modes[5] = {
         "Selecting target",
         "Placing obstacles",
+        "Painting terrain",
         "Remove agent",
         "Place agent"
     };
 
+    const char* m_Neighborhoods[3] = {
+        "4 neighbors",
+        "8 neighbors (no corner cutting)",
+        "Hex"
+    };
+
     std::vector<Player> m_Players;
     int m_TargetPlayer;
+    int m_SelectedNeighborhood = 0;
+    int m_SelectedPathFindingMode = 0;
+    int m_SelectedSearchMode = 0;
+    int m_SelectedMemoryBoundedMode = 0;
 
     const char* m_AgentsName[MaxAgents] = {
         "Agent 0", "Agent 1", "Agent 2", "Agent 3", "Agent 4", "Agent 5", "Agent 6", "Agent 7", "Agent 8", "Agent 9"
     };
 
-    int m_NumRightClickOptions = 4;
+    int m_NumRightClickOptions = 5;
+    int m_TerrainBrushCost = 4;
+
+    /* Time all path searches of agents may take in single frame, agents take turns in using it first */
+    int m_SearchBudgetUs = 2000;
+    size_t m_FirstSearchingPlayer = 0;
+    bool m_bBackgroundPathSearch = true;
+
+    /* Background searches accept paths this many times costlier than shortest one, 1 keeps them optimal */
+    float m_SuboptimalityBound = 1.0f;
 
     SystemClock::time_point m_StartTime;
 
@@ -60,5 +113,6 @@ private:
     bool IsAiUpdateFrame() const;
 
     void AiUpdate();
+    void StepPathSearches();
 };
 
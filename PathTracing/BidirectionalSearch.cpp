@@ -0,0 +1,377 @@
+#include "PathFinder.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+
+/* Set in published cost once cell is closed, its cost is final from then on */
+constexpr uint32_t ClosedCostFlag = 1u << 31;
+
+/* Meeting cells are packed as (cost << 32) | cell, so smaller value always means cheaper path */
+constexpr uint64_t NoMeeting = UINT64_MAX;
+
+/* Forward expansions after which caller takes back backward search no worker has picked up */
+constexpr size_t BackwardJobPickupExpansions = 1024;
+
+struct BidirectionalState
+{
+    std::atomic<uint64_t> BestMeeting{NoMeeting};
+
+    /* Smallest key in open list of each direction, may lag behind as keys only grow */
+    std::atomic<int64_t> TopKeys[2] = {std::numeric_limits<int64_t>::min() / 2, std::numeric_limits<int64_t>::min() / 2};
+    std::atomic<bool> bFinished{false};
+    std::atomic<bool> bBudgetExceeded{false};
+};
+
+/* Backward search queued on worker pool. Whoever claims it first owns it, so job that
+   lost to its caller never touches query state, which may be gone by then */
+struct BackwardJob
+{
+    std::atomic<bool> bClaimed{false};
+    std::promise<void> Done;
+};
+
+struct FrontierContext
+{
+    const IMap* Map;
+    SearchFrontier* Frontier;
+    const SearchFrontier* Opposite;
+
+    /* Cells this direction starts from and aims at */
+    PathFindingPoint Origin;
+    PathFindingPoint Target;
+    int32_t Direction;
+
+    /* Start of query, the only cell backward search may enter despite not being walkable */
+    PathFindingPoint QueryStart;
+    bool bBackward;
+    int32_t MapWidth;
+};
+
+static SearchRecord& GetFrontierRecord(SearchFrontier& frontier, int32_t cellIndex)
+{
+    SearchRecord& record = frontier.Records[cellIndex];
+
+    if (record.Generation != frontier.Generation)
+    {
+        record = SearchRecord{};
+        record.Generation = frontier.Generation;
+    }
+
+    return record;
+}
+
+static void PublishCost(SearchFrontier& frontier, int32_t cellIndex, uint32_t cost)
+{
+    frontier.PublishedCosts[cellIndex].store((static_cast<uint64_t>(frontier.Generation) << 32) | cost);
+}
+
+static bool TryGetPublishedCost(const SearchFrontier& frontier, int32_t cellIndex, uint32_t& outCost, bool& bOutClosed)
+{
+    uint64_t value = frontier.PublishedCosts[cellIndex].load();
+
+    if ((value >> 32) != frontier.Generation)
+    {
+        return false;
+    }
+
+    outCost = static_cast<uint32_t>(value) & ~ClosedCostFlag;
+    bOutClosed = (static_cast<uint32_t>(value) & ClosedCostFlag) != 0;
+    return true;
+}
+
+static void OfferMeeting(BidirectionalState& state, uint32_t cost, int32_t cellIndex)
+{
+    uint64_t meeting = (static_cast<uint64_t>(cost) << 32) | static_cast<uint32_t>(cellIndex);
+    uint64_t best = state.BestMeeting.load();
+
+    while (meeting < best && !state.BestMeeting.compare_exchange_weak(best, meeting))
+    {
+    }
+}
+
+static bool OpenFrontierCell(const FrontierContext& context, BidirectionalState& state, PathFindingPoint point,
+    int32_t parentIndex, PathCost costFunc)
+{
+    SearchFrontier& frontier = *context.Frontier;
+    int32_t cellIndex = point.x + point.y * context.MapWidth;
+    SearchRecord& record = GetFrontierRecord(frontier, cellIndex);
+
+    /* Cell that cannot improve best meeting is not worth opening at all */
+    uint64_t best = state.BestMeeting.load();
+    if (best != NoMeeting && static_cast<int64_t>(costFunc) + ManhattanHeuristic::Evaluate(point, context.Target) >= static_cast<int64_t>(best >> 32))
+    {
+        return true;
+    }
+
+    /* Both directions order cells by the same balanced potential with opposite
+       sign, so their frontiers advance evenly and meet near the middle. Potential
+       is half of heuristics difference, keys are doubled to keep them integer */
+    PathCost potential = ManhattanHeuristic::Evaluate(point, context.Target) - ManhattanHeuristic::Evaluate(point, context.Origin);
+
+    if (record.State == ENodeState::Unvisited)
+    {
+        Node* node = frontier.NodeArena.Allocate(point);
+        if (!node)
+        {
+            state.bBudgetExceeded = true;
+            return false;
+        }
+
+        node->Heuristics = potential;
+        node->EvaluationFunc = 2 * costFunc + node->Heuristics;
+
+        record.State = ENodeState::Open;
+        record.OpenNode = node;
+        frontier.OpenList.Push(node);
+    }
+    else if (record.State == ENodeState::Open && costFunc < record.CostFunc)
+    {
+        Node* node = record.OpenNode;
+        frontier.OpenList.DecreaseKey(node, 2 * costFunc + node->Heuristics);
+    }
+    else
+    {
+        return true;
+    }
+
+    record.Parent = parentIndex;
+    record.CostFunc = costFunc;
+
+    /* Cost must be published before reading opposite one, then at least
+       one of two directions reaching cell at once notices the meeting */
+    uint32_t cost = static_cast<uint32_t>(costFunc);
+    uint32_t oppositeCost;
+    bool bOppositeClosed;
+    PublishCost(frontier, cellIndex, cost);
+
+    if (TryGetPublishedCost(*context.Opposite, cellIndex, oppositeCost, bOppositeClosed))
+    {
+        OfferMeeting(state, cost + oppositeCost, cellIndex);
+    }
+
+    return true;
+}
+
+/* Expands single node, returns false when this direction has nothing more to do */
+static bool ExpandFrontierNode(const FrontierContext& context, BidirectionalState& state)
+{
+    SearchFrontier& frontier = *context.Frontier;
+
+    if (frontier.OpenList.IsEmpty())
+    {
+        return false;
+    }
+
+    int64_t topKey = frontier.OpenList.Top()->EvaluationFunc;
+    state.TopKeys[context.Direction] = topKey;
+
+    /* Potentials cancel out, so sum of both smallest keys bounds every path not found yet */
+    uint64_t best = state.BestMeeting.load();
+    if (best != NoMeeting && topKey + state.TopKeys[1 - context.Direction].load() >= 2 * static_cast<int64_t>(best >> 32))
+    {
+        return false;
+    }
+
+    PathFindingPoint current = frontier.OpenList.Pop()->Point;
+    int32_t currentIndex = current.x + current.y * context.MapWidth;
+    ++frontier.NodesExpanded;
+
+    SearchRecord& currentRecord = GetFrontierRecord(frontier, currentIndex);
+    currentRecord.State = ENodeState::Closed;
+    currentRecord.OpenNode = nullptr;
+    PublishCost(frontier, currentIndex, static_cast<uint32_t>(currentRecord.CostFunc) | ClosedCostFlag);
+
+    /* Backward search follows edges in reverse, so cells entered by them must be walkable */
+    if (context.bBackward && !IsWalkable(current, context.Map))
+    {
+        return true;
+    }
+
+    /* Cell closed by opposite direction already has its best path through it
+       offered as meeting, so its successors cannot lead anywhere cheaper */
+    uint32_t oppositeCost;
+    bool bOppositeClosed;
+    if (TryGetPublishedCost(*context.Opposite, currentIndex, oppositeCost, bOppositeClosed) && bOppositeClosed)
+    {
+        return true;
+    }
+
+    /* Backward search walks edge from neighbor into current cell, so it pays for current cell */
+    PathCost currentStepCost = context.bBackward ? context.Map->GetTerrainCost(current) : 0;
+
+    PathFindingPoint neighbors[4] = {
+        {current.x - 1, current.y},
+        {current.x + 1, current.y},
+        {current.x, current.y - 1},
+        {current.x, current.y + 1}
+    };
+
+    for (PathFindingPoint neighbor : neighbors)
+    {
+        if (!IsWalkable(neighbor, context.Map) && !(context.bBackward && neighbor == context.QueryStart))
+        {
+            continue;
+        }
+
+        PathCost stepCost = context.bBackward ? currentStepCost : context.Map->GetTerrainCost(neighbor);
+        if (!OpenFrontierCell(context, state, neighbor, currentIndex, currentRecord.CostFunc + stepCost))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Either direction finishing proves the result, so first one to stop stops the other too */
+static void RunFrontier(const FrontierContext& context, BidirectionalState& state)
+{
+    while (!state.bFinished.load(std::memory_order_relaxed) && ExpandFrontierNode(context, state))
+    {
+    }
+
+    state.bFinished = true;
+}
+
+PathFindingResult PathFinder::FindPathBidirectional(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    bool bParallel)
+{
+    StartBidirectionalSession(map);
+
+    if (start == goal)
+    {
+        return {EPathFindingStatus::Found, {start}, 0};
+    }
+
+    if (!IsWalkable(goal, &map))
+    {
+        return {EPathFindingStatus::NoPath};
+    }
+
+    SearchFrontier& forward = m_Frontiers[0];
+    SearchFrontier& backward = m_Frontiers[1];
+
+    BidirectionalState state;
+    FrontierContext forwardContext{&map, &forward, &backward, start, goal, 0, start, false, m_MapWidth};
+    FrontierContext backwardContext{&map, &backward, &forward, goal, start, 1, start, true, m_MapWidth};
+
+    OpenFrontierCell(forwardContext, state, start, InvalidCellIndex, 0);
+    OpenFrontierCell(backwardContext, state, goal, InvalidCellIndex, 0);
+
+    bool bBackwardOnWorker = false;
+
+    if (bParallel && m_WorkerPool)
+    {
+        auto job = std::make_shared<BackwardJob>();
+        std::future<void> backwardDone = job->Done.get_future();
+
+        m_WorkerPool->Submit([job, &backwardContext, &state](uint32_t)
+        {
+            if (!job->bClaimed.exchange(true))
+            {
+                RunFrontier(backwardContext, state);
+                job->Done.set_value();
+            }
+        });
+
+        /* Pool may be busy, even with this very query when it runs on worker, so backward
+           search still waiting after a while is taken back and run on this thread */
+        bBackwardOnWorker = true;
+        size_t numExpanded = 0;
+
+        while (!state.bFinished.load(std::memory_order_relaxed) && ExpandFrontierNode(forwardContext, state))
+        {
+            if (++numExpanded == BackwardJobPickupExpansions && !job->bClaimed.exchange(true))
+            {
+                bBackwardOnWorker = false;
+                break;
+            }
+        }
+
+        if (bBackwardOnWorker)
+        {
+            state.bFinished = true;
+
+            /* Forward search alone finishes the query when backward one never started */
+            if (job->bClaimed.exchange(true))
+            {
+                backwardDone.wait();
+            }
+        }
+    }
+
+    if (!bBackwardOnWorker)
+    {
+        while (ExpandFrontierNode(forwardContext, state) && ExpandFrontierNode(backwardContext, state))
+        {
+        }
+    }
+
+    size_t nodesExpanded = forward.NodesExpanded + backward.NodesExpanded;
+    uint64_t best = state.BestMeeting;
+
+    if (state.bBudgetExceeded)
+    {
+        return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+    }
+
+    if (best == NoMeeting)
+    {
+        return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+    }
+
+    /* Join forward parents from meeting cell to start with backward parents from meeting cell to goal */
+    int32_t meetingIndex = static_cast<int32_t>(static_cast<uint32_t>(best));
+    Path path;
+
+    for (int32_t index = meetingIndex; index != InvalidCellIndex; index = forward.Records[index].Parent)
+    {
+        path.emplace_back(index % m_MapWidth, index / m_MapWidth);
+    }
+
+    std::reverse(path.begin(), path.end());
+
+    for (int32_t index = backward.Records[meetingIndex].Parent; index != InvalidCellIndex; index = backward.Records[index].Parent)
+    {
+        path.emplace_back(index % m_MapWidth, index / m_MapWidth);
+    }
+
+    return {EPathFindingStatus::Found, std::move(path), nodesExpanded};
+}
+
+void PathFinder::StartBidirectionalSession(const IMap& map)
+{
+    StartNewPathFindingSession(map);
+
+    size_t numCells = static_cast<size_t>(m_MapWidth) * m_MapHeight;
+
+    for (SearchFrontier& frontier : m_Frontiers)
+    {
+        /* Both directions together keep to budget of single search */
+        frontier.NodeArena.Reset();
+        frontier.NodeArena.SetBudget(m_NodeArena.GetBudget() / 2);
+        frontier.OpenList.Clear();
+        frontier.NodesExpanded = 0;
+
+        if (frontier.Records.size() != numCells)
+        {
+            frontier.Records.assign(numCells, SearchRecord{});
+            frontier.PublishedCosts = std::make_unique<std::atomic<uint64_t>[]>(numCells);
+            frontier.Generation = 0;
+        }
+
+        if (++frontier.Generation == 0)
+        {
+            std::fill(frontier.Records.begin(), frontier.Records.end(), SearchRecord{});
+
+            for (size_t i = 0; i < numCells; ++i)
+            {
+                frontier.PublishedCosts[i] = 0;
+            }
+
+            frontier.Generation = 1;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#include "PathFinder.h"
+
+#include <algorithm>
+
+/*
+ * Bounded suboptimal searches. Both reopen closed cells reached at lower cost, so as
+ * in A* some open cell on shortest path always has its shortest cost, and lowest
+ * unweighted evaluation in open list never exceeds cost of shortest path. Cost of
+ * found path divided by that lower bound is ratio query reports.
+ */
+
+/* Focal list puts node closest to goal first, and of those the one with lower evaluation */
+static bool IsFocalEntryAfter(const FocalEntry& a, const FocalEntry& b)
+{
+    if (a.Heuristics != b.Heuristics)
+    {
+        return a.Heuristics > b.Heuristics;
+    }
+
+    return a.EvaluationFunc > b.EvaluationFunc;
+}
+
+static float GetCostRatio(PathCost cost, PathCost lowerBound)
+{
+    return lowerBound > 0 ? static_cast<float>(cost) / static_cast<float>(lowerBound) : 1.0f;
+}
+
+PathFindingResult PathFinder::FindPathBoundedSuboptimal(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    EPathFindingMode mode, ENeighborhood neighborhood, float suboptimalityBound)
+{
+    suboptimalityBound = std::max(suboptimalityBound, 1.0f);
+    bool bFocal = mode == EPathFindingMode::FocalSearch;
+
+    switch (neighborhood)
+    {
+    case ENeighborhood::Eight:
+        return bFocal ? FindPathFocal<EightConnected>(map, start, goal, suboptimalityBound) :
+            FindPathWeightedAStar<EightConnected>(map, start, goal, suboptimalityBound);
+    case ENeighborhood::Hex:
+        return bFocal ? FindPathFocal<HexConnected>(map, start, goal, suboptimalityBound) :
+            FindPathWeightedAStar<HexConnected>(map, start, goal, suboptimalityBound);
+    case ENeighborhood::Four:
+    default:
+        return bFocal ? FindPathFocal<FourConnected>(map, start, goal, suboptimalityBound) :
+            FindPathWeightedAStar<FourConnected>(map, start, goal, suboptimalityBound);
+    }
+}
+
+template<typename TNeighborhood>
+PathFindingResult PathFinder::FindPathWeightedAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal, float weight)
+{
+    typedef typename TNeighborhood::DefaultHeuristic THeuristic;
+
+    /* Rounded down, so evaluation never exceeds cost plus weight times heuristic */
+    auto getWeightedHeuristic = [&](PathFindingPoint point)
+    {
+        return static_cast<PathCost>(THeuristic::Evaluate(point, goal) * weight);
+    };
+
+    StartNewPathFindingSession(map);
+
+    Node* openedNode = nullptr;
+    if (!OpenOrReopen(m_OpenList, start, InvalidCellIndex, 0, getWeightedHeuristic(start), openedNode))
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    size_t nodesExpanded = 0;
+
+    while (!m_OpenList.IsEmpty())
+    {
+        Node* currentNode = m_OpenList.Pop();
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        PathCost currentCost = currentRecord.CostFunc;
+
+        if (current == goal)
+        {
+            /* Open list is ordered by weighted evaluation, so lower bound needs a pass over it */
+            PathCost lowerBound = currentCost;
+            m_OpenList.ForEach([&](const Node* node)
+            {
+                lowerBound = std::min(lowerBound, m_Records[GetCellIndex(node->Point)].CostFunc + THeuristic::Evaluate(node->Point, goal));
+            });
+
+            lowerBound = std::max(lowerBound, THeuristic::Evaluate(start, goal));
+
+            PathFindingResult result{EPathFindingStatus::Found, m_bDeferPathReconstruction ? Path{} : ReconstructPath(goal), nodesExpanded};
+            result.CostRatioBound = GetCostRatio(currentCost, lowerBound);
+            return result;
+        }
+
+        int32_t currentIndex = GetCellIndex(current);
+
+        bool bWithinBudget = ForEachNeighbor<TNeighborhood>(map, current, [&](PathFindingPoint neighbor, PathCost stepCost)
+        {
+            return OpenOrReopen(m_OpenList, neighbor, currentIndex, currentCost + stepCost, getWeightedHeuristic(neighbor), openedNode);
+        });
+
+        if (!bWithinBudget)
+        {
+            return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
+
+/*
+ * Open list is bucket queue ordered by evaluation, focal list holds open nodes whose
+ * evaluation is within bound of lowest one. Lowest evaluation never decreases, so
+ * whenever it rises, buckets newly within bound are moved into focal list whole.
+ */
+template<typename TNeighborhood>
+PathFindingResult PathFinder::FindPathFocal(const IMap& map, PathFindingPoint start, PathFindingPoint goal, float suboptimalityBound)
+{
+    typedef typename TNeighborhood::DefaultHeuristic THeuristic;
+
+    StartNewPathFindingSession(map);
+    m_FocalList.clear();
+
+    /* Highest evaluation whose nodes were put into focal list */
+    PathCost focalBound = -1;
+
+    auto pushFocal = [&](Node* node)
+    {
+        m_FocalList.push_back({node->Heuristics, node->EvaluationFunc, node});
+        std::push_heap(m_FocalList.begin(), m_FocalList.end(), IsFocalEntryAfter);
+    };
+
+    Node* openedNode = nullptr;
+    if (!OpenOrReopen(m_BucketOpenList, start, InvalidCellIndex, 0, THeuristic::Evaluate(start, goal), openedNode))
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    size_t nodesExpanded = 0;
+
+    while (!m_BucketOpenList.IsEmpty())
+    {
+        PathCost lowestEvaluation = m_BucketOpenList.Top()->EvaluationFunc;
+        PathCost bound = static_cast<PathCost>(lowestEvaluation * suboptimalityBound);
+
+        for (PathCost key = std::max(focalBound + 1, lowestEvaluation); key <= bound; ++key)
+        {
+            m_BucketOpenList.ForEachWithKey(key, pushFocal);
+        }
+
+        focalBound = std::max(focalBound, bound);
+
+        /* Node with lowest evaluation is always in focal list, so valid entry is found */
+        Node* currentNode = nullptr;
+        while (!currentNode)
+        {
+            assert(!m_FocalList.empty());
+
+            std::pop_heap(m_FocalList.begin(), m_FocalList.end(), IsFocalEntryAfter);
+            FocalEntry entry = m_FocalList.back();
+            m_FocalList.pop_back();
+
+            if (m_BucketOpenList.Contains(entry.FocalNode) && entry.FocalNode->EvaluationFunc == entry.EvaluationFunc)
+            {
+                currentNode = entry.FocalNode;
+            }
+        }
+
+        m_BucketOpenList.Remove(currentNode);
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        PathCost currentCost = currentRecord.CostFunc;
+
+        if (current == goal)
+        {
+            PathFindingResult result{EPathFindingStatus::Found, m_bDeferPathReconstruction ? Path{} : ReconstructPath(goal), nodesExpanded};
+            result.CostRatioBound = GetCostRatio(currentCost, lowestEvaluation);
+            return result;
+        }
+
+        int32_t currentIndex = GetCellIndex(current);
+
+        bool bWithinBudget = ForEachNeighbor<TNeighborhood>(map, current, [&](PathFindingPoint neighbor, PathCost stepCost)
+        {
+            if (!OpenOrReopen(m_BucketOpenList, neighbor, currentIndex, currentCost + stepCost, THeuristic::Evaluate(neighbor, goal), openedNode))
+            {
+                return false;
+            }
+
+            /* Nodes above bound join focal list once their bucket gets within it */
+            if (openedNode && openedNode->EvaluationFunc <= focalBound)
+            {
+                pushFocal(openedNode);
+            }
+
+            return true;
+        });
+
+        if (!bWithinBudget)
+        {
+            return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
+
+template<typename TOpenList>
+bool PathFinder::OpenOrReopen(TOpenList& openList, PathFindingPoint point, int32_t parentIndex, PathCost costFunc,
+    PathCost heuristics, Node*& outNode)
+{
+    SearchRecord& record = GetRecord(point);
+    outNode = nullptr;
+
+    if (record.State == ENodeState::Closed)
+    {
+        if (costFunc >= record.CostFunc)
+        {
+            return true;
+        }
+
+        record.State = ENodeState::Unvisited;
+    }
+
+    if (record.State == ENodeState::Unvisited)
+    {
+        Node* node = m_NodeArena.Allocate(point);
+        if (!node)
+        {
+            return false;
+        }
+
+        node->Heuristics = heuristics;
+        node->EvaluationFunc = costFunc + heuristics;
+
+        record.State = ENodeState::Open;
+        record.Parent = parentIndex;
+        record.CostFunc = costFunc;
+        record.OpenNode = node;
+        openList.Push(node);
+        outNode = node;
+    }
+    else if (costFunc < record.CostFunc)
+    {
+        Node* node = record.OpenNode;
+
+        record.Parent = parentIndex;
+        record.CostFunc = costFunc;
+        openList.DecreaseKey(node, costFunc + node->Heuristics);
+        outNode = node;
+    }
+
+    return true;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "AStarPriorityQueue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+/* Open list for integer keys (Dial's algorithm). Nodes are kept in buckets
+   indexed by evaluation, window of buckets is circular and grows only when
+   keys stored at once span more buckets than it has. With consistent
+   heuristics keys popped never decrease, so Pop just walks window forward.
+   Equal keys are popped newest first, which prefers nodes deeper in search.
+   HeapIndex of node holds its slot inside bucket */
+class BucketPriorityQueue
+{
+public:
+    void Push(Node* node)
+    {
+        assert(node->HeapIndex == InvalidHeapIndex);
+        PathCost key = node->EvaluationFunc;
+
+        if (m_Size == 0)
+        {
+            m_MinKey = key;
+            m_MaxKey = key;
+        }
+
+        Reserve(std::min(key, m_MinKey), std::max(key, m_MaxKey));
+        Place(node);
+        ++m_Size;
+    }
+
+    Node* Pop()
+    {
+        Node* top = Top();
+        RemoveFromBucket(top);
+        --m_Size;
+
+        return top;
+    }
+
+    Node* Top()
+    {
+        assert(m_Size > 0);
+
+        while (m_Buckets[m_MinKey & m_Mask].empty())
+        {
+            ++m_MinKey;
+        }
+
+        return m_Buckets[m_MinKey & m_Mask].back();
+    }
+
+    /* Lowers evaluation of node already in open list */
+    void DecreaseKey(Node* node, PathCost evaluationFunc)
+    {
+        assert(Contains(node) && evaluationFunc <= node->EvaluationFunc);
+
+        /* Node has to be taken out of bucket of its old evaluation first */
+        RemoveFromBucket(node);
+        node->EvaluationFunc = evaluationFunc;
+
+        Reserve(std::min(evaluationFunc, m_MinKey), m_MaxKey);
+        Place(node);
+    }
+
+    bool Contains(const Node* node) const
+    {
+        return node->HeapIndex != InvalidHeapIndex;
+    }
+
+    /* Takes node out of open list, wherever in it it is */
+    void Remove(Node* node)
+    {
+        assert(Contains(node));
+        RemoveFromBucket(node);
+        --m_Size;
+    }
+
+    /* Visits nodes whose evaluation equals key. Keys inside window have buckets of their own */
+    template<typename Func>
+    void ForEachWithKey(PathCost key, Func&& func) const
+    {
+        if (m_Size == 0 || key < m_MinKey || key > m_MaxKey)
+        {
+            return;
+        }
+
+        for (Node* node : m_Buckets[key & m_Mask])
+        {
+            func(node);
+        }
+    }
+
+    bool IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+
+    void Clear()
+    {
+        for (std::vector<Node*>& bucket : m_Buckets)
+        {
+            bucket.clear();
+        }
+
+        m_Size = 0;
+    }
+
+private:
+    std::vector<std::vector<Node*>> m_Buckets;
+    PathCost m_Mask = -1;
+    PathCost m_MinKey = 0;
+    PathCost m_MaxKey = 0;
+    size_t m_Size = 0;
+
+private:
+    void Place(Node* node)
+    {
+        std::vector<Node*>& bucket = m_Buckets[node->EvaluationFunc & m_Mask];
+        node->HeapIndex = static_cast<int32_t>(bucket.size());
+        bucket.push_back(node);
+    }
+
+    void RemoveFromBucket(Node* node)
+    {
+        std::vector<Node*>& bucket = m_Buckets[node->EvaluationFunc & m_Mask];
+
+        /* Swap with last node of bucket, order inside bucket is not kept anyway */
+        Node* last = bucket.back();
+        last->HeapIndex = node->HeapIndex;
+        bucket[node->HeapIndex] = last;
+        bucket.pop_back();
+
+        node->HeapIndex = InvalidHeapIndex;
+    }
+
+    /* Makes window cover keys from minKey to maxKey */
+    void Reserve(PathCost minKey, PathCost maxKey)
+    {
+        size_t span = static_cast<size_t>(maxKey - minKey) + 1;
+
+        if (span > m_Buckets.size())
+        {
+            size_t numBuckets = m_Buckets.empty() ? 256 : m_Buckets.size();
+            while (numBuckets < span)
+            {
+                numBuckets *= 2;
+            }
+
+            /* Bucket of key depends on window size, so nodes are placed again */
+            std::vector<std::vector<Node*>> oldBuckets(numBuckets);
+            oldBuckets.swap(m_Buckets);
+            m_Mask = static_cast<PathCost>(numBuckets - 1);
+
+            for (std::vector<Node*>& bucket : oldBuckets)
+            {
+                for (Node* node : bucket)
+                {
+                    Place(node);
+                }
+            }
+        }
+
+        m_MinKey = minKey;
+        m_MaxKey = maxKey;
+    }
+};
@@ -0,0 +1,217 @@
+#include "CompactPath.h"
+
+#include <cstdlib>
+
+/* Offsets of directions, direction of offset is found at (dy + 1) * 3 + (dx + 1) of DirectionsByOffset */
+static constexpr PathFindingPoint DirectionOffsets[8] = {
+    {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}
+};
+
+static constexpr uint8_t InvalidDirection = 0xff;
+static constexpr uint8_t DirectionsByOffset[9] = {0, 1, 2, 3, InvalidDirection, 4, 5, 6, 7};
+
+CompactPath::CompactPath(const Path& path)
+{
+    for (PathFindingPoint point : path)
+    {
+        push_back(point);
+    }
+
+    shrink_to_fit();
+}
+
+void CompactPath::push_back(PathFindingPoint point)
+{
+    if (m_Size == 0)
+    {
+        m_Start = point;
+        m_Back = point;
+        m_Size = 1;
+        return;
+    }
+
+    if (point == m_Back)
+    {
+        return;
+    }
+
+    if (AppendStep(GetDirection(point - m_Back)) && (m_Runs.size() - 1) % CompactPathCheckpointInterval == 0)
+    {
+        m_Checkpoints.push_back({static_cast<uint32_t>(m_Size - 1), m_Back});
+    }
+
+    m_Back = point;
+    ++m_Size;
+}
+
+void CompactPath::clear()
+{
+    m_Size = 0;
+    m_Runs.clear();
+    m_Checkpoints.clear();
+}
+
+void CompactPath::shrink_to_fit()
+{
+    m_Runs.shrink_to_fit();
+    m_Checkpoints.shrink_to_fit();
+}
+
+PathFindingPoint CompactPath::operator[](size_t index) const
+{
+    assert(index < m_Size);
+
+    if (index == 0)
+    {
+        return m_Start;
+    }
+
+    /* Last checkpoint at or before index, first one always starts at index 0 */
+    auto checkpoint = std::upper_bound(m_Checkpoints.begin(), m_Checkpoints.end(), index,
+        [](size_t value, const Checkpoint& other)
+    {
+        return value < other.Index;
+    }) - 1;
+
+    size_t pointIndex = checkpoint->Index;
+    PathFindingPoint point = checkpoint->Point;
+
+    for (size_t run = (checkpoint - m_Checkpoints.begin()) * CompactPathCheckpointInterval;; ++run)
+    {
+        uint32_t length = GetRunLength(m_Runs[run]);
+
+        if (index - pointIndex <= length)
+        {
+            return point + GetRunOffset(m_Runs[run]) * static_cast<int32_t>(index - pointIndex);
+        }
+
+        point += GetRunOffset(m_Runs[run]) * static_cast<int32_t>(length);
+        pointIndex += length;
+    }
+}
+
+CompactPath::Iterator CompactPath::begin() const
+{
+    Iterator iterator;
+    iterator.m_Path = this;
+    iterator.m_Point = m_Start;
+
+    return iterator;
+}
+
+CompactPath::Iterator CompactPath::end() const
+{
+    Iterator iterator;
+    iterator.m_Path = this;
+    iterator.m_Index = m_Size;
+    iterator.m_Point = m_Back;
+
+    return iterator;
+}
+
+CompactPath::Iterator CompactPath::GetIteratorAt(size_t index) const
+{
+    if (index >= m_Size)
+    {
+        return end();
+    }
+
+    Iterator iterator = begin();
+
+    if (index == 0)
+    {
+        return iterator;
+    }
+
+    size_t checkpoint = std::upper_bound(m_Checkpoints.begin(), m_Checkpoints.end(), index,
+        [](size_t value, const Checkpoint& other)
+    {
+        return value < other.Index;
+    }) - m_Checkpoints.begin() - 1;
+
+    iterator.m_Run = checkpoint * CompactPathCheckpointInterval;
+    iterator.m_Index = m_Checkpoints[checkpoint].Index;
+    iterator.m_Point = m_Checkpoints[checkpoint].Point;
+
+    /* Skip whole runs, then step into the one holding index */
+    while (iterator.m_Run < m_Runs.size() && index - iterator.m_Index >= GetRunLength(m_Runs[iterator.m_Run]))
+    {
+        uint32_t length = GetRunLength(m_Runs[iterator.m_Run]);
+        iterator.m_Point += GetRunOffset(m_Runs[iterator.m_Run]) * static_cast<int32_t>(length);
+        iterator.m_Index += length;
+        ++iterator.m_Run;
+    }
+
+    iterator.m_StepsTaken = static_cast<uint32_t>(index - iterator.m_Index);
+    iterator.m_Index = index;
+
+    if (iterator.m_StepsTaken > 0)
+    {
+        iterator.m_Point += GetRunOffset(m_Runs[iterator.m_Run]) * static_cast<int32_t>(iterator.m_StepsTaken);
+    }
+
+    return iterator;
+}
+
+size_t CompactPath::Find(PathFindingPoint point) const
+{
+    return std::find(begin(), end(), point).GetIndex();
+}
+
+Path CompactPath::Expand() const
+{
+    Path path;
+    path.reserve(m_Size);
+    path.assign(begin(), end());
+
+    return path;
+}
+
+size_t CompactPath::GetMemoryUsage() const
+{
+    return sizeof(CompactPath) + m_Runs.capacity() * sizeof(uint8_t) + m_Checkpoints.capacity() * sizeof(Checkpoint);
+}
+
+bool CompactPath::AppendStep(uint8_t direction)
+{
+    if (!m_Runs.empty() && (m_Runs.back() & 7) == direction && GetRunLength(m_Runs.back()) < CompactPathMaxRunLength)
+    {
+        m_Runs.back() += 1 << 3;
+        return false;
+    }
+
+    m_Runs.push_back(direction);
+    return true;
+}
+
+void CompactPath::RebuildCheckpoints()
+{
+    m_Checkpoints.clear();
+    m_Checkpoints.reserve(m_Runs.size() / CompactPathCheckpointInterval + 1);
+
+    uint32_t index = 0;
+    PathFindingPoint point = m_Start;
+
+    for (size_t run = 0; run < m_Runs.size(); ++run)
+    {
+        if (run % CompactPathCheckpointInterval == 0)
+        {
+            m_Checkpoints.push_back({index, point});
+        }
+
+        uint32_t length = GetRunLength(m_Runs[run]);
+        point += GetRunOffset(m_Runs[run]) * static_cast<int32_t>(length);
+        index += length;
+    }
+}
+
+uint8_t CompactPath::GetDirection(PathFindingPoint offset)
+{
+    assert(std::abs(offset.x) <= 1 && std::abs(offset.y) <= 1 && offset != PathFindingPoint(0, 0));
+    return DirectionsByOffset[(offset.y + 1) * 3 + offset.x + 1];
+}
+
+PathFindingPoint CompactPath::GetRunOffset(uint8_t run)
+{
+    return DirectionOffsets[run & 7];
+}
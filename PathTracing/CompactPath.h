@@ -0,0 +1,199 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/* Steps of single run, longer straight stretches are split into more runs */
+constexpr uint32_t CompactPathMaxRunLength = 32;
+
+/* Runs between two points remembered for random access */
+constexpr size_t CompactPathCheckpointInterval = 32;
+
+/* Path stored as start point and runs of steps in the same direction. Every
+   run is one byte, 3 bits of direction (8-connected and hex moves include
+   diagonal ones) and 5 bits of run length, so straight 4-connected path takes
+   one byte per 32 cells instead of 8 bytes per cell. Every consecutive two
+   points must be neighbors on 8-connected grid, which holds for paths found
+   by every mode. Point of every CompactPathCheckpointInterval-th run is kept
+   aside, so indexing walks at most that many runs */
+class CompactPath
+{
+public:
+    class Iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef PathFindingPoint value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PathFindingPoint* pointer;
+        typedef PathFindingPoint reference;
+
+        Iterator() = default;
+
+        PathFindingPoint operator*() const
+        {
+            return m_Point;
+        }
+
+        Iterator& operator++()
+        {
+            /* Last point has no step left to take, iterator just moves to end */
+            if (++m_Index == m_Path->m_Size)
+            {
+                return *this;
+            }
+
+            m_Point += GetRunOffset(m_Path->m_Runs[m_Run]);
+
+            if (++m_StepsTaken == GetRunLength(m_Path->m_Runs[m_Run]))
+            {
+                ++m_Run;
+                m_StepsTaken = 0;
+            }
+
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return m_Index == other.m_Index;
+        }
+
+        /* Index of point iterator stands at */
+        size_t GetIndex() const
+        {
+            return m_Index;
+        }
+
+    private:
+        friend class CompactPath;
+
+        const CompactPath* m_Path = nullptr;
+
+        /* Run next step is taken from, and steps of it already taken */
+        size_t m_Run = 0;
+        uint32_t m_StepsTaken = 0;
+
+        size_t m_Index = 0;
+        PathFindingPoint m_Point{0, 0};
+    };
+
+public:
+    CompactPath() = default;
+    explicit CompactPath(const Path& path);
+
+    /* Builds path by following parents from goal back to start. getParent(point, outParent)
+       returns false once point is start, so no expanded path is ever built */
+    template<typename TGetParent>
+    static CompactPath FromParentChain(PathFindingPoint goal, TGetParent getParent)
+    {
+        CompactPath path;
+        path.m_Back = goal;
+        path.m_Size = 1;
+
+        PathFindingPoint point = goal;
+        PathFindingPoint parent;
+
+        /* Reversed path has the same runs, just in opposite order */
+        while (getParent(point, parent))
+        {
+            path.AppendStep(GetDirection(point - parent));
+            ++path.m_Size;
+            point = parent;
+        }
+
+        path.m_Start = point;
+        std::reverse(path.m_Runs.begin(), path.m_Runs.end());
+        path.RebuildCheckpoints();
+        path.shrink_to_fit();
+
+        return path;
+    }
+
+    /* Point must be neighbor of last point on 8-connected grid. Point equal to last one
+       is skipped, as run can not step in place, so path never holds repeated points */
+    void push_back(PathFindingPoint point);
+    void clear();
+
+    /* Paths built step by step keep spare capacity until this is called */
+    void shrink_to_fit();
+
+    size_t size() const
+    {
+        return m_Size;
+    }
+
+    bool empty() const
+    {
+        return m_Size == 0;
+    }
+
+    PathFindingPoint front() const
+    {
+        return m_Start;
+    }
+
+    PathFindingPoint back() const
+    {
+        return m_Back;
+    }
+
+    PathFindingPoint operator[](size_t index) const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    /* Iterator standing at point with given index, end when index is past last point */
+    Iterator GetIteratorAt(size_t index) const;
+
+    /* Index of first occurrence of point, size() when path does not pass it */
+    size_t Find(PathFindingPoint point) const;
+
+    Path Expand() const;
+
+    /* Bytes held by path, including its own size */
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Checkpoint
+    {
+        /* Index of point first step of run starts from */
+        uint32_t Index;
+        PathFindingPoint Point;
+    };
+
+    PathFindingPoint m_Start{0, 0};
+    PathFindingPoint m_Back{0, 0};
+    size_t m_Size = 0;
+
+    /* Direction in low 3 bits, run length minus one in high 5 bits */
+    std::vector<uint8_t> m_Runs;
+
+    /* Checkpoint k describes run k * CompactPathCheckpointInterval */
+    std::vector<Checkpoint> m_Checkpoints;
+
+private:
+    /* Returns true when step started new run */
+    bool AppendStep(uint8_t direction);
+    void RebuildCheckpoints();
+
+    static uint8_t GetDirection(PathFindingPoint offset);
+    static PathFindingPoint GetRunOffset(uint8_t run);
+
+    static uint32_t GetRunLength(uint8_t run)
+    {
+        return (run >> 3) + 1;
+    }
+};
@@ -0,0 +1,374 @@
+#include "ComponentLabels.h"
+
+#include <algorithm>
+#include <cassert>
+
+/* 4-connected moves, followed by ring of 8 cells around center in walking order */
+static const glm::ivec2 NeighborOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+static const glm::ivec2 RingOffsets[8] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+
+void ComponentLabels::Reset(int32_t width, int32_t height)
+{
+    m_Width = width;
+    m_Height = height;
+
+    size_t numCells = static_cast<size_t>(width) * height;
+    m_Passable.assign(numCells, 1);
+    m_VisitStamps.assign(numCells, 0);
+    m_VisitOwners.assign(numCells, 0);
+    m_VisitStamp = 0;
+
+    Relabel();
+}
+
+void ComponentLabels::SetPassable(glm::ivec2 point, bool bPassable)
+{
+    int32_t index = GetCellIndex(point);
+
+    if (static_cast<bool>(m_Passable[index]) == bPassable)
+    {
+        return;
+    }
+
+    m_Passable[index] = bPassable;
+
+    if (bPassable)
+    {
+        OnCellOpened(point);
+    }
+    else
+    {
+        m_Labels[index] = InvalidComponent;
+        OnCellClosed(point);
+    }
+
+    /* Every split leaves old labels behind in forest, so it is rebuilt once they outnumber cells */
+    if (m_Parents.size() > 2 * m_Passable.size())
+    {
+        Relabel();
+    }
+}
+
+int32_t ComponentLabels::GetComponent(glm::ivec2 point) const
+{
+    if (!IsPassable(point))
+    {
+        return InvalidComponent;
+    }
+
+    return FindRoot(m_Labels[GetCellIndex(point)]);
+}
+
+void ComponentLabels::GetComponents(std::vector<int32_t>& outComponents) const
+{
+    std::vector<int32_t> roots(m_Parents.size());
+    for (size_t label = 0; label < m_Parents.size(); ++label)
+    {
+        roots[label] = FindRoot(static_cast<int32_t>(label));
+    }
+
+    outComponents.resize(m_Labels.size());
+    for (size_t cell = 0; cell < m_Labels.size(); ++cell)
+    {
+        outComponents[cell] = m_Passable[cell] ? roots[m_Labels[cell]] : InvalidComponent;
+    }
+}
+
+size_t ComponentLabels::GetLastNumVisited() const
+{
+    return m_LastNumVisited;
+}
+
+int32_t ComponentLabels::FindRoot(int32_t label) const
+{
+    while (m_Parents[label] != label)
+    {
+        label = m_Parents[label];
+    }
+
+    return label;
+}
+
+int32_t ComponentLabels::FindRootCompressing(int32_t label)
+{
+    int32_t root = FindRoot(label);
+
+    while (m_Parents[label] != root)
+    {
+        int32_t parent = m_Parents[label];
+        m_Parents[label] = root;
+        label = parent;
+    }
+
+    return root;
+}
+
+int32_t ComponentLabels::CreateLabel()
+{
+    int32_t label = static_cast<int32_t>(m_Parents.size());
+    m_Parents.push_back(label);
+    m_Ranks.push_back(0);
+
+    return label;
+}
+
+void ComponentLabels::Union(int32_t a, int32_t b)
+{
+    a = FindRootCompressing(a);
+    b = FindRootCompressing(b);
+
+    if (a == b)
+    {
+        return;
+    }
+
+    /* Union by rank keeps trees shallow, GetComponent can not compress paths as it must stay read only */
+    if (m_Ranks[a] < m_Ranks[b])
+    {
+        std::swap(a, b);
+    }
+
+    m_Parents[b] = a;
+    m_Ranks[a] += m_Ranks[a] == m_Ranks[b];
+}
+
+void ComponentLabels::Relabel()
+{
+    m_Labels.assign(m_Passable.size(), InvalidComponent);
+    m_Parents.clear();
+    m_Ranks.clear();
+
+    std::vector<int32_t>& stack = m_Queues[0];
+
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        for (int32_t x = 0; x < m_Width; ++x)
+        {
+            int32_t index = GetCellIndex({x, y});
+            if (!m_Passable[index] || m_Labels[index] != InvalidComponent)
+            {
+                continue;
+            }
+
+            int32_t label = CreateLabel();
+            m_Labels[index] = label;
+            stack.assign(1, index);
+
+            while (!stack.empty())
+            {
+                glm::ivec2 cell{stack.back() % m_Width, stack.back() / m_Width};
+                stack.pop_back();
+
+                for (glm::ivec2 offset : NeighborOffsets)
+                {
+                    glm::ivec2 neighbor = cell + offset;
+                    if (IsPassable(neighbor) && m_Labels[GetCellIndex(neighbor)] == InvalidComponent)
+                    {
+                        m_Labels[GetCellIndex(neighbor)] = label;
+                        stack.push_back(GetCellIndex(neighbor));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ComponentLabels::OnCellOpened(glm::ivec2 point)
+{
+    /* Opened cell joins components of all its neighbors */
+    int32_t label = InvalidComponent;
+
+    for (glm::ivec2 offset : NeighborOffsets)
+    {
+        glm::ivec2 neighbor = point + offset;
+        if (!IsPassable(neighbor))
+        {
+            continue;
+        }
+
+        int32_t neighborLabel = m_Labels[GetCellIndex(neighbor)];
+
+        if (label == InvalidComponent)
+        {
+            label = neighborLabel;
+        }
+        else
+        {
+            Union(label, neighborLabel);
+        }
+    }
+
+    m_Labels[GetCellIndex(point)] = label == InvalidComponent ? CreateLabel() : FindRootCompressing(label);
+}
+
+void ComponentLabels::OnCellClosed(glm::ivec2 point)
+{
+    m_LastNumVisited = 0;
+
+    /* Neighbors lying in the same passable run of ring around point stay connected
+       through it, so only one of them has to be searched from */
+    int32_t firstBlocked = -1;
+    for (int32_t i = 0; i < 8 && firstBlocked < 0; ++i)
+    {
+        if (!IsPassable(point + RingOffsets[i]))
+        {
+            firstBlocked = i;
+        }
+    }
+
+    if (firstBlocked < 0)
+    {
+        return;
+    }
+
+    int32_t seeds[4];
+    int32_t numSeeds = 0;
+    bool bRunHasSeed = false;
+
+    for (int32_t step = 1; step <= 8; ++step)
+    {
+        int32_t i = (firstBlocked + step) % 8;
+        glm::ivec2 cell = point + RingOffsets[i];
+
+        if (!IsPassable(cell))
+        {
+            bRunHasSeed = false;
+        }
+        else if (i % 2 == 0 && !bRunHasSeed)
+        {
+            seeds[numSeeds++] = GetCellIndex(cell);
+            bRunHasSeed = true;
+        }
+    }
+
+    if (numSeeds <= 1)
+    {
+        return;
+    }
+
+    /* Breadth first searches from every seed advance one cell at a time. Search
+       reaching cell of another one merges their groups and stops, so every open
+       group has single running search. Group whose search runs out of cells is
+       cut off and gets fresh label, search ends once at most one group is open.
+       Work done is bounded by sizes of cut off parts, not by size of the rest */
+    if (++m_VisitStamp == 0)
+    {
+        std::fill(m_VisitStamps.begin(), m_VisitStamps.end(), 0);
+        m_VisitStamp = 1;
+    }
+
+    int32_t groups[4];
+    bool bRunning[4];
+    bool bCutOff[4] = {};
+    size_t heads[4] = {};
+
+    auto findGroup = [&groups](int32_t search)
+    {
+        while (groups[search] != search)
+        {
+            search = groups[search];
+        }
+
+        return search;
+    };
+
+    for (int32_t i = 0; i < numSeeds; ++i)
+    {
+        groups[i] = i;
+        bRunning[i] = true;
+        m_Queues[i].assign(1, seeds[i]);
+        m_VisitStamps[seeds[i]] = m_VisitStamp;
+        m_VisitOwners[seeds[i]] = static_cast<uint8_t>(i);
+    }
+
+    int32_t numOpenGroups = numSeeds;
+
+    while (numOpenGroups > 1)
+    {
+        for (int32_t i = 0; i < numSeeds && numOpenGroups > 1; ++i)
+        {
+            if (!bRunning[i])
+            {
+                continue;
+            }
+
+            int32_t group = findGroup(i);
+            std::vector<int32_t>& queue = m_Queues[i];
+
+            if (heads[i] == queue.size())
+            {
+                bRunning[i] = false;
+                bCutOff[group] = true;
+                --numOpenGroups;
+                continue;
+            }
+
+            int32_t index = queue[heads[i]++];
+            glm::ivec2 cell{index % m_Width, index / m_Width};
+
+            for (glm::ivec2 offset : NeighborOffsets)
+            {
+                glm::ivec2 neighbor = cell + offset;
+                if (!IsPassable(neighbor))
+                {
+                    continue;
+                }
+
+                int32_t neighborIndex = GetCellIndex(neighbor);
+
+                if (m_VisitStamps[neighborIndex] == m_VisitStamp)
+                {
+                    int32_t owner = m_VisitOwners[neighborIndex];
+                    if (owner == i)
+                    {
+                        continue;
+                    }
+
+                    int32_t ownerGroup = findGroup(owner);
+                    if (ownerGroup != group)
+                    {
+                        /* Searches met, the other one carries on for both */
+                        groups[group] = ownerGroup;
+                        bRunning[i] = false;
+                        --numOpenGroups;
+                        break;
+                    }
+
+                    /* Cell of stopped search of the same group is taken over */
+                }
+
+                m_VisitStamps[neighborIndex] = m_VisitStamp;
+                m_VisitOwners[neighborIndex] = static_cast<uint8_t>(i);
+                queue.push_back(neighborIndex);
+            }
+        }
+    }
+
+    for (int32_t i = 0; i < numSeeds; ++i)
+    {
+        m_LastNumVisited += m_Queues[i].size();
+    }
+
+    for (int32_t group = 0; group < numSeeds; ++group)
+    {
+        if (!bCutOff[group])
+        {
+            continue;
+        }
+
+        int32_t label = CreateLabel();
+
+        for (int32_t i = 0; i < numSeeds; ++i)
+        {
+            if (findGroup(i) != group)
+            {
+                continue;
+            }
+
+            for (int32_t index : m_Queues[i])
+            {
+                m_Labels[index] = label;
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "MapInterface.h"
+
+#include <vector>
+
+constexpr int32_t InvalidComponent = -1;
+
+/* Labels of 4-connected components of passable cells. Passable are all cells
+   but obstacles, so agents and goals moving around never touch labels. Cells
+   in different components can not be joined by any 4 or 8-connected path.
+   Components are union-find sets of labels: opening cell merges labels of its
+   neighbors, closing one searches from its neighbors in lockstep and gives
+   fresh label only to parts it cut off from the largest one */
+class ComponentLabels
+{
+public:
+    /* Makes every cell of width x height grid passable */
+    void Reset(int32_t width, int32_t height);
+
+    void SetPassable(glm::ivec2 point, bool bPassable);
+
+    /* Component of cell or InvalidComponent when it is not passable. Does not
+       modify labels, so many threads may query it while grid is unchanged */
+    int32_t GetComponent(glm::ivec2 point) const;
+
+    bool AreConnected(glm::ivec2 a, glm::ivec2 b) const
+    {
+        int32_t component = GetComponent(a);
+        return component != InvalidComponent && component == GetComponent(b);
+    }
+
+    /* Component of every cell, x + y * width. Resolves each label once instead of once per cell */
+    void GetComponents(std::vector<int32_t>& outComponents) const;
+
+    /* Number of cells visited by last SetPassable which closed cell */
+    size_t GetLastNumVisited() const;
+
+private:
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+
+    std::vector<uint8_t> m_Passable;
+    std::vector<int32_t> m_Labels;
+
+    /* Union-find forest over labels, roots are components */
+    std::vector<int32_t> m_Parents;
+    std::vector<uint8_t> m_Ranks;
+
+    /* Scratch of lockstep search, cell was visited by m_VisitOwners[cell] when its stamp is current */
+    std::vector<uint32_t> m_VisitStamps;
+    std::vector<uint8_t> m_VisitOwners;
+    uint32_t m_VisitStamp = 0;
+    std::vector<int32_t> m_Queues[4];
+
+    size_t m_LastNumVisited = 0;
+
+private:
+    int32_t GetCellIndex(glm::ivec2 point) const
+    {
+        return point.x + point.y * m_Width;
+    }
+
+    bool IsPassable(glm::ivec2 point) const
+    {
+        return point.x >= 0 && point.x < m_Width && point.y >= 0 && point.y < m_Height && m_Passable[GetCellIndex(point)];
+    }
+
+    int32_t FindRoot(int32_t label) const;
+    int32_t FindRootCompressing(int32_t label);
+    int32_t CreateLabel();
+    void Union(int32_t a, int32_t b);
+
+    /* Labels every component from scratch, drops labels left behind by earlier splits */
+    void Relabel();
+
+    void OnCellOpened(glm::ivec2 point);
+    void OnCellClosed(glm::ivec2 point);
+};
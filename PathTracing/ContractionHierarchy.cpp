@@ -0,0 +1,789 @@
+#include "ContractionHierarchy.h"
+#include "MapChangeLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <functional>
+
+typedef std::chrono::steady_clock Clock;
+typedef ContractionHierarchy::Edge Edge;
+
+static const glm::ivec2 NeighborOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+/* Bump when layout of saved file changes, files of other versions are rejected */
+static constexpr char FileMagic[4] = {'P', 'T', 'C', 'H'};
+static constexpr uint32_t FileVersion = 1;
+
+/* Witness search gives up after settling that many cells, adding shortcut that may be unnecessary */
+static constexpr int32_t MaxWitnessSettled = 256;
+
+static double GetElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/* Remaining graph while cells are being contracted, discarded once hierarchy is built.
+   Works with cell indices, edges are renumbered to nodes after all cells are contracted */
+class HierarchyBuilder
+{
+public:
+    HierarchyBuilder(const std::vector<uint8_t>& stepCosts, int32_t width, int32_t height) :
+        Upward(stepCosts.size()),
+        Downward(stepCosts.size()),
+        m_StepCosts(stepCosts),
+        m_Outgoing(stepCosts.size()),
+        m_Incoming(stepCosts.size()),
+        m_NumContractedNeighbors(stepCosts.size(), 0),
+        m_Levels(stepCosts.size(), 0),
+        m_WitnessCosts(stepCosts.size(), INT32_MAX),
+        m_WitnessGenerations(stepCosts.size(), 0),
+        m_TargetCosts(stepCosts.size(), 0),
+        m_TargetGenerations(stepCosts.size(), 0)
+    {
+        for (int32_t cell = 0; cell < static_cast<int32_t>(stepCosts.size()); ++cell)
+        {
+            if (stepCosts[cell] == 0)
+            {
+                continue;
+            }
+
+            PathFindingPoint point{cell % width, cell / width};
+
+            for (glm::ivec2 offset : NeighborOffsets)
+            {
+                PathFindingPoint neighbor = point + offset;
+                if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height)
+                {
+                    continue;
+                }
+
+                /* Entering cell costs its terrain cost, so edges in opposite directions differ on weighted terrain */
+                int32_t neighborIndex = neighbor.x + neighbor.y * width;
+                if (stepCosts[neighborIndex] != 0)
+                {
+                    m_Outgoing[cell].push_back({neighborIndex, stepCosts[neighborIndex], ContractionHierarchy::InvalidNode});
+                    m_Incoming[neighborIndex].push_back({cell, stepCosts[neighborIndex], ContractionHierarchy::InvalidNode});
+                }
+            }
+        }
+    }
+
+    void ContractAll()
+    {
+        typedef std::pair<int32_t, int32_t> QueueEntry;
+        std::vector<QueueEntry> queue;
+
+        for (int32_t cell = 0; cell < static_cast<int32_t>(m_StepCosts.size()); ++cell)
+        {
+            if (m_StepCosts[cell] != 0)
+            {
+                queue.push_back({GetPriority(cell), cell});
+            }
+        }
+
+        std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+
+        /* Priorities are updated lazily. Contracting cell only makes its neighbors more important, so
+           cell popped from queue is contracted when its fresh priority still does not exceed the next one */
+        while (!queue.empty())
+        {
+            std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+            int32_t cell = queue.back().second;
+            queue.pop_back();
+
+            int32_t priority = GetPriority(cell);
+            if (!queue.empty() && priority > queue.front().first)
+            {
+                queue.push_back({priority, cell});
+                std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+                continue;
+            }
+
+            Contract(cell);
+            Order.push_back(cell);
+        }
+    }
+
+public:
+    /* Edges every cell had when it was contracted, all of them lead to cells contracted later */
+    std::vector<std::vector<Edge>> Upward;
+    std::vector<std::vector<Edge>> Downward;
+    std::vector<int32_t> Order;
+    size_t NumShortcuts = 0;
+
+private:
+    const std::vector<uint8_t>& m_StepCosts;
+    std::vector<std::vector<Edge>> m_Outgoing;
+
+    /* Target of incoming edge is the cell it leaves */
+    std::vector<std::vector<Edge>> m_Incoming;
+
+    std::vector<int32_t> m_NumContractedNeighbors;
+
+    /* Length of longest chain of contracted cells below cell, keeps hierarchy shallow */
+    std::vector<int32_t> m_Levels;
+
+    std::vector<PathCost> m_WitnessCosts;
+    std::vector<uint32_t> m_WitnessGenerations;
+    std::vector<std::pair<PathCost, int32_t>> m_WitnessHeap;
+    uint32_t m_WitnessGeneration = 0;
+
+    /* Cells shortcut may be needed to, with cost that path to them has to beat */
+    std::vector<PathCost> m_TargetCosts;
+    std::vector<uint32_t> m_TargetGenerations;
+    uint32_t m_TargetGeneration = 0;
+
+private:
+    /* Fewer edges added than removed, fewer contracted neighbors and lower level make cell less important */
+    int32_t GetPriority(int32_t cell)
+    {
+        int32_t numShortcuts = ProcessShortcuts(cell, false);
+        int32_t edgeDifference = numShortcuts - static_cast<int32_t>(m_Outgoing[cell].size() + m_Incoming[cell].size());
+
+        return 2 * edgeDifference + m_NumContractedNeighbors[cell] + m_Levels[cell];
+    }
+
+    void Contract(int32_t cell)
+    {
+        ProcessShortcuts(cell, true);
+
+        /* Every remaining neighbor is contracted later, so edges of cell lead upwards */
+        Upward[cell] = std::move(m_Outgoing[cell]);
+        Downward[cell] = std::move(m_Incoming[cell]);
+
+        for (const Edge& edge : Upward[cell])
+        {
+            RemoveEdge(m_Incoming[edge.Target], cell);
+            ++m_NumContractedNeighbors[edge.Target];
+            m_Levels[edge.Target] = std::max(m_Levels[edge.Target], m_Levels[cell] + 1);
+        }
+
+        for (const Edge& edge : Downward[cell])
+        {
+            RemoveEdge(m_Outgoing[edge.Target], cell);
+            m_Levels[edge.Target] = std::max(m_Levels[edge.Target], m_Levels[cell] + 1);
+
+            /* Neighbor with edges in both directions is counted once */
+            if (!FindTarget(Upward[cell], edge.Target))
+            {
+                ++m_NumContractedNeighbors[edge.Target];
+            }
+        }
+    }
+
+    /* Counts shortcuts contracting cell needs, adding them to graph when bAdd is set */
+    int32_t ProcessShortcuts(int32_t cell, bool bAdd)
+    {
+        int32_t numShortcuts = 0;
+
+        for (size_t i = 0; i < m_Incoming[cell].size(); ++i)
+        {
+            Edge incoming = m_Incoming[cell][i];
+
+            /* Every cell reached from cell is target, unless path to it is already known not to need cell */
+            ++m_TargetGeneration;
+            int32_t numTargets = 0;
+
+            for (const Edge& outgoing : m_Outgoing[cell])
+            {
+                if (outgoing.Target != incoming.Target)
+                {
+                    m_TargetGenerations[outgoing.Target] = m_TargetGeneration;
+                    m_TargetCosts[outgoing.Target] = incoming.Cost + outgoing.Cost;
+                    ++numTargets;
+                }
+            }
+
+            /* Direct edge is the most common witness, checking it first often saves whole search */
+            for (const Edge& edge : m_Outgoing[incoming.Target])
+            {
+                if (IsTarget(edge.Target) && edge.Cost <= m_TargetCosts[edge.Target])
+                {
+                    m_TargetGenerations[edge.Target] = 0;
+                    --numTargets;
+                }
+            }
+
+            if (numTargets == 0)
+            {
+                continue;
+            }
+
+            PathCost maxCost = 0;
+            for (const Edge& outgoing : m_Outgoing[cell])
+            {
+                if (IsTarget(outgoing.Target))
+                {
+                    maxCost = std::max(maxCost, m_TargetCosts[outgoing.Target]);
+                }
+            }
+
+            RunWitnessSearch(incoming.Target, cell, maxCost, numTargets);
+
+            for (size_t j = 0; j < m_Outgoing[cell].size(); ++j)
+            {
+                Edge outgoing = m_Outgoing[cell][j];
+                PathCost cost = incoming.Cost + outgoing.Cost;
+
+                if (!IsTarget(outgoing.Target) || GetWitnessCost(outgoing.Target) <= cost)
+                {
+                    continue;
+                }
+
+                ++numShortcuts;
+
+                if (bAdd)
+                {
+                    AddShortcut(incoming.Target, outgoing.Target, cost, cell);
+                }
+            }
+        }
+
+        return numShortcuts;
+    }
+
+    /* Dijkstra from source over remaining graph without skipped cell, limited by cost and number of
+       settled cells. Stops early once all targets are settled */
+    void RunWitnessSearch(int32_t source, int32_t skipped, PathCost maxCost, int32_t numTargets)
+    {
+        ++m_WitnessGeneration;
+        m_WitnessHeap.clear();
+        SetWitnessCost(source, 0);
+        m_WitnessHeap.push_back({0, source});
+
+        int32_t numSettled = 0;
+
+        while (!m_WitnessHeap.empty() && numSettled < MaxWitnessSettled)
+        {
+            std::pop_heap(m_WitnessHeap.begin(), m_WitnessHeap.end(), std::greater<std::pair<PathCost, int32_t>>());
+            auto [cost, cell] = m_WitnessHeap.back();
+            m_WitnessHeap.pop_back();
+
+            if (cost != GetWitnessCost(cell))
+            {
+                continue;
+            }
+
+            if (cost > maxCost || (IsTarget(cell) && --numTargets == 0))
+            {
+                break;
+            }
+
+            ++numSettled;
+
+            for (const Edge& edge : m_Outgoing[cell])
+            {
+                PathCost newCost = cost + edge.Cost;
+
+                if (edge.Target != skipped && newCost < GetWitnessCost(edge.Target))
+                {
+                    SetWitnessCost(edge.Target, newCost);
+                    m_WitnessHeap.push_back({newCost, edge.Target});
+                    std::push_heap(m_WitnessHeap.begin(), m_WitnessHeap.end(), std::greater<std::pair<PathCost, int32_t>>());
+                }
+            }
+        }
+    }
+
+    bool IsTarget(int32_t cell) const
+    {
+        return m_TargetGenerations[cell] == m_TargetGeneration;
+    }
+
+    PathCost GetWitnessCost(int32_t cell) const
+    {
+        return m_WitnessGenerations[cell] == m_WitnessGeneration ? m_WitnessCosts[cell] : INT32_MAX;
+    }
+
+    void SetWitnessCost(int32_t cell, PathCost cost)
+    {
+        m_WitnessGenerations[cell] = m_WitnessGeneration;
+        m_WitnessCosts[cell] = cost;
+    }
+
+    /* Keeps only cheapest edge between two cells */
+    void AddShortcut(int32_t from, int32_t to, PathCost cost, int32_t middle)
+    {
+        Edge* outgoing = FindTarget(m_Outgoing[from], to);
+
+        if (outgoing)
+        {
+            if (outgoing->Cost <= cost)
+            {
+                return;
+            }
+
+            *outgoing = {to, cost, middle};
+            *FindTarget(m_Incoming[to], from) = {from, cost, middle};
+        }
+        else
+        {
+            m_Outgoing[from].push_back({to, cost, middle});
+            m_Incoming[to].push_back({from, cost, middle});
+        }
+
+        ++NumShortcuts;
+    }
+
+    static Edge* FindTarget(std::vector<Edge>& edges, int32_t target)
+    {
+        auto found = std::find_if(edges.begin(), edges.end(), [target](const Edge& edge)
+        {
+            return edge.Target == target;
+        });
+
+        return found != edges.end() ? &*found : nullptr;
+    }
+
+    static void RemoveEdge(std::vector<Edge>& edges, int32_t target)
+    {
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [target](const Edge& edge)
+        {
+            return edge.Target == target;
+        }), edges.end());
+    }
+};
+
+template<typename T>
+static void WriteVector(std::ofstream& file, const std::vector<T>& values)
+{
+    uint64_t size = values.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(values.data()), size * sizeof(T));
+}
+
+template<typename T>
+static bool ReadVector(std::ifstream& file, std::vector<T>& values, uint64_t maxSize)
+{
+    uint64_t size = 0;
+    if (!file.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > maxSize)
+    {
+        return false;
+    }
+
+    values.resize(size);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), size * sizeof(T)));
+}
+
+/* Packs edge lists of cells into single array in node order, renumbering their ends from cells to nodes */
+static void PackEdges(std::vector<std::vector<Edge>>& edgesOfCells, const std::vector<int32_t>& cellOfNode,
+    const std::vector<int32_t>& nodeOfCell, std::vector<uint32_t>& outFirstEdge, std::vector<Edge>& outEdges)
+{
+    outFirstEdge.assign(cellOfNode.size() + 1, 0);
+    outEdges.clear();
+
+    for (size_t node = 0; node < cellOfNode.size(); ++node)
+    {
+        std::vector<Edge>& edges = edgesOfCells[cellOfNode[node]];
+        outFirstEdge[node] = static_cast<uint32_t>(outEdges.size());
+
+        for (const Edge& edge : edges)
+        {
+            int32_t middle = edge.Middle != ContractionHierarchy::InvalidNode ? nodeOfCell[edge.Middle] : ContractionHierarchy::InvalidNode;
+            outEdges.push_back({nodeOfCell[edge.Target], edge.Cost, middle});
+        }
+
+        std::vector<Edge>().swap(edges);
+    }
+
+    outFirstEdge.back() = static_cast<uint32_t>(outEdges.size());
+}
+
+/* Edge offsets must describe valid ranges, and every edge must lead to node contracted later than its owner,
+   with middle node contracted earlier, so that unpacking it always terminates */
+static bool AreEdgesValid(const std::vector<uint32_t>& firstEdge, const std::vector<Edge>& edges, size_t numNodes)
+{
+    if (firstEdge.size() != numNodes + 1 || firstEdge.front() != 0 || firstEdge.back() != edges.size() ||
+        !std::is_sorted(firstEdge.begin(), firstEdge.end()))
+    {
+        return false;
+    }
+
+    for (size_t node = 0; node < numNodes; ++node)
+    {
+        for (uint32_t i = firstEdge[node]; i < firstEdge[node + 1]; ++i)
+        {
+            const Edge& edge = edges[i];
+
+            if (edge.Target <= static_cast<int32_t>(node) || edge.Target >= static_cast<int32_t>(numNodes) ||
+                edge.Middle >= static_cast<int32_t>(node) || edge.Middle < ContractionHierarchy::InvalidNode)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool HasEdgeTo(const std::vector<uint32_t>& firstEdge, const std::vector<Edge>& edges, int32_t node, int32_t target)
+{
+    return std::any_of(edges.begin() + firstEdge[node], edges.begin() + firstEdge[node + 1],
+        [target](const Edge& edge) { return edge.Target == target; });
+}
+
+/* Shortcut from -> to made for middle node needs both its halves stored at that node, or it can not be unpacked */
+static bool AreShortcutsValid(const std::vector<uint32_t>& firstUpwardEdge, const std::vector<Edge>& upwardEdges,
+    const std::vector<uint32_t>& firstDownwardEdge, const std::vector<Edge>& downwardEdges)
+{
+    auto hasHalves = [&](int32_t from, int32_t to, int32_t middle)
+    {
+        return middle == ContractionHierarchy::InvalidNode || (HasEdgeTo(firstUpwardEdge, upwardEdges, middle, to) &&
+            HasEdgeTo(firstDownwardEdge, downwardEdges, middle, from));
+    };
+
+    for (size_t node = 0; node + 1 < firstUpwardEdge.size(); ++node)
+    {
+        for (uint32_t i = firstUpwardEdge[node]; i < firstUpwardEdge[node + 1]; ++i)
+        {
+            if (!hasHalves(static_cast<int32_t>(node), upwardEdges[i].Target, upwardEdges[i].Middle))
+            {
+                return false;
+            }
+        }
+
+        for (uint32_t i = firstDownwardEdge[node]; i < firstDownwardEdge[node + 1]; ++i)
+        {
+            if (!hasHalves(downwardEdges[i].Target, static_cast<int32_t>(node), downwardEdges[i].Middle))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::vector<uint8_t> ContractionHierarchy::GetStepCosts(const IMap& map)
+{
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+    std::vector<uint8_t> stepCosts(static_cast<size_t>(width) * height);
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            stepCosts[x + y * width] = GetStepCost(map, {x, y});
+        }
+    }
+
+    return stepCosts;
+}
+
+std::unique_ptr<ContractionHierarchy> ContractionHierarchy::BuildDetached(std::vector<uint8_t> stepCosts, int32_t width,
+    int32_t height, uint64_t revision)
+{
+    std::unique_ptr<ContractionHierarchy> hierarchy = std::make_unique<ContractionHierarchy>();
+    hierarchy->BuildFromStepCosts(std::move(stepCosts), width, height, revision);
+    return hierarchy;
+}
+
+void ContractionHierarchy::Build(const IMap& map)
+{
+    BuildFromStepCosts(GetStepCosts(map), map.GetMapWidth(), map.GetMapHeight(), map.GetRevision());
+}
+
+void ContractionHierarchy::BuildFromStepCosts(std::vector<uint8_t> stepCosts, int32_t width, int32_t height, uint64_t revision)
+{
+    Clock::time_point start = Clock::now();
+
+    m_Width = width;
+    m_Height = height;
+    m_Revision = revision;
+    m_StepCosts = std::move(stepCosts);
+    m_bStale = false;
+
+    size_t numCells = static_cast<size_t>(m_Width) * m_Height;
+
+    HierarchyBuilder builder(m_StepCosts, m_Width, m_Height);
+    builder.ContractAll();
+
+    m_CellOfNode = std::move(builder.Order);
+    m_NodeOfCell.assign(numCells, InvalidNode);
+
+    for (size_t node = 0; node < m_CellOfNode.size(); ++node)
+    {
+        m_NodeOfCell[m_CellOfNode[node]] = static_cast<int32_t>(node);
+    }
+
+    PackEdges(builder.Upward, m_CellOfNode, m_NodeOfCell, m_FirstUpwardEdge, m_UpwardEdges);
+    PackEdges(builder.Downward, m_CellOfNode, m_NodeOfCell, m_FirstDownwardEdge, m_DownwardEdges);
+    m_NumShortcuts = builder.NumShortcuts;
+
+    m_LastBuildTimeMs = GetElapsedMs(start);
+}
+
+void ContractionHierarchy::Update(const IMap& map)
+{
+    if (m_PendingBuild.valid() && m_PendingBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        TakeOver(*m_PendingBuild.get());
+    }
+
+    CheckChanges(map);
+
+    /* Build works on copy of step costs, edits made meanwhile are checked once it is taken over */
+    if (m_bStale && !m_PendingBuild.valid())
+    {
+        m_PendingBuild = std::async(std::launch::async, &ContractionHierarchy::BuildDetached, GetStepCosts(map),
+            map.GetMapWidth(), map.GetMapHeight(), map.GetRevision());
+    }
+}
+
+void ContractionHierarchy::TakeOver(ContractionHierarchy& built)
+{
+    m_Width = built.m_Width;
+    m_Height = built.m_Height;
+    m_Revision = built.m_Revision;
+    m_StepCosts = std::move(built.m_StepCosts);
+    m_NodeOfCell = std::move(built.m_NodeOfCell);
+    m_CellOfNode = std::move(built.m_CellOfNode);
+    m_FirstUpwardEdge = std::move(built.m_FirstUpwardEdge);
+    m_UpwardEdges = std::move(built.m_UpwardEdges);
+    m_FirstDownwardEdge = std::move(built.m_FirstDownwardEdge);
+    m_DownwardEdges = std::move(built.m_DownwardEdges);
+    m_NumShortcuts = built.m_NumShortcuts;
+    m_LastBuildTimeMs = built.m_LastBuildTimeMs;
+    m_bStale = false;
+}
+
+void ContractionHierarchy::CheckChanges(const IMap& map)
+{
+    if (m_bStale || m_Revision == map.GetRevision())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        m_bStale = true;
+        return;
+    }
+
+    /* Agents walking around change field type, but not step cost */
+    for (glm::ivec2 position : m_Changes)
+    {
+        if (m_StepCosts[position.x + position.y * m_Width] != GetStepCost(map, position))
+        {
+            m_bStale = true;
+            return;
+        }
+    }
+
+    m_Revision = map.GetRevision();
+}
+
+bool ContractionHierarchy::Save(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+
+    if (!file || !IsBuilt())
+    {
+        return false;
+    }
+
+    uint64_t numShortcuts = m_NumShortcuts;
+
+    file.write(FileMagic, sizeof(FileMagic));
+    file.write(reinterpret_cast<const char*>(&FileVersion), sizeof(FileVersion));
+    file.write(reinterpret_cast<const char*>(&m_Width), sizeof(m_Width));
+    file.write(reinterpret_cast<const char*>(&m_Height), sizeof(m_Height));
+    file.write(reinterpret_cast<const char*>(&numShortcuts), sizeof(numShortcuts));
+
+    WriteVector(file, m_StepCosts);
+    WriteVector(file, m_CellOfNode);
+    WriteVector(file, m_FirstUpwardEdge);
+    WriteVector(file, m_UpwardEdges);
+    WriteVector(file, m_FirstDownwardEdge);
+    WriteVector(file, m_DownwardEdges);
+
+    return static_cast<bool>(file);
+}
+
+bool ContractionHierarchy::Load(const std::string& filePath, const IMap& map)
+{
+    std::ifstream file(filePath, std::ios::binary);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    char magic[sizeof(FileMagic)] = {};
+    uint32_t version = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    uint64_t numShortcuts = 0;
+
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&width), sizeof(width));
+    file.read(reinterpret_cast<char*>(&height), sizeof(height));
+    file.read(reinterpret_cast<char*>(&numShortcuts), sizeof(numShortcuts));
+
+    if (!file || !std::equal(magic, magic + sizeof(magic), FileMagic) || version != FileVersion ||
+        width != map.GetMapWidth() || height != map.GetMapHeight())
+    {
+        return false;
+    }
+
+    /* Cell has at most 4 real edges, shortcuts are bounded by what the file says */
+    size_t numCells = static_cast<size_t>(width) * height;
+    uint64_t maxEdges = 4 * numCells + numShortcuts;
+
+    std::vector<uint8_t> stepCosts;
+    std::vector<int32_t> cellOfNode;
+    std::vector<uint32_t> firstUpwardEdge;
+    std::vector<Edge> upwardEdges;
+    std::vector<uint32_t> firstDownwardEdge;
+    std::vector<Edge> downwardEdges;
+
+    if (!ReadVector(file, stepCosts, numCells) || !ReadVector(file, cellOfNode, numCells) ||
+        !ReadVector(file, firstUpwardEdge, numCells + 1) || !ReadVector(file, upwardEdges, maxEdges) ||
+        !ReadVector(file, firstDownwardEdge, numCells + 1) || !ReadVector(file, downwardEdges, maxEdges))
+    {
+        return false;
+    }
+
+    if (stepCosts.size() != numCells || !AreEdgesValid(firstUpwardEdge, upwardEdges, cellOfNode.size()) ||
+        !AreEdgesValid(firstDownwardEdge, downwardEdges, cellOfNode.size()) ||
+        !AreShortcutsValid(firstUpwardEdge, upwardEdges, firstDownwardEdge, downwardEdges))
+    {
+        return false;
+    }
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            if (stepCosts[x + y * width] != GetStepCost(map, {x, y}))
+            {
+                return false;
+            }
+        }
+    }
+
+    /* Every node has to stand for different passable cell */
+    std::vector<int32_t> nodeOfCell(numCells, InvalidNode);
+
+    for (size_t node = 0; node < cellOfNode.size(); ++node)
+    {
+        int32_t cellIndex = cellOfNode[node];
+        if (cellIndex < 0 || static_cast<size_t>(cellIndex) >= numCells || stepCosts[cellIndex] == 0 ||
+            nodeOfCell[cellIndex] != InvalidNode)
+        {
+            return false;
+        }
+
+        nodeOfCell[cellIndex] = static_cast<int32_t>(node);
+    }
+
+    m_Width = width;
+    m_Height = height;
+    m_Revision = map.GetRevision();
+    m_StepCosts = std::move(stepCosts);
+    m_NodeOfCell = std::move(nodeOfCell);
+    m_CellOfNode = std::move(cellOfNode);
+    m_FirstUpwardEdge = std::move(firstUpwardEdge);
+    m_UpwardEdges = std::move(upwardEdges);
+    m_FirstDownwardEdge = std::move(firstDownwardEdge);
+    m_DownwardEdges = std::move(downwardEdges);
+    m_NumShortcuts = numShortcuts;
+    m_LastBuildTimeMs = 0.0;
+    m_bStale = false;
+
+    return true;
+}
+
+const ContractionHierarchy::Edge* ContractionHierarchy::FindEdge(std::span<const Edge> edges, int32_t target) const
+{
+    for (const Edge& edge : edges)
+    {
+        if (edge.Target == target)
+        {
+            return &edge;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ContractionHierarchy::UnpackEdge(int32_t from, int32_t to, int32_t middle, Path& outPath) const
+{
+    struct PendingEdge
+    {
+        int32_t From;
+        int32_t To;
+        int32_t Middle;
+    };
+
+    /* Expanded depth first with explicit stack, second half of shortcut is pushed first so cells come out in order */
+    std::vector<PendingEdge> stack{{from, to, middle}};
+
+    while (!stack.empty())
+    {
+        PendingEdge edge = stack.back();
+        stack.pop_back();
+
+        if (edge.Middle == InvalidNode)
+        {
+            outPath.push_back(GetNodePoint(edge.To));
+            continue;
+        }
+
+        /* Middle node was contracted before both ends, so both halves are stored at it */
+        const Edge* second = FindEdge(GetUpwardEdges(edge.Middle), edge.To);
+        const Edge* first = FindEdge(GetDownwardEdges(edge.Middle), edge.From);
+
+        if (!first || !second)
+        {
+            return false;
+        }
+
+        stack.push_back({edge.Middle, edge.To, second->Middle});
+        stack.push_back({edge.From, edge.Middle, first->Middle});
+    }
+
+    return true;
+}
+
+bool ContractionHierarchy::IsUsable() const
+{
+    return IsBuilt() && !m_bStale;
+}
+
+bool ContractionHierarchy::IsBuilt() const
+{
+    return !m_FirstUpwardEdge.empty();
+}
+
+bool ContractionHierarchy::IsRebuilding() const
+{
+    return m_PendingBuild.valid();
+}
+
+size_t ContractionHierarchy::GetNumNodes() const
+{
+    return m_CellOfNode.size();
+}
+
+size_t ContractionHierarchy::GetNumShortcuts() const
+{
+    return m_NumShortcuts;
+}
+
+size_t ContractionHierarchy::GetMemoryUsage() const
+{
+    return m_StepCosts.capacity() * sizeof(uint8_t) +
+        (m_NodeOfCell.capacity() + m_CellOfNode.capacity()) * sizeof(int32_t) +
+        (m_FirstUpwardEdge.capacity() + m_FirstDownwardEdge.capacity()) * sizeof(uint32_t) +
+        (m_UpwardEdges.capacity() + m_DownwardEdges.capacity()) * sizeof(Edge);
+}
+
+double ContractionHierarchy::GetLastBuildTimeMs() const
+{
+    return m_LastBuildTimeMs;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/* Contraction hierarchy over 4-connected grid, meant for maps that are not
+   edited at runtime. Passable cells are contracted one by one in order of
+   importance, and every contracted cell is replaced by shortcut edges
+   between its remaining neighbors, unless witness search finds path that is
+   as cheap without it. Query is then Dijkstra from both ends that only ever
+   walks to cells contracted later, which settles few hundred cells even on
+   very large maps. Only obstacles block hierarchy, agents standing in the
+   way do not.
+
+   Nodes of hierarchy are numbered in contraction order, so the few nodes
+   every query reaches lie next to each other in memory. Building takes
+   seconds on large maps, so hierarchy can be saved to disk and loaded back
+   instead. Any edit changing terrain or obstacles makes hierarchy unusable,
+   and Update builds new one from scratch on another thread meanwhile */
+class ContractionHierarchy
+{
+public:
+    /* Edge between nodes. Shortcut remembers node it was made for, real
+       edge between neighboring cells has no middle node */
+    struct Edge
+    {
+        int32_t Target;
+        PathCost Cost;
+        int32_t Middle;
+    };
+
+    static constexpr int32_t InvalidNode = -1;
+
+    /* Builds hierarchy on calling thread */
+    void Build(const IMap& map);
+
+    /* Takes over hierarchy built in background, starts new build when map size,
+       terrain or obstacles changed since current hierarchy was built */
+    void Update(const IMap& map);
+
+    /* Writes hierarchy in native byte order, returns false when file can not be written */
+    bool Save(const std::string& filePath) const;
+
+    /* Reads hierarchy saved for the same map. Returns false and leaves current
+       hierarchy untouched when file is missing, truncated or made for another map */
+    bool Load(const std::string& filePath, const IMap& map);
+
+    /* Node of passable cell, InvalidNode for obstacles and cells outside of map */
+    int32_t GetNode(PathFindingPoint point) const
+    {
+        if (point.x < 0 || point.x >= m_Width || point.y < 0 || point.y >= m_Height)
+        {
+            return InvalidNode;
+        }
+
+        return m_NodeOfCell[point.x + point.y * m_Width];
+    }
+
+    PathFindingPoint GetNodePoint(int32_t node) const
+    {
+        int32_t cellIndex = m_CellOfNode[node];
+        return {cellIndex % m_Width, cellIndex / m_Width};
+    }
+
+    /* Edges from node to nodes contracted after it */
+    std::span<const Edge> GetUpwardEdges(int32_t node) const
+    {
+        return {m_UpwardEdges.data() + m_FirstUpwardEdge[node], m_UpwardEdges.data() + m_FirstUpwardEdge[node + 1]};
+    }
+
+    /* Edges to node from nodes contracted after it, Target is the node edge leaves */
+    std::span<const Edge> GetDownwardEdges(int32_t node) const
+    {
+        return {m_DownwardEdges.data() + m_FirstDownwardEdge[node], m_DownwardEdges.data() + m_FirstDownwardEdge[node + 1]};
+    }
+
+    /* Edge of the list leading to target, nullptr when there is none */
+    const Edge* FindEdge(std::span<const Edge> edges, int32_t target) const;
+
+    /* Appends cells of edge from -> to, without from itself, expanding shortcuts down to real steps.
+       Returns false when some shortcut has no halves to expand into */
+    bool UnpackEdge(int32_t from, int32_t to, int32_t middle, Path& outPath) const;
+
+    /* True when hierarchy exists and describes map seen by last Update */
+    bool IsUsable() const;
+
+    bool IsBuilt() const;
+    bool IsRebuilding() const;
+
+    size_t GetNumNodes() const;
+    size_t GetNumShortcuts() const;
+    size_t GetMemoryUsage() const;
+    double GetLastBuildTimeMs() const;
+
+private:
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+
+    /* Map revision edits were checked up to */
+    uint64_t m_Revision = 0;
+
+    /* Terrain cost of every cell hierarchy was built for, zero for obstacles */
+    std::vector<uint8_t> m_StepCosts;
+
+    std::vector<int32_t> m_NodeOfCell;
+    std::vector<int32_t> m_CellOfNode;
+
+    /* Edges of node i are [First[i], First[i + 1]) */
+    std::vector<uint32_t> m_FirstUpwardEdge;
+    std::vector<Edge> m_UpwardEdges;
+    std::vector<uint32_t> m_FirstDownwardEdge;
+    std::vector<Edge> m_DownwardEdges;
+
+    size_t m_NumShortcuts = 0;
+    double m_LastBuildTimeMs = 0.0;
+
+    std::future<std::unique_ptr<ContractionHierarchy>> m_PendingBuild;
+
+    /* Some edit since build changed step cost, so hierarchy no longer describes map */
+    bool m_bStale = true;
+    std::vector<glm::ivec2> m_Changes;
+
+private:
+    static std::vector<uint8_t> GetStepCosts(const IMap& map);
+    static std::unique_ptr<ContractionHierarchy> BuildDetached(std::vector<uint8_t> stepCosts, int32_t width, int32_t height,
+        uint64_t revision);
+
+    void BuildFromStepCosts(std::vector<uint8_t> stepCosts, int32_t width, int32_t height, uint64_t revision);
+    void TakeOver(ContractionHierarchy& built);
+    void CheckChanges(const IMap& map);
+
+    static uint8_t GetStepCost(const IMap& map, PathFindingPoint point)
+    {
+        return map.GetFieldAt(point) == EFieldType::Obstacle ? 0 : map.GetTerrainCost(point);
+    }
+};
@@ -0,0 +1,192 @@
+#include "PathFinder.h"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+typedef std::pair<PathCost, int32_t> ContractionEntry;
+
+static PathCost GetContractionCost(const ContractionFrontier& frontier, uint32_t generation, int32_t node)
+{
+    const ContractionRecord& record = frontier.Records[node];
+    return record.Generation == generation ? record.Cost : INT32_MAX;
+}
+
+static void OpenContractionNode(ContractionFrontier& frontier, uint32_t generation, int32_t node, int32_t parent, PathCost cost)
+{
+    ContractionRecord& record = frontier.Records[node];
+
+    if (record.Generation == generation && record.Cost <= cost)
+    {
+        return;
+    }
+
+    record = {generation, cost, parent};
+    frontier.OpenList.push_back({cost, node});
+    std::push_heap(frontier.OpenList.begin(), frontier.OpenList.end(), std::greater<ContractionEntry>());
+}
+
+PathFindingResult PathFinder::FindPathContraction(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    if (!m_ContractionHierarchy || !m_ContractionHierarchy->IsUsable())
+    {
+        return FindPathAStar<FourConnected>(map, start, goal);
+    }
+
+    if (start == goal)
+    {
+        return {EPathFindingStatus::Found, {start}, 0};
+    }
+
+    const ContractionHierarchy& hierarchy = *m_ContractionHierarchy;
+    int32_t startNode = hierarchy.GetNode(start);
+    int32_t goalNode = hierarchy.GetNode(goal);
+
+    if (startNode == ContractionHierarchy::InvalidNode || goalNode == ContractionHierarchy::InvalidNode || !IsWalkable(goal, &map))
+    {
+        return {EPathFindingStatus::NoPath};
+    }
+
+    StartContractionSession(hierarchy.GetNumNodes());
+
+    /* Forward search walks upward edges from start, backward search walks downward edges in reverse from goal */
+    ContractionFrontier* frontiers[2] = {&m_ContractionFrontiers[0], &m_ContractionFrontiers[1]};
+    uint32_t generation = m_ContractionGeneration;
+
+    OpenContractionNode(*frontiers[0], generation, startNode, ContractionHierarchy::InvalidNode, 0);
+    OpenContractionNode(*frontiers[1], generation, goalNode, ContractionHierarchy::InvalidNode, 0);
+
+    PathCost bestCost = INT32_MAX;
+    int32_t meetingNode = ContractionHierarchy::InvalidNode;
+    size_t nodesExpanded = 0;
+
+    while (true)
+    {
+        /* Direction is done once its cheapest open node can not improve best meeting */
+        int32_t direction = -1;
+
+        for (int32_t i = 0; i < 2; ++i)
+        {
+            const std::vector<ContractionEntry>& openList = frontiers[i]->OpenList;
+            if (!openList.empty() && openList.front().first < bestCost &&
+                (direction < 0 || openList.front().first < frontiers[direction]->OpenList.front().first))
+            {
+                direction = i;
+            }
+        }
+
+        if (direction < 0)
+        {
+            break;
+        }
+
+        ContractionFrontier& frontier = *frontiers[direction];
+        const ContractionFrontier& opposite = *frontiers[1 - direction];
+        bool bBackward = direction == 1;
+
+        std::pop_heap(frontier.OpenList.begin(), frontier.OpenList.end(), std::greater<ContractionEntry>());
+        auto [currentCost, currentNode] = frontier.OpenList.back();
+        frontier.OpenList.pop_back();
+
+        if (currentCost != frontier.Records[currentNode].Cost)
+        {
+            continue;
+        }
+
+        ++nodesExpanded;
+
+        PathCost oppositeCost = GetContractionCost(opposite, generation, currentNode);
+        if (oppositeCost != INT32_MAX && currentCost + oppositeCost < bestCost)
+        {
+            bestCost = currentCost + oppositeCost;
+            meetingNode = currentNode;
+        }
+
+        /* Stall on demand: node reached cheaper from above lies on no shortest path leading upwards */
+        std::span<const ContractionHierarchy::Edge> stallEdges = bBackward ?
+            hierarchy.GetUpwardEdges(currentNode) : hierarchy.GetDownwardEdges(currentNode);
+
+        bool bStalled = std::any_of(stallEdges.begin(), stallEdges.end(), [&](const ContractionHierarchy::Edge& edge)
+        {
+            PathCost cost = GetContractionCost(frontier, generation, edge.Target);
+            return cost != INT32_MAX && cost + edge.Cost < currentCost;
+        });
+
+        if (bStalled)
+        {
+            continue;
+        }
+
+        std::span<const ContractionHierarchy::Edge> edges = bBackward ?
+            hierarchy.GetDownwardEdges(currentNode) : hierarchy.GetUpwardEdges(currentNode);
+
+        for (const ContractionHierarchy::Edge& edge : edges)
+        {
+            OpenContractionNode(frontier, generation, edge.Target, currentNode, currentCost + edge.Cost);
+        }
+    }
+
+    if (meetingNode == ContractionHierarchy::InvalidNode)
+    {
+        return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+    }
+
+    /* Collect nodes of both search trees from start to goal, then unpack shortcuts between them */
+    std::vector<int32_t> nodes;
+    for (int32_t node = meetingNode; node != ContractionHierarchy::InvalidNode; node = frontiers[0]->Records[node].Parent)
+    {
+        nodes.push_back(node);
+    }
+
+    std::reverse(nodes.begin(), nodes.end());
+
+    for (int32_t node = frontiers[1]->Records[meetingNode].Parent; node != ContractionHierarchy::InvalidNode;
+        node = frontiers[1]->Records[node].Parent)
+    {
+        nodes.push_back(node);
+    }
+
+    Path path{start};
+
+    for (size_t i = 1; i < nodes.size(); ++i)
+    {
+        int32_t from = nodes[i - 1];
+        int32_t to = nodes[i];
+
+        /* Edge is stored at whichever end was contracted first */
+        const ContractionHierarchy::Edge* edge = from < to ?
+            hierarchy.FindEdge(hierarchy.GetUpwardEdges(from), to) : hierarchy.FindEdge(hierarchy.GetDownwardEdges(to), from);
+
+        if (!edge || !hierarchy.UnpackEdge(from, to, edge->Middle, path))
+        {
+            return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::Found, std::move(path), nodesExpanded};
+}
+
+void PathFinder::StartContractionSession(size_t numNodes)
+{
+    for (ContractionFrontier& frontier : m_ContractionFrontiers)
+    {
+        frontier.OpenList.clear();
+
+        if (frontier.Records.size() != numNodes)
+        {
+            frontier.Records.assign(numNodes, ContractionRecord{});
+            m_ContractionGeneration = 0;
+        }
+    }
+
+    /* Same wrap around handling as in StartNewPathFindingSession */
+    if (++m_ContractionGeneration == 0)
+    {
+        for (ContractionFrontier& frontier : m_ContractionFrontiers)
+        {
+            std::fill(frontier.Records.begin(), frontier.Records.end(), ContractionRecord{});
+        }
+
+        m_ContractionGeneration = 1;
+    }
+}
@@ -0,0 +1,429 @@
+#include "DStarLite.h"
+
+#include "AStarPriorityQueue.h"
+#include "MapChangeLog.h"
+#include "Neighborhood.h"
+
+#include <algorithm>
+#include <climits>
+
+constexpr int32_t InfiniteCost = INT32_MAX / 4;
+
+static int32_t AddCosts(int32_t a, int32_t b)
+{
+    return (a >= InfiniteCost || b >= InfiniteCost) ? InfiniteCost : a + b;
+}
+
+void DStarLite::Initialize(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    m_Width = map.GetMapWidth();
+    m_Height = map.GetMapHeight();
+    m_Revision = map.GetRevision();
+    m_Start = start;
+    m_Goal = goal;
+    m_KeyModifier = 0;
+
+    size_t numCells = static_cast<size_t>(m_Width) * m_Height;
+    m_CostToGoal.assign(numCells, InfiniteCost);
+    m_Lookahead.assign(numCells, InfiniteCost);
+    m_HeapIndices.assign(numCells, InvalidHeapIndex);
+    m_Heap.clear();
+
+    m_StepCosts.resize(numCells);
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        for (int32_t x = 0; x < m_Width; ++x)
+        {
+            m_StepCosts[GetCellIndex({x, y})] = IsWalkable({x, y}, &map) ? map.GetTerrainCost({x, y}) : 0;
+        }
+    }
+
+    m_LastNumExpanded = 0;
+
+    if (!IsInside(start) || !IsInside(goal))
+    {
+        return;
+    }
+
+    int32_t goalIndex = GetCellIndex(goal);
+    m_Lookahead[goalIndex] = 0;
+    HeapPush(goalIndex, CalculateKey(goalIndex));
+
+    ComputeShortestPath();
+}
+
+void DStarLite::Replan(const IMap& map, PathFindingPoint start)
+{
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        Initialize(map, start, m_Goal);
+        return;
+    }
+
+    m_Revision = map.GetRevision();
+    m_LastNumExpanded = 0;
+
+    if (!IsInside(start) || !IsInside(m_Goal))
+    {
+        m_Start = start;
+        return;
+    }
+
+    /* Keys already in queue were computed for old start, instead of
+       recomputing all of them lower bound of new keys is raised */
+    m_KeyModifier += ManhattanHeuristic::Evaluate(m_Start, start);
+    m_Start = start;
+
+    for (glm::ivec2 position : m_Changes)
+    {
+        uint8_t stepCost = IsWalkable(position, &map) ? map.GetTerrainCost(position) : 0;
+        uint8_t& currentStepCost = m_StepCosts[GetCellIndex(position)];
+
+        if (stepCost != currentStepCost)
+        {
+            uint8_t oldStepCost = currentStepCost;
+            currentStepCost = stepCost;
+            OnStepCostChanged(position, oldStepCost);
+        }
+    }
+
+    ComputeShortestPath();
+}
+
+CompactPath DStarLite::ExtractPath() const
+{
+    if (!IsInitialized() || !IsInside(m_Start) || m_Lookahead[GetCellIndex(m_Start)] >= InfiniteCost)
+    {
+        return {};
+    }
+
+    CompactPath path;
+    path.push_back(m_Start);
+
+    PathFindingPoint current = m_Start;
+    size_t maxLength = m_CostToGoal.size();
+
+    while (current != m_Goal && path.size() <= maxLength)
+    {
+        PathFindingPoint neighbors[4] = {
+            {current.x - 1, current.y},
+            {current.x + 1, current.y},
+            {current.x, current.y - 1},
+            {current.x, current.y + 1}
+        };
+
+        PathFindingPoint bestNeighbor = current;
+        int32_t bestCost = InfiniteCost;
+
+        for (PathFindingPoint neighbor : neighbors)
+        {
+            if (!IsInside(neighbor))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = GetCellIndex(neighbor);
+            int32_t cost = AddCosts(GetStepCost(neighborIndex), m_CostToGoal[neighborIndex]);
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestNeighbor = neighbor;
+            }
+        }
+
+        if (bestCost >= InfiniteCost)
+        {
+            return {};
+        }
+
+        current = bestNeighbor;
+        path.push_back(current);
+    }
+
+    if (current != m_Goal)
+    {
+        return {};
+    }
+
+    path.shrink_to_fit();
+    return path;
+}
+
+bool DStarLite::IsInitialized() const
+{
+    return !m_CostToGoal.empty();
+}
+
+PathFindingPoint DStarLite::GetGoal() const
+{
+    return m_Goal;
+}
+
+size_t DStarLite::GetLastNumExpanded() const
+{
+    return m_LastNumExpanded;
+}
+
+int32_t DStarLite::GetStepCost(int32_t toCell) const
+{
+    return m_StepCosts[toCell] != 0 ? m_StepCosts[toCell] : InfiniteCost;
+}
+
+DStarLite::Key DStarLite::CalculateKey(int32_t cell) const
+{
+    int32_t cost = std::min(m_CostToGoal[cell], m_Lookahead[cell]);
+    return {AddCosts(cost, ManhattanHeuristic::Evaluate(m_Start, GetCellPoint(cell)) + m_KeyModifier), cost};
+}
+
+int32_t DStarLite::GetBestLookahead(int32_t cell) const
+{
+    PathFindingPoint point = GetCellPoint(cell);
+    PathFindingPoint neighbors[4] = {
+        {point.x - 1, point.y},
+        {point.x + 1, point.y},
+        {point.x, point.y - 1},
+        {point.x, point.y + 1}
+    };
+
+    int32_t best = InfiniteCost;
+    for (PathFindingPoint neighbor : neighbors)
+    {
+        if (IsInside(neighbor))
+        {
+            int32_t neighborIndex = GetCellIndex(neighbor);
+            best = std::min(best, AddCosts(GetStepCost(neighborIndex), m_CostToGoal[neighborIndex]));
+        }
+    }
+
+    return best;
+}
+
+void DStarLite::UpdateVertex(int32_t cell)
+{
+    bool bConsistent = m_CostToGoal[cell] == m_Lookahead[cell];
+    bool bQueued = m_HeapIndices[cell] != InvalidHeapIndex;
+
+    if (!bConsistent && bQueued)
+    {
+        HeapUpdate(cell, CalculateKey(cell));
+    }
+    else if (!bConsistent)
+    {
+        HeapPush(cell, CalculateKey(cell));
+    }
+    else if (bQueued)
+    {
+        HeapRemove(cell);
+    }
+}
+
+void DStarLite::OnStepCostChanged(PathFindingPoint point, uint8_t oldStepCost)
+{
+    /* Cost of edge depends only on cell it enters, so changed cell alters
+       outgoing edges of its neighbors */
+    int32_t changedIndex = GetCellIndex(point);
+    int32_t oldEdgeCost = oldStepCost != 0 ? oldStepCost : InfiniteCost;
+    int32_t newEdgeCost = GetStepCost(changedIndex);
+    int32_t goalIndex = GetCellIndex(m_Goal);
+
+    PathFindingPoint neighbors[4] = {
+        {point.x - 1, point.y},
+        {point.x + 1, point.y},
+        {point.x, point.y - 1},
+        {point.x, point.y + 1}
+    };
+
+    for (PathFindingPoint neighbor : neighbors)
+    {
+        if (!IsInside(neighbor))
+        {
+            continue;
+        }
+
+        int32_t neighborIndex = GetCellIndex(neighbor);
+        if (neighborIndex != goalIndex)
+        {
+            if (newEdgeCost < oldEdgeCost)
+            {
+                m_Lookahead[neighborIndex] = std::min(m_Lookahead[neighborIndex], AddCosts(newEdgeCost, m_CostToGoal[changedIndex]));
+            }
+            else if (m_Lookahead[neighborIndex] == AddCosts(oldEdgeCost, m_CostToGoal[changedIndex]))
+            {
+                m_Lookahead[neighborIndex] = GetBestLookahead(neighborIndex);
+            }
+        }
+
+        UpdateVertex(neighborIndex);
+    }
+}
+
+void DStarLite::ComputeShortestPath()
+{
+    int32_t startIndex = GetCellIndex(m_Start);
+    int32_t goalIndex = GetCellIndex(m_Goal);
+
+    while (!m_Heap.empty() &&
+        (m_Heap[0].EntryKey < CalculateKey(startIndex) || m_Lookahead[startIndex] > m_CostToGoal[startIndex]))
+    {
+        int32_t cell = m_Heap[0].Cell;
+        Key oldKey = m_Heap[0].EntryKey;
+        Key newKey = CalculateKey(cell);
+
+        if (oldKey < newKey)
+        {
+            HeapUpdate(cell, newKey);
+            continue;
+        }
+
+        ++m_LastNumExpanded;
+
+        PathFindingPoint point = GetCellPoint(cell);
+        PathFindingPoint neighbors[4] = {
+            {point.x - 1, point.y},
+            {point.x + 1, point.y},
+            {point.x, point.y - 1},
+            {point.x, point.y + 1}
+        };
+
+        int32_t stepCost = GetStepCost(cell);
+
+        if (m_CostToGoal[cell] > m_Lookahead[cell])
+        {
+            m_CostToGoal[cell] = m_Lookahead[cell];
+            HeapRemove(cell);
+
+            for (PathFindingPoint neighbor : neighbors)
+            {
+                if (!IsInside(neighbor))
+                {
+                    continue;
+                }
+
+                int32_t neighborIndex = GetCellIndex(neighbor);
+                if (neighborIndex != goalIndex)
+                {
+                    m_Lookahead[neighborIndex] = std::min(m_Lookahead[neighborIndex], AddCosts(stepCost, m_CostToGoal[cell]));
+                }
+
+                UpdateVertex(neighborIndex);
+            }
+        }
+        else
+        {
+            int32_t oldCost = m_CostToGoal[cell];
+            m_CostToGoal[cell] = InfiniteCost;
+
+            for (PathFindingPoint neighbor : neighbors)
+            {
+                if (!IsInside(neighbor))
+                {
+                    continue;
+                }
+
+                int32_t neighborIndex = GetCellIndex(neighbor);
+                if (neighborIndex != goalIndex && m_Lookahead[neighborIndex] == AddCosts(stepCost, oldCost))
+                {
+                    m_Lookahead[neighborIndex] = GetBestLookahead(neighborIndex);
+                }
+
+                UpdateVertex(neighborIndex);
+            }
+
+            if (cell != goalIndex)
+            {
+                m_Lookahead[cell] = GetBestLookahead(cell);
+            }
+
+            UpdateVertex(cell);
+        }
+    }
+}
+
+void DStarLite::HeapPush(int32_t cell, Key key)
+{
+    m_Heap.push_back({key, cell});
+    m_HeapIndices[cell] = static_cast<int32_t>(m_Heap.size() - 1);
+    HeapSiftUp(m_HeapIndices[cell]);
+}
+
+void DStarLite::HeapRemove(int32_t cell)
+{
+    int32_t index = m_HeapIndices[cell];
+    m_HeapIndices[cell] = InvalidHeapIndex;
+
+    HeapEntry last = m_Heap.back();
+    m_Heap.pop_back();
+
+    if (index == static_cast<int32_t>(m_Heap.size()))
+    {
+        return;
+    }
+
+    HeapPlace(last, index);
+    HeapSiftUp(index);
+    HeapSiftDown(m_HeapIndices[last.Cell]);
+}
+
+void DStarLite::HeapUpdate(int32_t cell, Key key)
+{
+    int32_t index = m_HeapIndices[cell];
+    m_Heap[index].EntryKey = key;
+    HeapSiftUp(index);
+    HeapSiftDown(m_HeapIndices[cell]);
+}
+
+void DStarLite::HeapSiftUp(int32_t index)
+{
+    HeapEntry entry = m_Heap[index];
+
+    while (index > 0)
+    {
+        int32_t parent = (index - 1) / 2;
+        if (!(entry.EntryKey < m_Heap[parent].EntryKey))
+        {
+            break;
+        }
+
+        HeapPlace(m_Heap[parent], index);
+        index = parent;
+    }
+
+    HeapPlace(entry, index);
+}
+
+void DStarLite::HeapSiftDown(int32_t index)
+{
+    HeapEntry entry = m_Heap[index];
+    int32_t size = static_cast<int32_t>(m_Heap.size());
+
+    while (true)
+    {
+        int32_t child = 2 * index + 1;
+        if (child >= size)
+        {
+            break;
+        }
+
+        if (child + 1 < size && m_Heap[child + 1].EntryKey < m_Heap[child].EntryKey)
+        {
+            ++child;
+        }
+
+        if (!(m_Heap[child].EntryKey < entry.EntryKey))
+        {
+            break;
+        }
+
+        HeapPlace(m_Heap[child], index);
+        index = child;
+    }
+
+    HeapPlace(entry, index);
+}
+
+void DStarLite::HeapPlace(HeapEntry entry, int32_t index)
+{
+    m_Heap[index] = entry;
+    m_HeapIndices[entry.Cell] = index;
+}
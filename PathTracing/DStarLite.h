@@ -0,0 +1,97 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "CompactPath.h"
+
+#include <vector>
+
+/* Incremental planner (D* Lite) for single agent. Search runs backwards from
+   goal, so when agent moves or cells change only part of search affected by
+   them is repaired instead of searching again from scratch. Map changes are
+   read from map change log, planner falls back to full search only when log
+   does not reach back to its last update */
+class DStarLite
+{
+public:
+    void Initialize(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+
+    /* Moves start to agent position and repairs search after map edits made since last call */
+    void Replan(const IMap& map, PathFindingPoint start);
+
+    /* Follows cheapest successors from start to goal, returns empty path when goal is unreachable */
+    CompactPath ExtractPath() const;
+
+    bool IsInitialized() const;
+    PathFindingPoint GetGoal() const;
+
+    /* Number of cells expanded by last Initialize or Replan */
+    size_t GetLastNumExpanded() const;
+
+private:
+    struct Key
+    {
+        int32_t Primary;
+        int32_t Secondary;
+
+        bool operator<(const Key& other) const
+        {
+            return Primary != other.Primary ? Primary < other.Primary : Secondary < other.Secondary;
+        }
+    };
+
+    struct HeapEntry
+    {
+        Key EntryKey;
+        int32_t Cell;
+    };
+
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+    uint64_t m_Revision = 0;
+
+    PathFindingPoint m_Start{0, 0};
+    PathFindingPoint m_Goal{0, 0};
+    int32_t m_KeyModifier = 0;
+
+    std::vector<int32_t> m_CostToGoal;
+    std::vector<int32_t> m_Lookahead;
+    /* Terrain cost of every cell as seen by planner, zero when cell is not walkable */
+    std::vector<uint8_t> m_StepCosts;
+
+    std::vector<HeapEntry> m_Heap;
+    std::vector<int32_t> m_HeapIndices;
+
+    std::vector<glm::ivec2> m_Changes;
+    size_t m_LastNumExpanded = 0;
+
+private:
+    int32_t GetCellIndex(PathFindingPoint point) const
+    {
+        return point.x + point.y * m_Width;
+    }
+
+    PathFindingPoint GetCellPoint(int32_t cellIndex) const
+    {
+        return {cellIndex % m_Width, cellIndex / m_Width};
+    }
+
+    bool IsInside(PathFindingPoint point) const
+    {
+        return point.x >= 0 && point.x < m_Width && point.y >= 0 && point.y < m_Height;
+    }
+
+    int32_t GetStepCost(int32_t toCell) const;
+    Key CalculateKey(int32_t cell) const;
+    int32_t GetBestLookahead(int32_t cell) const;
+
+    void UpdateVertex(int32_t cell);
+    void OnStepCostChanged(PathFindingPoint point, uint8_t oldStepCost);
+    void ComputeShortestPath();
+
+    void HeapPush(int32_t cell, Key key);
+    void HeapRemove(int32_t cell);
+    void HeapUpdate(int32_t cell, Key key);
+    void HeapSiftUp(int32_t index);
+    void HeapSiftDown(int32_t index);
+    void HeapPlace(HeapEntry entry, int32_t index);
+};
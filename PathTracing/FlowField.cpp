@@ -0,0 +1,332 @@
+#include "FlowField.h"
+#include "MapChangeLog.h"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+constexpr PathCost UnreachableCost = INT32_MAX;
+constexpr int32_t InvalidNextCell = -1;
+
+static const glm::ivec2 NeighborOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+void FlowField::Build(const IMap& map, PathFindingPoint goal)
+{
+    m_Width = map.GetMapWidth();
+    m_Height = map.GetMapHeight();
+    m_Revision = map.GetRevision();
+    m_Goal = goal;
+
+    size_t numCells = static_cast<size_t>(m_Width) * m_Height;
+    m_CostToGoal.assign(numCells, UnreachableCost);
+    m_NextCells.assign(numCells, InvalidNextCell);
+    m_Heap.clear();
+
+    m_StepCosts.resize(numCells);
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        for (int32_t x = 0; x < m_Width; ++x)
+        {
+            m_StepCosts[GetCellIndex({x, y})] = GetStepCost(map, {x, y});
+        }
+    }
+
+    m_LastNumSettled = 0;
+
+    if (!IsInside(goal) || m_StepCosts[GetCellIndex(goal)] == 0)
+    {
+        return;
+    }
+
+    m_CostToGoal[GetCellIndex(goal)] = 0;
+    Push(GetCellIndex(goal));
+    PropagateCosts();
+}
+
+void FlowField::Update(const IMap& map)
+{
+    if (m_Revision == map.GetRevision())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        Build(map, m_Goal);
+        return;
+    }
+
+    m_Revision = map.GetRevision();
+    m_LastNumSettled = 0;
+    m_Invalidated.clear();
+
+    /* Lowered cells are kept aside, until costs depending on raised ones are cleared */
+    std::vector<int32_t> loweredCells;
+
+    for (glm::ivec2 position : m_Changes)
+    {
+        int32_t cell = GetCellIndex(position);
+        uint8_t oldStepCost = m_StepCosts[cell];
+        uint8_t newStepCost = GetStepCost(map, position);
+
+        /* Agents walking around change field type, but not step cost */
+        if (oldStepCost == newStepCost)
+        {
+            continue;
+        }
+
+        m_StepCosts[cell] = newStepCost;
+
+        if (newStepCost == 0 || (oldStepCost != 0 && newStepCost > oldStepCost))
+        {
+            /* Every cell whose cheapest path enters this one may now have to go around it */
+            InvalidateDependents(cell);
+        }
+        else
+        {
+            loweredCells.push_back(cell);
+        }
+    }
+
+    int32_t goalIndex = GetCellIndex(m_Goal);
+
+    for (int32_t cell : m_Invalidated)
+    {
+        if (m_StepCosts[cell] == 0)
+        {
+            continue;
+        }
+
+        if (cell == goalIndex)
+        {
+            m_CostToGoal[cell] = 0;
+            Push(cell);
+        }
+        else if (UpdateFromNeighbors(cell))
+        {
+            Push(cell);
+        }
+    }
+
+    /* Lowered cell gets cheaper to enter, so it is pushed to relax its neighbors even when its own cost stays */
+    for (int32_t cell : loweredCells)
+    {
+        if (m_StepCosts[cell] == 0)
+        {
+            continue;
+        }
+
+        if (cell == goalIndex)
+        {
+            m_CostToGoal[cell] = 0;
+            Push(cell);
+        }
+        else if (UpdateFromNeighbors(cell) || m_CostToGoal[cell] != UnreachableCost)
+        {
+            Push(cell);
+        }
+    }
+
+    PropagateCosts();
+}
+
+PathFindingPoint FlowField::GetNextStep(PathFindingPoint point) const
+{
+    if (!IsInside(point))
+    {
+        return point;
+    }
+
+    int32_t next = m_NextCells[GetCellIndex(point)];
+    return next == InvalidNextCell ? point : GetCellPoint(next);
+}
+
+CompactPath FlowField::ExtractPath(PathFindingPoint point) const
+{
+    if (!IsReachable(point))
+    {
+        return {};
+    }
+
+    CompactPath path;
+    path.push_back(point);
+
+    while (point != m_Goal)
+    {
+        point = GetNextStep(point);
+        path.push_back(point);
+    }
+
+    path.shrink_to_fit();
+    return path;
+}
+
+bool FlowField::IsReachable(PathFindingPoint point) const
+{
+    return IsInside(point) && m_CostToGoal[GetCellIndex(point)] != UnreachableCost;
+}
+
+PathFindingPoint FlowField::GetGoal() const
+{
+    return m_Goal;
+}
+
+size_t FlowField::GetLastNumSettled() const
+{
+    return m_LastNumSettled;
+}
+
+bool FlowField::UpdateFromNeighbors(int32_t cell)
+{
+    PathFindingPoint point = GetCellPoint(cell);
+    bool bImproved = false;
+
+    for (glm::ivec2 offset : NeighborOffsets)
+    {
+        PathFindingPoint neighbor = point + offset;
+        if (!IsInside(neighbor))
+        {
+            continue;
+        }
+
+        int32_t neighborIndex = GetCellIndex(neighbor);
+        if (m_StepCosts[neighborIndex] == 0 || m_CostToGoal[neighborIndex] == UnreachableCost)
+        {
+            continue;
+        }
+
+        PathCost cost = m_CostToGoal[neighborIndex] + m_StepCosts[neighborIndex];
+        if (cost < m_CostToGoal[cell])
+        {
+            m_CostToGoal[cell] = cost;
+            m_NextCells[cell] = neighborIndex;
+            bImproved = true;
+        }
+    }
+
+    return bImproved;
+}
+
+void FlowField::InvalidateDependents(int32_t cell)
+{
+    /* Cells pointing at cell form subtree of cheapest paths, walk it breadth first */
+    size_t head = m_Invalidated.size();
+
+    if (m_CostToGoal[cell] == UnreachableCost && m_NextCells[cell] == InvalidNextCell && cell != GetCellIndex(m_Goal))
+    {
+        return;
+    }
+
+    m_CostToGoal[cell] = UnreachableCost;
+    m_NextCells[cell] = InvalidNextCell;
+    m_Invalidated.push_back(cell);
+
+    while (head < m_Invalidated.size())
+    {
+        PathFindingPoint point = GetCellPoint(m_Invalidated[head++]);
+
+        for (glm::ivec2 offset : NeighborOffsets)
+        {
+            PathFindingPoint neighbor = point + offset;
+            if (!IsInside(neighbor))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = GetCellIndex(neighbor);
+            if (m_NextCells[neighborIndex] == GetCellIndex(point))
+            {
+                m_CostToGoal[neighborIndex] = UnreachableCost;
+                m_NextCells[neighborIndex] = InvalidNextCell;
+                m_Invalidated.push_back(neighborIndex);
+            }
+        }
+    }
+}
+
+void FlowField::Push(int32_t cell)
+{
+    m_Heap.push_back({m_CostToGoal[cell], cell});
+    std::push_heap(m_Heap.begin(), m_Heap.end(), std::greater<HeapEntry>());
+}
+
+void FlowField::PropagateCosts()
+{
+    /* Dijkstra with lazy deletion, entries whose cost no longer matches cell are stale */
+    while (!m_Heap.empty())
+    {
+        std::pop_heap(m_Heap.begin(), m_Heap.end(), std::greater<HeapEntry>());
+        HeapEntry entry = m_Heap.back();
+        m_Heap.pop_back();
+
+        if (entry.Cost != m_CostToGoal[entry.Cell])
+        {
+            continue;
+        }
+
+        ++m_LastNumSettled;
+        PathFindingPoint point = GetCellPoint(entry.Cell);
+        PathCost costThroughCell = entry.Cost + m_StepCosts[entry.Cell];
+
+        for (glm::ivec2 offset : NeighborOffsets)
+        {
+            PathFindingPoint neighbor = point + offset;
+            if (!IsInside(neighbor))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = GetCellIndex(neighbor);
+            if (m_StepCosts[neighborIndex] != 0 && costThroughCell < m_CostToGoal[neighborIndex])
+            {
+                m_CostToGoal[neighborIndex] = costThroughCell;
+                m_NextCells[neighborIndex] = entry.Cell;
+                Push(neighborIndex);
+            }
+        }
+    }
+}
+
+FlowFieldSubscription::~FlowFieldSubscription() noexcept
+{
+    Unsubscribe();
+}
+
+FlowFieldSubscription::FlowFieldSubscription(FlowFieldSubscription&& other) noexcept :
+    m_Goal(other.m_Goal),
+    m_bSubscribed(other.m_bSubscribed)
+{
+    other.m_bSubscribed = false;
+}
+
+FlowFieldSubscription& FlowFieldSubscription::operator=(FlowFieldSubscription&& other) noexcept
+{
+    if (this != &other)
+    {
+        Unsubscribe();
+        m_Goal = other.m_Goal;
+        m_bSubscribed = other.m_bSubscribed;
+        other.m_bSubscribed = false;
+    }
+
+    return *this;
+}
+
+void FlowFieldSubscription::Subscribe(PathFindingPoint goal)
+{
+    /* Subscribe first, so field of goal shared with itself is not dropped and built again */
+    PathFindingAlgorithm::SubscribeToGoal(goal);
+    Unsubscribe();
+
+    m_Goal = goal;
+    m_bSubscribed = true;
+}
+
+void FlowFieldSubscription::Unsubscribe()
+{
+    if (m_bSubscribed)
+    {
+        PathFindingAlgorithm::UnsubscribeFromGoal(m_Goal);
+        m_bSubscribed = false;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "CompactPath.h"
+
+#include <vector>
+
+/* Direction field of single goal on 4-connected grid, computed by one
+   Dijkstra search run backwards from goal. Every cell stores its cost to
+   goal and next cell on cheapest path, so any number of agents can walk to
+   goal with single lookup per step. Only obstacles block field, agents
+   standing in the way do not change it. Field follows map edits through
+   Update, repairing only costs affected by edited cells */
+class FlowField
+{
+public:
+    void Build(const IMap& map, PathFindingPoint goal);
+
+    /* Brings field up to date with map, rebuilding it fully only when map
+       size changed or its change log does not reach revision of field */
+    void Update(const IMap& map);
+
+    /* Neighbor to step on from point, point itself when it is goal or goal can not be reached from it */
+    PathFindingPoint GetNextStep(PathFindingPoint point) const;
+
+    /* Follows field from point, returns empty path when goal can not be reached from it */
+    CompactPath ExtractPath(PathFindingPoint point) const;
+
+    bool IsReachable(PathFindingPoint point) const;
+    PathFindingPoint GetGoal() const;
+
+    /* Number of cells settled by last Build or Update */
+    size_t GetLastNumSettled() const;
+
+private:
+    struct HeapEntry
+    {
+        PathCost Cost;
+        int32_t Cell;
+
+        bool operator>(const HeapEntry& other) const
+        {
+            return Cost > other.Cost;
+        }
+    };
+
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+    uint64_t m_Revision = 0;
+    PathFindingPoint m_Goal{0, 0};
+
+    std::vector<PathCost> m_CostToGoal;
+    std::vector<int32_t> m_NextCells;
+    /* Terrain cost of every cell as seen by field, zero for obstacles */
+    std::vector<uint8_t> m_StepCosts;
+
+    std::vector<HeapEntry> m_Heap;
+    std::vector<glm::ivec2> m_Changes;
+    std::vector<int32_t> m_Invalidated;
+    size_t m_LastNumSettled = 0;
+
+private:
+    int32_t GetCellIndex(PathFindingPoint point) const
+    {
+        return point.x + point.y * m_Width;
+    }
+
+    PathFindingPoint GetCellPoint(int32_t cellIndex) const
+    {
+        return {cellIndex % m_Width, cellIndex / m_Width};
+    }
+
+    bool IsInside(PathFindingPoint point) const
+    {
+        return point.x >= 0 && point.x < m_Width && point.y >= 0 && point.y < m_Height;
+    }
+
+    static uint8_t GetStepCost(const IMap& map, PathFindingPoint point)
+    {
+        return map.GetFieldAt(point) == EFieldType::Obstacle ? 0 : map.GetTerrainCost(point);
+    }
+
+    /* Sets cost of cell from its neighbors, returns false when none of them reaches goal */
+    bool UpdateFromNeighbors(int32_t cell);
+
+    void InvalidateDependents(int32_t cell);
+    void Push(int32_t cell);
+    void PropagateCosts();
+};
+
+/* Registers owner as agent heading to goal for as long as it lives. Goals
+   with at least FlowFieldMinSubscribers agents are given shared flow field */
+class FlowFieldSubscription
+{
+public:
+    FlowFieldSubscription() = default;
+    ~FlowFieldSubscription() noexcept;
+
+    FlowFieldSubscription(const FlowFieldSubscription&) = delete;
+    FlowFieldSubscription& operator=(const FlowFieldSubscription&) = delete;
+
+    FlowFieldSubscription(FlowFieldSubscription&& other) noexcept;
+    FlowFieldSubscription& operator=(FlowFieldSubscription&& other) noexcept;
+
+    /* Moves subscription to goal, dropping the previous one */
+    void Subscribe(PathFindingPoint goal);
+    void Unsubscribe();
+
+    bool IsSubscribed() const
+    {
+        return m_bSubscribed;
+    }
+
+private:
+    PathFindingPoint m_Goal{0, 0};
+    bool m_bSubscribed = false;
+};
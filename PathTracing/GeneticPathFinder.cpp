@@ -0,0 +1,432 @@
+#include "GeneticPathFinder.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+typedef std::chrono::steady_clock Clock;
+
+/* Weight of Manhattan distance to goal in score of walk that did not get there. Exceeds
+   largest terrain cost, so step towards goal always pays off */
+static constexpr int32_t DistanceWeight = 256;
+
+/* Walks of whole block are checked for being finished once per that many moves */
+static constexpr int32_t MovesPerFinishCheck = 16;
+
+/* Moves in order of genes, the same order as everywhere else on 4-connected grid */
+static const glm::ivec2 MoveOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+static uint64_t SplitMix64(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/* Xorshift generator, cheap enough to be drawn from for every gene */
+class RandomStream
+{
+public:
+    RandomStream(uint64_t seed, uint64_t generation, uint64_t block) :
+        m_State(SplitMix64(seed ^ SplitMix64(generation ^ SplitMix64(block))) | 1)
+    {
+    }
+
+    uint32_t Next()
+    {
+        m_State ^= m_State >> 12;
+        m_State ^= m_State << 25;
+        m_State ^= m_State >> 27;
+        return static_cast<uint32_t>((m_State * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    /* Uniform number in (0, 1] */
+    double NextUnit()
+    {
+        return (Next() + 1.0) / 4294967296.0;
+    }
+
+    /* Uniform number in [0, bound) */
+    uint32_t Below(uint32_t bound)
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(Next()) * bound) >> 32);
+    }
+
+private:
+    uint64_t m_State;
+};
+
+void GeneticPathFinder::SetSettings(const GeneticSettings& settings)
+{
+    m_Settings = settings;
+}
+
+const GeneticSettings& GeneticPathFinder::GetSettings() const
+{
+    return m_Settings;
+}
+
+PathFindingResult GeneticPathFinder::FindPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    WorkerPool& workerPool, GeneticStats* outStats)
+{
+    Clock::time_point startTime = Clock::now();
+    GeneticStats stats;
+
+    if (outStats)
+    {
+        *outStats = stats;
+    }
+
+    if (start == goal)
+    {
+        return {EPathFindingStatus::Found, {start}};
+    }
+
+    /* Population would only wander around, there is nothing to find */
+    if (!IsWalkable(goal, &map) || !map.AreConnected(start, goal))
+    {
+        return {EPathFindingStatus::NoPath};
+    }
+
+    LoadMap(map, start, goal);
+
+    int32_t blockSize = GeneticBlockSize;
+    int32_t numBlocks = std::max((m_Settings.PopulationSize + blockSize - 1) / blockSize, 1);
+    int32_t distance = std::abs(start.x - goal.x) + std::abs(start.y - goal.y);
+
+    m_PopulationSize = numBlocks * blockSize;
+    m_GenomeLength = m_Settings.GenomeLength > 0 ? m_Settings.GenomeLength : 3 * distance + 32;
+
+    size_t numGenes = static_cast<size_t>(m_PopulationSize) * m_GenomeLength;
+    m_Genes.assign(numGenes, 0);
+    m_NextGenes.assign(numGenes, 0);
+    m_Scores.assign(m_PopulationSize, INT32_MAX);
+    m_NextScores.assign(m_PopulationSize, INT32_MAX);
+    m_Ranking.resize(m_PopulationSize);
+
+    int32_t bestScore = INT32_MAX;
+    int32_t numStalled = 0;
+
+    for (int32_t generation = 0; generation < m_Settings.MaxGenerations; ++generation)
+    {
+        /* Breeding reads whole current generation, so every block writes only its part of the next one */
+        workerPool.ParallelFor(numBlocks, [&](uint32_t, size_t block)
+        {
+            if (generation == 0)
+            {
+                InitializeBlock(static_cast<int32_t>(block));
+            }
+            else
+            {
+                BreedBlock(static_cast<int32_t>(block), generation);
+            }
+
+            EvaluateBlock(static_cast<int32_t>(block));
+        });
+
+        m_Genes.swap(m_NextGenes);
+        m_Scores.swap(m_NextScores);
+        RankPopulation();
+
+        int32_t generationScore = m_Scores[m_Ranking[0]];
+        stats.BestScores.push_back(generationScore);
+        ++stats.Generations;
+
+        if (generationScore >= GeneticUnreachedPenalty)
+        {
+            continue;
+        }
+
+        if (stats.GoalReachedGeneration < 0)
+        {
+            stats.GoalReachedGeneration = generation;
+        }
+
+        /* Elites survive, so best score never gets worse */
+        numStalled = generationScore < bestScore ? 0 : numStalled + 1;
+        bestScore = std::min(bestScore, generationScore);
+
+        if (numStalled >= m_Settings.StallGenerations)
+        {
+            break;
+        }
+    }
+
+    PathFindingResult result;
+
+    if (stats.Generations > 0)
+    {
+        result.FoundPath = ExtractPath(m_Ranking[0], stats.FoundCost);
+    }
+
+    result.Status = result.FoundPath.empty() ? EPathFindingStatus::NoPath : EPathFindingStatus::Found;
+
+    stats.WallTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    stats.GenerationsPerSecond = stats.WallTimeMs > 0.0 ? stats.Generations * 1000.0 / stats.WallTimeMs : 0.0;
+
+    if (outStats)
+    {
+        *outStats = std::move(stats);
+    }
+
+    return result;
+}
+
+void GeneticPathFinder::LoadMap(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+
+    /* Border of blocked cells around map catches every move leaving it */
+    m_Stride = width + 2;
+    m_StepCosts.assign(static_cast<size_t>(m_Stride) * (height + 2), 0);
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            /* Agent may walk back over cell it starts from */
+            if (IsWalkable({x, y}, &map) || PathFindingPoint{x, y} == start)
+            {
+                m_StepCosts[(x + 1) + (y + 1) * m_Stride] = map.GetTerrainCost({x, y});
+            }
+        }
+    }
+
+    m_StartCell = (start.x + 1) + (start.y + 1) * m_Stride;
+    m_GoalCell = (goal.x + 1) + (goal.y + 1) * m_Stride;
+}
+
+void GeneticPathFinder::InitializeBlock(int32_t block)
+{
+    RandomStream random(m_Settings.Seed, 0, block);
+    int32_t first = block * GeneticBlockSize;
+
+    /* Half of initial moves head towards goal, which gives first generations walks worth breeding */
+    PathFindingPoint start = GetCellPoint(m_StartCell);
+    PathFindingPoint goal = GetCellPoint(m_GoalCell);
+    uint8_t horizontalMove = goal.x < start.x ? 0 : 1;
+    uint8_t verticalMove = goal.y < start.y ? 2 : 3;
+    uint32_t dx = std::abs(goal.x - start.x);
+    uint32_t dy = std::abs(goal.y - start.y);
+
+    for (int32_t gene = 0; gene < m_GenomeLength; ++gene)
+    {
+        uint8_t* genes = m_NextGenes.data() + static_cast<size_t>(gene) * m_PopulationSize + first;
+
+        for (int32_t i = 0; i < GeneticBlockSize; ++i)
+        {
+            if (random.Next() & 1)
+            {
+                genes[i] = random.Below(dx + dy) < dx ? horizontalMove : verticalMove;
+            }
+            else
+            {
+                genes[i] = static_cast<uint8_t>(random.Next() & 3);
+            }
+        }
+    }
+}
+
+void GeneticPathFinder::BreedBlock(int32_t block, int32_t generation)
+{
+    RandomStream random(m_Settings.Seed, generation, block);
+    int32_t first = block * GeneticBlockSize;
+    int32_t numElites = std::min(m_Settings.NumElites, m_PopulationSize);
+
+    auto tournament = [&]()
+    {
+        int32_t winner = random.Below(m_PopulationSize);
+
+        for (int32_t i = 1; i < m_Settings.TournamentSize; ++i)
+        {
+            int32_t rival = random.Below(m_PopulationSize);
+            if (m_Scores[rival] < m_Scores[winner] || (m_Scores[rival] == m_Scores[winner] && rival < winner))
+            {
+                winner = rival;
+            }
+        }
+
+        return winner;
+    };
+
+    /* One point crossover, child takes moves before cut from first parent and the rest from second one.
+       Elites are copied whole and never mutated */
+    int32_t firstParents[GeneticBlockSize];
+    int32_t secondParents[GeneticBlockSize];
+    int32_t cuts[GeneticBlockSize];
+
+    /* Gap between mutated genes is drawn from geometric distribution, so random number is drawn
+       per mutation instead of per gene */
+    int32_t nextMutations[GeneticBlockSize];
+    double mutationRate = std::clamp(static_cast<double>(m_Settings.MutationRate), 0.0, 1.0);
+    double logKeepRate = std::log1p(-std::min(mutationRate, 0.999999));
+
+    auto drawMutationGap = [&]()
+    {
+        if (mutationRate <= 0.0)
+        {
+            return m_GenomeLength;
+        }
+
+        return static_cast<int32_t>(std::min(std::log(random.NextUnit()) / logKeepRate, static_cast<double>(m_GenomeLength)));
+    };
+
+    for (int32_t i = 0; i < GeneticBlockSize; ++i)
+    {
+        int32_t child = first + i;
+
+        if (child < numElites)
+        {
+            firstParents[i] = secondParents[i] = m_Ranking[child];
+            cuts[i] = m_GenomeLength;
+            nextMutations[i] = m_GenomeLength;
+        }
+        else
+        {
+            firstParents[i] = tournament();
+            secondParents[i] = tournament();
+            cuts[i] = random.Below(m_GenomeLength + 1);
+            nextMutations[i] = drawMutationGap();
+        }
+    }
+
+    for (int32_t gene = 0; gene < m_GenomeLength; ++gene)
+    {
+        const uint8_t* parentGenes = m_Genes.data() + static_cast<size_t>(gene) * m_PopulationSize;
+        uint8_t* childGenes = m_NextGenes.data() + static_cast<size_t>(gene) * m_PopulationSize + first;
+
+        for (int32_t i = 0; i < GeneticBlockSize; ++i)
+        {
+            childGenes[i] = parentGenes[gene < cuts[i] ? firstParents[i] : secondParents[i]];
+        }
+
+        for (int32_t i = 0; i < GeneticBlockSize; ++i)
+        {
+            if (nextMutations[i] == gene)
+            {
+                childGenes[i] = static_cast<uint8_t>(random.Next() & 3);
+                nextMutations[i] += 1 + drawMutationGap();
+            }
+        }
+    }
+}
+
+void GeneticPathFinder::EvaluateBlock(int32_t block)
+{
+    int32_t first = block * GeneticBlockSize;
+    const int32_t offsets[4] = {-1, 1, -m_Stride, m_Stride};
+    const uint8_t* stepCosts = m_StepCosts.data();
+
+    /* Walks of whole block advance together, finished walks just stop adding cost */
+    int32_t cells[GeneticBlockSize];
+    int32_t costs[GeneticBlockSize];
+    int32_t active[GeneticBlockSize];
+
+    std::fill(std::begin(cells), std::end(cells), m_StartCell);
+    std::fill(std::begin(costs), std::end(costs), 0);
+    std::fill(std::begin(active), std::end(active), 1);
+
+    for (int32_t gene = 0; gene < m_GenomeLength; ++gene)
+    {
+        const uint8_t* genes = m_NextGenes.data() + static_cast<size_t>(gene) * m_PopulationSize + first;
+
+        for (int32_t i = 0; i < GeneticBlockSize; ++i)
+        {
+            int32_t next = cells[i] + offsets[genes[i] & 3];
+            int32_t stepCost = stepCosts[next] * active[i];
+
+            cells[i] = stepCost != 0 ? next : cells[i];
+            costs[i] += stepCost;
+            active[i] &= cells[i] != m_GoalCell;
+        }
+
+        if ((gene + 1) % MovesPerFinishCheck == 0 &&
+            std::all_of(std::begin(active), std::end(active), [](int32_t bActive) { return bActive == 0; }))
+        {
+            break;
+        }
+    }
+
+    PathFindingPoint goal = GetCellPoint(m_GoalCell);
+
+    for (int32_t i = 0; i < GeneticBlockSize; ++i)
+    {
+        int32_t score = costs[i];
+
+        if (cells[i] != m_GoalCell)
+        {
+            PathFindingPoint point = GetCellPoint(cells[i]);
+            score += GeneticUnreachedPenalty + DistanceWeight * (std::abs(point.x - goal.x) + std::abs(point.y - goal.y));
+        }
+
+        m_NextScores[first + i] = score;
+    }
+}
+
+void GeneticPathFinder::RankPopulation()
+{
+    int32_t numElites = std::clamp(m_Settings.NumElites, 1, m_PopulationSize);
+
+    /* Ties are broken by index, so ranking does not depend on order blocks finished in */
+    std::iota(m_Ranking.begin(), m_Ranking.end(), 0);
+    std::partial_sort(m_Ranking.begin(), m_Ranking.begin() + numElites, m_Ranking.end(), [this](int32_t a, int32_t b)
+    {
+        return m_Scores[a] != m_Scores[b] ? m_Scores[a] < m_Scores[b] : a < b;
+    });
+}
+
+Path GeneticPathFinder::ExtractPath(int32_t individual, PathCost& outCost) const
+{
+    Path path{GetCellPoint(m_StartCell)};
+    std::unordered_map<int32_t, size_t> indexOfCell{{m_StartCell, 0}};
+    int32_t cell = m_StartCell;
+
+    for (int32_t gene = 0; gene < m_GenomeLength && cell != m_GoalCell; ++gene)
+    {
+        uint8_t move = m_Genes[static_cast<size_t>(gene) * m_PopulationSize + individual] & 3;
+        int32_t next = cell + MoveOffsets[move].x + MoveOffsets[move].y * m_Stride;
+
+        if (m_StepCosts[next] == 0)
+        {
+            continue;
+        }
+
+        cell = next;
+
+        /* Walk came back to cell it visited before, everything walked since then is loop */
+        auto [found, bInserted] = indexOfCell.try_emplace(cell, path.size());
+        if (!bInserted)
+        {
+            for (size_t i = found->second + 1; i < path.size(); ++i)
+            {
+                PathFindingPoint point = path[i];
+                indexOfCell.erase((point.x + 1) + (point.y + 1) * m_Stride);
+            }
+
+            path.resize(found->second + 1);
+            continue;
+        }
+
+        path.push_back(GetCellPoint(cell));
+    }
+
+    if (cell != m_GoalCell)
+    {
+        outCost = -1;
+        return {};
+    }
+
+    outCost = 0;
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        outCost += m_StepCosts[(path[i].x + 1) + (path[i].y + 1) * m_Stride];
+    }
+
+    return path;
+}
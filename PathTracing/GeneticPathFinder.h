@@ -0,0 +1,117 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <vector>
+
+class WorkerPool;
+
+struct GeneticSettings
+{
+    /* Rounded up to whole blocks of GeneticBlockSize individuals */
+    int32_t PopulationSize = 1024;
+    int32_t MaxGenerations = 400;
+
+    /* Search ends once best path did not get cheaper for that many generations after reaching goal */
+    int32_t StallGenerations = 60;
+
+    /* Moves per individual, 0 picks three times Manhattan distance plus some slack */
+    int32_t GenomeLength = 0;
+
+    /* Best individuals copied unchanged into next generation */
+    int32_t NumElites = 8;
+    int32_t TournamentSize = 3;
+    float MutationRate = 0.02f;
+
+    /* Same seed and settings give the same path, however many workers evaluate population */
+    uint64_t Seed = 1;
+};
+
+struct GeneticStats
+{
+    int32_t Generations = 0;
+
+    /* First generation whose best individual reached goal, -1 when none did */
+    int32_t GoalReachedGeneration = -1;
+
+    double WallTimeMs = 0.0;
+    double GenerationsPerSecond = 0.0;
+
+    /* Score of best individual after every generation, lower is better.
+       Scores below GeneticUnreachedPenalty are costs of paths reaching goal */
+    std::vector<int32_t> BestScores;
+
+    /* Cost of returned path after loops were cut out, -1 when goal was not reached */
+    PathCost FoundCost = -1;
+
+    /* AStar answer to the same query, filled in by PathFindingAlgorithm::FindPathGenetic */
+    PathCost ReferenceCost = -1;
+    double ReferenceTimeMs = 0.0;
+};
+
+/* Individuals are evaluated and bred in blocks of that many, one block per work item */
+constexpr int32_t GeneticBlockSize = 64;
+
+/* Added to score of individual that did not reach goal */
+constexpr int32_t GeneticUnreachedPenalty = 1 << 24;
+
+/* Genetic algorithm searching 4-connected grid. Every individual is string
+   of moves walked from start, move into blocked cell is skipped and walk
+   stops at goal. Score is cost of walk, plus penalty and weighted distance
+   to goal when walk did not get there. Found walk has its loops cut out, so
+   returned path is valid but usually not the shortest one.
+
+   Population is stored gene major in one flat buffer, move g of individual i
+   at g * populationSize + i, so every block walks its individuals in lock
+   step over contiguous bytes. Walk uses cell indices of grid padded with
+   blocked border, so it needs no bounds checks. Blocks are evaluated and
+   bred in parallel on worker pool, and every block draws random numbers
+   from its own stream derived from seed, generation and block index */
+class GeneticPathFinder
+{
+public:
+    void SetSettings(const GeneticSettings& settings);
+    const GeneticSettings& GetSettings() const;
+
+    /* Uses all workers of pool, so it must not be called from one of them */
+    PathFindingResult FindPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal, WorkerPool& workerPool,
+        GeneticStats* outStats = nullptr);
+
+private:
+    GeneticSettings m_Settings;
+
+    /* Terrain cost of every cell of padded grid, zero for cells that can not be entered */
+    std::vector<uint8_t> m_StepCosts;
+    int32_t m_Stride = 0;
+    int32_t m_StartCell = 0;
+    int32_t m_GoalCell = 0;
+
+    int32_t m_PopulationSize = 0;
+    int32_t m_GenomeLength = 0;
+
+    /* Current and next generation, gene major */
+    std::vector<uint8_t> m_Genes;
+    std::vector<uint8_t> m_NextGenes;
+    std::vector<int32_t> m_Scores;
+    std::vector<int32_t> m_NextScores;
+
+    /* Individuals sorted by score, only first NumElites entries are ordered */
+    std::vector<int32_t> m_Ranking;
+
+private:
+    void LoadMap(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+    void InitializeBlock(int32_t block);
+    void BreedBlock(int32_t block, int32_t generation);
+
+    /* Scores block of next generation */
+    void EvaluateBlock(int32_t block);
+    void RankPopulation();
+
+    /* Walk of individual with loops cut out, empty when it does not reach goal */
+    Path ExtractPath(int32_t individual, PathCost& outCost) const;
+
+    PathFindingPoint GetCellPoint(int32_t cell) const
+    {
+        return {cell % m_Stride - 1, cell / m_Stride - 1};
+    }
+};
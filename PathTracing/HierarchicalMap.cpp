@@ -0,0 +1,478 @@
+#include "HierarchicalMap.h"
+#include "MapChangeLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+
+typedef std::chrono::steady_clock Clock;
+
+/* Entrances at least this wide get transition at both ends instead of single one in the middle */
+constexpr int32_t MinWideEntranceLength = 6;
+
+HierarchicalMap::HierarchicalMap(int32_t clusterSize) :
+    m_ClusterSize(clusterSize)
+{
+}
+
+void HierarchicalMap::Build(const IMap& map)
+{
+    Clock::time_point start = Clock::now();
+
+    m_Width = map.GetMapWidth();
+    m_Height = map.GetMapHeight();
+    m_NumClustersX = (m_Width + m_ClusterSize - 1) / m_ClusterSize;
+    m_NumClustersY = (m_Height + m_ClusterSize - 1) / m_ClusterSize;
+
+    m_StepCosts.resize(static_cast<size_t>(m_Width) * m_Height);
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        for (int32_t x = 0; x < m_Width; ++x)
+        {
+            m_StepCosts[GetCellIndex({x, y})] = GetStepCost(map, {x, y});
+        }
+    }
+
+    m_Nodes.clear();
+    m_ClusterNodes.assign(static_cast<size_t>(m_NumClustersX) * m_NumClustersY, {});
+
+    for (int32_t clusterY = 0; clusterY < m_NumClustersY; ++clusterY)
+    {
+        for (int32_t clusterX = 0; clusterX < m_NumClustersX; ++clusterX)
+        {
+            CreateBorderEntrances(clusterX, clusterY, false);
+            CreateBorderEntrances(clusterX, clusterY, true);
+        }
+    }
+
+    int32_t numClusters = static_cast<int32_t>(m_ClusterNodes.size());
+    for (int32_t i = 0; i < numClusters; ++i)
+    {
+        RebuildClusterNodes(i);
+    }
+
+    for (int32_t i = 0; i < numClusters; ++i)
+    {
+        RebuildIntraEdges(i);
+    }
+
+    m_Revision = map.GetRevision();
+    m_LastUpdateTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    m_LastUpdateNumClusters = numClusters;
+}
+
+void HierarchicalMap::Update(const IMap& map)
+{
+    if (m_Revision == map.GetRevision() && IsBuilt())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        Build(map);
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+    m_Revision = map.GetRevision();
+
+    size_t numClusters = m_ClusterNodes.size();
+    std::vector<uint8_t> dirtyClusters(numClusters, 0);
+    std::vector<uint8_t> dirtyRightBorders(numClusters, 0);
+    std::vector<uint8_t> dirtyTopBorders(numClusters, 0);
+
+    for (glm::ivec2 position : m_Changes)
+    {
+        uint8_t stepCost = GetStepCost(map, position);
+        uint8_t& oldStepCost = m_StepCosts[GetCellIndex(position)];
+
+        if (stepCost == oldStepCost)
+        {
+            continue;
+        }
+
+        oldStepCost = stepCost;
+
+        int32_t clusterX = position.x / m_ClusterSize;
+        int32_t clusterY = position.y / m_ClusterSize;
+        int32_t localX = position.x % m_ClusterSize;
+        int32_t localY = position.y % m_ClusterSize;
+
+        dirtyClusters[GetClusterIndex(position)] = 1;
+
+        /* Cell lying on cluster edge may change entrances of that border */
+        if (localX == 0 && clusterX > 0)
+        {
+            dirtyRightBorders[clusterX - 1 + clusterY * m_NumClustersX] = 1;
+        }
+
+        if (localX == m_ClusterSize - 1 && clusterX + 1 < m_NumClustersX)
+        {
+            dirtyRightBorders[clusterX + clusterY * m_NumClustersX] = 1;
+        }
+
+        if (localY == 0 && clusterY > 0)
+        {
+            dirtyTopBorders[clusterX + (clusterY - 1) * m_NumClustersX] = 1;
+        }
+
+        if (localY == m_ClusterSize - 1 && clusterY + 1 < m_NumClustersY)
+        {
+            dirtyTopBorders[clusterX + clusterY * m_NumClustersX] = 1;
+        }
+    }
+
+    /* Clusters on other side of changed border get new set of nodes too */
+    for (size_t i = 0; i < numClusters; ++i)
+    {
+        int32_t clusterX = static_cast<int32_t>(i) % m_NumClustersX;
+        int32_t clusterY = static_cast<int32_t>(i) / m_NumClustersX;
+
+        if (dirtyRightBorders[i])
+        {
+            RemoveBorderEntrances(clusterX, clusterY, false);
+            dirtyClusters[i] = 1;
+            dirtyClusters[i + 1] = 1;
+        }
+
+        if (dirtyTopBorders[i])
+        {
+            RemoveBorderEntrances(clusterX, clusterY, true);
+            dirtyClusters[i] = 1;
+            dirtyClusters[i + m_NumClustersX] = 1;
+        }
+    }
+
+    for (size_t i = 0; i < numClusters; ++i)
+    {
+        int32_t clusterX = static_cast<int32_t>(i) % m_NumClustersX;
+        int32_t clusterY = static_cast<int32_t>(i) / m_NumClustersX;
+
+        if (dirtyRightBorders[i])
+        {
+            CreateBorderEntrances(clusterX, clusterY, false);
+        }
+
+        if (dirtyTopBorders[i])
+        {
+            CreateBorderEntrances(clusterX, clusterY, true);
+        }
+    }
+
+    m_LastUpdateNumClusters = 0;
+
+    for (size_t i = 0; i < numClusters; ++i)
+    {
+        if (dirtyClusters[i])
+        {
+            RebuildClusterNodes(static_cast<int32_t>(i));
+        }
+    }
+
+    for (size_t i = 0; i < numClusters; ++i)
+    {
+        if (dirtyClusters[i])
+        {
+            RebuildIntraEdges(static_cast<int32_t>(i));
+            ++m_LastUpdateNumClusters;
+        }
+    }
+
+    m_LastUpdateTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const std::vector<HierarchicalMap::Edge>* HierarchicalMap::GetEdges(int32_t cellIndex) const
+{
+    auto it = m_Nodes.find(cellIndex);
+    return it != m_Nodes.end() ? &it->second.Edges : nullptr;
+}
+
+void HierarchicalMap::GetEdgesInsideCluster(PathFindingPoint point, bool bReversed, std::vector<Edge>& outEdges,
+    const PathFindingPoint* extraTarget) const
+{
+    int32_t clusterIndex = GetClusterIndex(point);
+    PathFindingPoint min, max;
+    GetClusterBounds(clusterIndex, min, max);
+
+    int32_t clusterWidth = max.x - min.x + 1;
+    int32_t clusterHeight = max.y - min.y + 1;
+    std::vector<PathCost> distances(static_cast<size_t>(clusterWidth) * clusterHeight, -1);
+
+    auto localIndex = [&](PathFindingPoint p)
+    {
+        return (p.x - min.x) + (p.y - min.y) * clusterWidth;
+    };
+
+    /* Dijkstra over cluster, entries are (distance, local index) */
+    typedef std::pair<PathCost, int32_t> FrontierEntry;
+    std::priority_queue<FrontierEntry, std::vector<FrontierEntry>, std::greater<FrontierEntry>> frontier;
+    distances[localIndex(point)] = 0;
+    frontier.push({0, localIndex(point)});
+
+    while (!frontier.empty())
+    {
+        auto [distance, currentLocalIndex] = frontier.top();
+        frontier.pop();
+
+        if (distance != distances[currentLocalIndex])
+        {
+            continue;
+        }
+
+        PathFindingPoint current{min.x + currentLocalIndex % clusterWidth, min.y + currentLocalIndex / clusterWidth};
+
+        PathFindingPoint neighbors[4] = {
+            {current.x - 1, current.y},
+            {current.x + 1, current.y},
+            {current.x, current.y - 1},
+            {current.x, current.y + 1}
+        };
+
+        for (PathFindingPoint neighbor : neighbors)
+        {
+            if (neighbor.x < min.x || neighbor.x > max.x || neighbor.y < min.y || neighbor.y > max.y || !IsWalkable(neighbor))
+            {
+                continue;
+            }
+
+            PathCost& neighborDistance = distances[localIndex(neighbor)];
+            PathCost newDistance = distance + m_StepCosts[GetCellIndex(neighbor)];
+
+            if (neighborDistance < 0 || newDistance < neighborDistance)
+            {
+                neighborDistance = newDistance;
+                frontier.push({newDistance, localIndex(neighbor)});
+            }
+        }
+    }
+
+    /* Step cost is paid when entering cell, so the same path walked backwards
+       pays for point instead of target: d(target, point) = d(point, target) + cost(point) - cost(target) */
+    auto addEdge = [&](int32_t targetIndex, PathCost distance)
+    {
+        if (bReversed)
+        {
+            distance += m_StepCosts[GetCellIndex(point)] - m_StepCosts[targetIndex];
+        }
+
+        outEdges.push_back({targetIndex, distance});
+    };
+
+    int32_t pointIndex = GetCellIndex(point);
+
+    for (int32_t nodeIndex : m_ClusterNodes[clusterIndex])
+    {
+        PathCost distance = distances[localIndex(GetCellPoint(nodeIndex))];
+
+        if (nodeIndex != pointIndex && distance >= 0)
+        {
+            addEdge(nodeIndex, distance);
+        }
+    }
+
+    if (extraTarget && *extraTarget != point && GetClusterIndex(*extraTarget) == clusterIndex &&
+        distances[localIndex(*extraTarget)] >= 0)
+    {
+        addEdge(GetCellIndex(*extraTarget), distances[localIndex(*extraTarget)]);
+    }
+}
+
+int32_t HierarchicalMap::GetClusterIndex(PathFindingPoint point) const
+{
+    return point.x / m_ClusterSize + (point.y / m_ClusterSize) * m_NumClustersX;
+}
+
+void HierarchicalMap::GetClusterBounds(int32_t clusterIndex, PathFindingPoint& outMin, PathFindingPoint& outMax) const
+{
+    outMin = {(clusterIndex % m_NumClustersX) * m_ClusterSize, (clusterIndex / m_NumClustersX) * m_ClusterSize};
+    outMax = {std::min(outMin.x + m_ClusterSize, m_Width) - 1, std::min(outMin.y + m_ClusterSize, m_Height) - 1};
+}
+
+bool HierarchicalMap::IsBuilt() const
+{
+    return !m_ClusterNodes.empty();
+}
+
+size_t HierarchicalMap::GetNumNodes() const
+{
+    return m_Nodes.size();
+}
+
+size_t HierarchicalMap::GetMemoryUsage() const
+{
+    size_t usage = m_StepCosts.capacity() * sizeof(uint8_t);
+
+    for (const auto& [cellIndex, node] : m_Nodes)
+    {
+        usage += sizeof(cellIndex) + sizeof(node) + node.Edges.capacity() * sizeof(Edge);
+    }
+
+    for (const std::vector<int32_t>& nodes : m_ClusterNodes)
+    {
+        usage += sizeof(nodes) + nodes.capacity() * sizeof(int32_t);
+    }
+
+    return usage;
+}
+
+double HierarchicalMap::GetLastUpdateTimeMs() const
+{
+    return m_LastUpdateTimeMs;
+}
+
+int32_t HierarchicalMap::GetLastUpdateNumClusters() const
+{
+    return m_LastUpdateNumClusters;
+}
+
+void HierarchicalMap::RemoveBorderEntrances(int32_t clusterX, int32_t clusterY, bool bTop)
+{
+    PathFindingPoint min, max;
+    GetClusterBounds(clusterX + clusterY * m_NumClustersX, min, max);
+
+    PathFindingPoint step = bTop ? PathFindingPoint{1, 0} : PathFindingPoint{0, 1};
+    PathFindingPoint across = bTop ? PathFindingPoint{0, 1} : PathFindingPoint{1, 0};
+    PathFindingPoint from = bTop ? PathFindingPoint{min.x, max.y} : PathFindingPoint{max.x, min.y};
+    int32_t length = bTop ? max.x - min.x + 1 : max.y - min.y + 1;
+
+    /* Drop only edges crossing this border, node itself may still serve another border */
+    for (int32_t i = 0; i < length; ++i)
+    {
+        PathFindingPoint a = from + step * i;
+        PathFindingPoint b = a + across;
+
+        for (auto [point, other] : {std::pair{a, b}, std::pair{b, a}})
+        {
+            auto it = m_Nodes.find(GetCellIndex(point));
+            if (it == m_Nodes.end())
+            {
+                continue;
+            }
+
+            std::vector<Edge>& edges = it->second.Edges;
+            int32_t otherIndex = GetCellIndex(other);
+            edges.erase(std::remove_if(edges.begin(), edges.end(), [otherIndex](const Edge& edge)
+            {
+                return edge.Target == otherIndex;
+            }), edges.end());
+        }
+    }
+}
+
+void HierarchicalMap::CreateBorderEntrances(int32_t clusterX, int32_t clusterY, bool bTop)
+{
+    if ((bTop && clusterY + 1 >= m_NumClustersY) || (!bTop && clusterX + 1 >= m_NumClustersX))
+    {
+        return;
+    }
+
+    PathFindingPoint min, max;
+    GetClusterBounds(clusterX + clusterY * m_NumClustersX, min, max);
+
+    PathFindingPoint step = bTop ? PathFindingPoint{1, 0} : PathFindingPoint{0, 1};
+    PathFindingPoint across = bTop ? PathFindingPoint{0, 1} : PathFindingPoint{1, 0};
+    PathFindingPoint from = bTop ? PathFindingPoint{min.x, max.y} : PathFindingPoint{max.x, min.y};
+    int32_t length = bTop ? max.x - min.x + 1 : max.y - min.y + 1;
+
+    /* Entrance is maximal run of cells walkable on both sides of border */
+    int32_t runStart = -1;
+
+    for (int32_t i = 0; i <= length; ++i)
+    {
+        PathFindingPoint a = from + step * i;
+        bool bOpen = i < length && IsWalkable(a) && IsWalkable(a + across);
+
+        if (bOpen && runStart < 0)
+        {
+            runStart = i;
+        }
+        else if (!bOpen && runStart >= 0)
+        {
+            int32_t runEnd = i - 1;
+
+            if (runEnd - runStart + 1 >= MinWideEntranceLength)
+            {
+                AddTransition(from + step * runStart, from + step * runStart + across);
+                AddTransition(from + step * runEnd, from + step * runEnd + across);
+            }
+            else
+            {
+                int32_t middle = (runStart + runEnd) / 2;
+                AddTransition(from + step * middle, from + step * middle + across);
+            }
+
+            runStart = -1;
+        }
+    }
+}
+
+void HierarchicalMap::AddTransition(PathFindingPoint a, PathFindingPoint b)
+{
+    m_Nodes[GetCellIndex(a)].Edges.push_back({GetCellIndex(b), m_StepCosts[GetCellIndex(b)]});
+    m_Nodes[GetCellIndex(b)].Edges.push_back({GetCellIndex(a), m_StepCosts[GetCellIndex(a)]});
+}
+
+void HierarchicalMap::RebuildClusterNodes(int32_t clusterIndex)
+{
+    PathFindingPoint min, max;
+    GetClusterBounds(clusterIndex, min, max);
+
+    std::vector<int32_t>& clusterNodes = m_ClusterNodes[clusterIndex];
+    clusterNodes.clear();
+
+    /* Nodes lie only on cluster edges, node without any edge leaving cluster is not needed anymore */
+    for (int32_t y = min.y; y <= max.y; ++y)
+    {
+        for (int32_t x = min.x; x <= max.x; ++x)
+        {
+            if (x != min.x && x != max.x && y != min.y && y != max.y)
+            {
+                continue;
+            }
+
+            int32_t cellIndex = GetCellIndex({x, y});
+            auto it = m_Nodes.find(cellIndex);
+
+            if (it == m_Nodes.end())
+            {
+                continue;
+            }
+
+            const std::vector<Edge>& edges = it->second.Edges;
+            bool bHasTransition = std::any_of(edges.begin(), edges.end(), [&](const Edge& edge)
+            {
+                return GetClusterIndex(GetCellPoint(edge.Target)) != clusterIndex;
+            });
+
+            if (bHasTransition)
+            {
+                clusterNodes.push_back(cellIndex);
+            }
+            else
+            {
+                m_Nodes.erase(it);
+            }
+        }
+    }
+}
+
+void HierarchicalMap::RebuildIntraEdges(int32_t clusterIndex)
+{
+    std::vector<Edge> edges;
+
+    for (int32_t nodeIndex : m_ClusterNodes[clusterIndex])
+    {
+        std::vector<Edge>& nodeEdges = m_Nodes[nodeIndex].Edges;
+
+        nodeEdges.erase(std::remove_if(nodeEdges.begin(), nodeEdges.end(), [&](const Edge& edge)
+        {
+            return GetClusterIndex(GetCellPoint(edge.Target)) == clusterIndex;
+        }), nodeEdges.end());
+
+        edges.clear();
+        GetEdgesInsideCluster(GetCellPoint(nodeIndex), false, edges);
+        nodeEdges.insert(nodeEdges.end(), edges.begin(), edges.end());
+    }
+}
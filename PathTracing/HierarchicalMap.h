@@ -0,0 +1,99 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <unordered_map>
+#include <vector>
+
+/* Abstract graph for hierarchical path finding (HPA*). Map is divided into
+   square clusters, abstract nodes are cells at both sides of entrances
+   between neighboring clusters. Nodes of the same cluster are connected by
+   edges holding cost of cheapest path inside that cluster. Graph follows
+   map edits through Update, rebuilding only clusters touched by them */
+class HierarchicalMap
+{
+public:
+    struct Edge
+    {
+        int32_t Target;
+        PathCost Cost;
+    };
+
+    explicit HierarchicalMap(int32_t clusterSize = 16);
+
+    void Build(const IMap& map);
+
+    /* Brings graph up to date with map, rebuilding it fully only when map
+       size changed or its change log does not reach revision of graph */
+    void Update(const IMap& map);
+
+    /* Returns edges of abstract node placed at cell or nullptr when cell is not abstract node */
+    const std::vector<Edge>* GetEdges(int32_t cellIndex) const;
+
+    /* Appends edges from point to all abstract nodes of its cluster, reachable without leaving cluster,
+       and to extraTarget when given and reachable that way. When bReversed is set, edge cost is cost
+       of path from target to point instead */
+    void GetEdgesInsideCluster(PathFindingPoint point, bool bReversed, std::vector<Edge>& outEdges,
+        const PathFindingPoint* extraTarget = nullptr) const;
+
+    int32_t GetClusterIndex(PathFindingPoint point) const;
+    void GetClusterBounds(int32_t clusterIndex, PathFindingPoint& outMin, PathFindingPoint& outMax) const;
+
+    bool IsBuilt() const;
+
+    size_t GetNumNodes() const;
+    size_t GetMemoryUsage() const;
+    double GetLastUpdateTimeMs() const;
+    int32_t GetLastUpdateNumClusters() const;
+
+private:
+    struct AbstractNode
+    {
+        std::vector<Edge> Edges;
+    };
+
+    int32_t m_ClusterSize;
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+    int32_t m_NumClustersX = 0;
+    int32_t m_NumClustersY = 0;
+    uint64_t m_Revision = 0;
+
+    /* Snapshot of terrain cost of every cell, zero for cells that are not walkable */
+    std::vector<uint8_t> m_StepCosts;
+    std::unordered_map<int32_t, AbstractNode> m_Nodes;
+    std::vector<std::vector<int32_t>> m_ClusterNodes;
+    std::vector<glm::ivec2> m_Changes;
+
+    double m_LastUpdateTimeMs = 0.0;
+    int32_t m_LastUpdateNumClusters = 0;
+
+private:
+    int32_t GetCellIndex(PathFindingPoint point) const
+    {
+        return point.x + point.y * m_Width;
+    }
+
+    PathFindingPoint GetCellPoint(int32_t cellIndex) const
+    {
+        return {cellIndex % m_Width, cellIndex / m_Width};
+    }
+
+    bool IsWalkable(PathFindingPoint point) const
+    {
+        return point.x >= 0 && point.x < m_Width && point.y >= 0 && point.y < m_Height && m_StepCosts[GetCellIndex(point)] != 0;
+    }
+
+    static uint8_t GetStepCost(const IMap& map, PathFindingPoint point)
+    {
+        return ::IsWalkable(point, &map) ? map.GetTerrainCost(point) : 0;
+    }
+
+    /* Border is identified by cluster below or left of it and whether it is top or right edge of that cluster */
+    void RemoveBorderEntrances(int32_t clusterX, int32_t clusterY, bool bTop);
+    void CreateBorderEntrances(int32_t clusterX, int32_t clusterY, bool bTop);
+    void AddTransition(PathFindingPoint a, PathFindingPoint b);
+
+    void RebuildClusterNodes(int32_t clusterIndex);
+    void RebuildIntraEdges(int32_t clusterIndex);
+};
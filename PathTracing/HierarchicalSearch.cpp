@@ -0,0 +1,186 @@
+#include "PathFinder.h"
+
+PathFindingResult PathFinder::FindPathHierarchical(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    if (!m_HierarchicalMap)
+    {
+        return FindPathAStar<FourConnected>(map, start, goal);
+    }
+
+    PathFindingResult abstractResult = FindAbstractPath(map, start, goal);
+    if (abstractResult.Status != EPathFindingStatus::Found)
+    {
+        return abstractResult;
+    }
+
+    const Path& waypoints = abstractResult.FoundPath;
+    PathFindingResult result{EPathFindingStatus::Found, {waypoints.front()}, abstractResult.NodesExpanded};
+
+    for (size_t i = 1; i < waypoints.size(); ++i)
+    {
+        PathFindingResult segment = RefineAbstractSegment(map, waypoints[i - 1], waypoints[i]);
+        result.NodesExpanded += segment.NodesExpanded;
+
+        if (segment.Status != EPathFindingStatus::Found)
+        {
+            return {segment.Status, {}, result.NodesExpanded};
+        }
+
+        result.FoundPath.insert(result.FoundPath.end(), segment.FoundPath.begin() + 1, segment.FoundPath.end());
+    }
+
+    return result;
+}
+
+PathFindingResult PathFinder::FindAbstractPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    const HierarchicalMap& graph = *m_HierarchicalMap;
+
+    int32_t startCluster = graph.GetClusterIndex(start);
+    int32_t goalCluster = graph.GetClusterIndex(goal);
+    size_t nodesExpanded = 0;
+
+    /* Path inside single cluster does not need abstract graph, unless it has to leave cluster */
+    if (startCluster == goalCluster)
+    {
+        SearchBounds bounds;
+        graph.GetClusterBounds(startCluster, bounds.Min, bounds.Max);
+
+        PathFindingResult local = FindPathAStar<FourConnected>(map, start, goal, &bounds);
+        nodesExpanded += local.NodesExpanded;
+
+        if (local.Status == EPathFindingStatus::Found)
+        {
+            return {EPathFindingStatus::Found, {start, goal}, nodesExpanded};
+        }
+    }
+
+    /* Session sets map width temporary edges are indexed with, so it starts before they are built */
+    StartNewPathFindingSession(map);
+
+    /* Start and goal are connected to nodes of their clusters only for this query, graph stays untouched */
+    m_TemporaryEdges.clear();
+    ConnectToAbstractGraph(start, goal, false);
+    ConnectToAbstractGraph(goal, goal, true);
+
+    /* Start cell is occupied by agent itself, so no entrance was placed at it. Connect cells
+       across cluster border it could step to directly */
+    PathFindingPoint startNeighbors[4] = {
+        {start.x - 1, start.y},
+        {start.x + 1, start.y},
+        {start.x, start.y - 1},
+        {start.x, start.y + 1}
+    };
+
+    for (PathFindingPoint neighbor : startNeighbors)
+    {
+        if (IsWalkable(neighbor, &map) && graph.GetClusterIndex(neighbor) != startCluster)
+        {
+            m_TemporaryEdges.push_back({GetCellIndex(start), {GetCellIndex(neighbor), map.GetTerrainCost(neighbor)}});
+            ConnectToAbstractGraph(neighbor, goal, false);
+        }
+    }
+
+    if (!OpenOrUpdate(start, InvalidCellIndex, 0, ManhattanHeuristic::Evaluate(start, goal)))
+    {
+        return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+    }
+
+    while (!m_OpenList.IsEmpty())
+    {
+        Node* currentNode = m_OpenList.Pop();
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        if (current == goal)
+        {
+            return {EPathFindingStatus::Found, ReconstructPath(goal), nodesExpanded};
+        }
+
+        PathCost currentCost = currentRecord.CostFunc;
+        int32_t currentIndex = GetCellIndex(current);
+
+        auto relax = [&](int32_t targetIndex, PathCost cost)
+        {
+            PathFindingPoint target{targetIndex % m_MapWidth, targetIndex / m_MapWidth};
+
+            if (IsClosed(target))
+            {
+                return true;
+            }
+
+            return OpenOrUpdate(target, currentIndex, currentCost + cost, ManhattanHeuristic::Evaluate(target, goal));
+        };
+
+        bool bWithinBudget = true;
+
+        if (const std::vector<HierarchicalMap::Edge>* edges = graph.GetEdges(currentIndex))
+        {
+            for (const HierarchicalMap::Edge& edge : *edges)
+            {
+                bWithinBudget = bWithinBudget && relax(edge.Target, edge.Cost);
+            }
+        }
+
+        for (const TemporaryEdge& edge : m_TemporaryEdges)
+        {
+            if (edge.From == currentIndex)
+            {
+                bWithinBudget = bWithinBudget && relax(edge.Edge.Target, edge.Edge.Cost);
+            }
+        }
+
+        if (!bWithinBudget)
+        {
+            return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
+
+void PathFinder::ConnectToAbstractGraph(PathFindingPoint point, PathFindingPoint goal, bool bReversed)
+{
+    m_ScratchEdges.clear();
+    int32_t pointIndex = GetCellIndex(point);
+
+    if (bReversed)
+    {
+        /* Edges lead from cluster nodes into point */
+        m_HierarchicalMap->GetEdgesInsideCluster(point, true, m_ScratchEdges);
+
+        for (const HierarchicalMap::Edge& edge : m_ScratchEdges)
+        {
+            m_TemporaryEdges.push_back({edge.Target, {pointIndex, edge.Cost}});
+        }
+    }
+    else
+    {
+        m_HierarchicalMap->GetEdgesInsideCluster(point, false, m_ScratchEdges, &goal);
+
+        for (const HierarchicalMap::Edge& edge : m_ScratchEdges)
+        {
+            m_TemporaryEdges.push_back({pointIndex, edge});
+        }
+    }
+}
+
+PathFindingResult PathFinder::RefineAbstractSegment(const IMap& map, PathFindingPoint from, PathFindingPoint to)
+{
+    const HierarchicalMap& graph = *m_HierarchicalMap;
+    int32_t cluster = graph.GetClusterIndex(from);
+
+    /* Transition between clusters, cells are already neighbors */
+    if (cluster != graph.GetClusterIndex(to))
+    {
+        return {EPathFindingStatus::Found, {from, to}};
+    }
+
+    SearchBounds bounds;
+    graph.GetClusterBounds(cluster, bounds.Min, bounds.Max);
+    return FindPathAStar<FourConnected>(map, from, to, &bounds);
+}
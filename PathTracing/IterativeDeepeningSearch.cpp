@@ -0,0 +1,168 @@
+#include "PathFinder.h"
+
+#include <algorithm>
+
+/*
+ * IDA* on 4-connected grid. Every iteration is depth first search which cuts off
+ * cells whose cost plus heuristic exceeds threshold, next iteration raises threshold
+ * to lowest value that was cut off. Search itself holds only cells of current path,
+ * but on grid the same cell is reached along many paths, and each of them would be
+ * searched again. Transposition table remembers cost cells were reached with in
+ * current iteration, so visits that are not cheaper are skipped.
+ *
+ * Table takes half of memory budget. Slot of cell is its index modulo table size,
+ * so cells close to each other do not collide, and cell replaces whatever cell its
+ * slot held. Smaller budget means more re-expansions, but never longer path.
+ */
+
+PathFindingResult PathFinder::FindPathIterativeDeepening(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    size_t budget = m_NodeArena.GetBudget();
+    size_t numCells = static_cast<size_t>(map.GetMapWidth()) * map.GetMapHeight();
+    int32_t width = map.GetMapWidth();
+
+    /* Power of two slots, table larger than map would stay partly empty */
+    size_t numEntries = budget / 2 >= sizeof(TranspositionEntry) ? 1 : 0;
+    while (numEntries > 0 && numEntries < numCells && numEntries * 2 * sizeof(TranspositionEntry) <= budget / 2)
+    {
+        numEntries *= 2;
+    }
+
+    if (m_TranspositionTable.size() != numEntries)
+    {
+        std::vector<TranspositionEntry>(numEntries).swap(m_TranspositionTable);
+    }
+
+    size_t tableBytes = numEntries * sizeof(TranspositionEntry);
+    size_t maxFrames = (budget - std::min(budget, tableBytes)) / sizeof(DepthFirstFrame);
+    size_t entryMask = numEntries - 1;
+
+    if (maxFrames == 0)
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    /* Path left by query with bigger budget would not count against this one */
+    if (m_DepthFirstStack.capacity() > maxFrames)
+    {
+        std::vector<DepthFirstFrame>().swap(m_DepthFirstStack);
+    }
+
+    PathCost threshold = ManhattanHeuristic::Evaluate(start, goal);
+    size_t nodesExpanded = 0;
+    size_t peakFrames = 0;
+
+    auto finish = [&](EPathFindingStatus status, Path path = {})
+    {
+        m_MemoryBoundedPeakUsage = tableBytes + peakFrames * sizeof(DepthFirstFrame);
+        return PathFindingResult{status, std::move(path), nodesExpanded};
+    };
+
+    if (start == goal)
+    {
+        return finish(EPathFindingStatus::Found, {start});
+    }
+
+    while (true)
+    {
+        /* Slots of earlier iterations are ignored, table is cleared only when counter wraps around */
+        if (++m_TranspositionIteration == 0)
+        {
+            std::fill(m_TranspositionTable.begin(), m_TranspositionTable.end(), TranspositionEntry{});
+            m_TranspositionIteration = 1;
+        }
+
+        PathCost nextThreshold = std::numeric_limits<PathCost>::max();
+
+        m_DepthFirstStack.clear();
+        m_DepthFirstStack.push_back({start, 0, 0});
+        peakFrames = std::max<size_t>(peakFrames, 1);
+
+        if (numEntries > 0)
+        {
+            int32_t startIndex = start.x + start.y * width;
+            m_TranspositionTable[startIndex & entryMask] = {startIndex, 0, m_TranspositionIteration};
+        }
+
+        while (!m_DepthFirstStack.empty())
+        {
+            DepthFirstFrame& frame = m_DepthFirstStack.back();
+
+            if (frame.NextMove == FourConnected::NumNeighbors)
+            {
+                m_DepthFirstStack.pop_back();
+                continue;
+            }
+
+            NeighborOffset offset = FourConnected::GetOffset(frame.Point, frame.NextMove++);
+            PathFindingPoint neighbor{frame.Point.x + offset.X, frame.Point.y + offset.Y};
+
+            /* Stepping straight back is never cheaper, so it is skipped even without table */
+            if (!IsWalkable(neighbor, &map) ||
+                (m_DepthFirstStack.size() > 1 && neighbor == m_DepthFirstStack[m_DepthFirstStack.size() - 2].Point))
+            {
+                continue;
+            }
+
+            PathCost cost = frame.Cost + offset.Cost * map.GetTerrainCost(neighbor);
+            PathCost evaluation = cost + ManhattanHeuristic::Evaluate(neighbor, goal);
+
+            if (evaluation > threshold)
+            {
+                nextThreshold = std::min(nextThreshold, evaluation);
+                continue;
+            }
+
+            if (neighbor == goal)
+            {
+                Path path;
+                path.reserve(m_DepthFirstStack.size() + 1);
+
+                for (const DepthFirstFrame& pathFrame : m_DepthFirstStack)
+                {
+                    path.push_back(pathFrame.Point);
+                }
+
+                path.push_back(goal);
+                return finish(EPathFindingStatus::Found, std::move(path));
+            }
+
+            if (numEntries > 0)
+            {
+                int32_t cellIndex = neighbor.x + neighbor.y * width;
+                TranspositionEntry& entry = m_TranspositionTable[cellIndex & entryMask];
+
+                if (entry.CellIndex == cellIndex && entry.Iteration == m_TranspositionIteration && entry.Cost <= cost)
+                {
+                    continue;
+                }
+
+                entry = {cellIndex, cost, m_TranspositionIteration};
+            }
+
+            if (m_DepthFirstStack.size() == maxFrames || nodesExpanded == m_MemoryBoundedExpansionLimit)
+            {
+                return finish(EPathFindingStatus::BudgetExceeded);
+            }
+
+            ++nodesExpanded;
+
+            /* Grows in steps, but never beyond budget */
+            if (m_DepthFirstStack.size() == m_DepthFirstStack.capacity())
+            {
+                m_DepthFirstStack.reserve(std::min(maxFrames, std::max<size_t>(256, m_DepthFirstStack.capacity() * 2)));
+            }
+
+            m_DepthFirstStack.push_back({neighbor, cost, 0});
+            peakFrames = std::max(peakFrames, m_DepthFirstStack.size());
+        }
+
+        /* Nothing was cut off, every cell reachable from start was searched */
+        if (nextThreshold == std::numeric_limits<PathCost>::max())
+        {
+            return finish(EPathFindingStatus::NoPath);
+        }
+
+        threshold = nextThreshold;
+    }
+}
@@ -0,0 +1,256 @@
+#include "PathFinder.h"
+#include "JumpPointTable.h"
+
+/*
+ * Jump point search on 4-connected grid.
+ *
+ * Among all shortest paths search considers only canonical ones, where
+ * horizontal move may turn vertical anywhere, but vertical move turns
+ * horizontal only when it is forced, that is when cell behind on that side
+ * is blocked. Any shortest path can be rewritten into canonical one by
+ * moving its horizontal steps earlier, so no path length is lost.
+ * Search then expands only cells where canonical path can turn.
+ *
+ * With JumpPointTable (JPS+) the same jumps are answered from precomputed
+ * distances, only jumps ending at goal are resolved at query time.
+ */
+
+static bool IsForcedHorizontalTurn(const IMap& map, PathFindingPoint point, int32_t dy, int32_t side)
+{
+    return IsWalkable({point.x + side, point.y}, &map) && !IsWalkable({point.x + side, point.y - dy}, &map);
+}
+
+static bool JumpVertical(const IMap& map, PathFindingPoint from, int32_t dy, PathFindingPoint goal, PathFindingPoint& outJumpPoint)
+{
+    PathFindingPoint point = from;
+
+    while (true)
+    {
+        point.y += dy;
+
+        if (!IsWalkable(point, &map))
+        {
+            return false;
+        }
+
+        if (point == goal || IsForcedHorizontalTurn(map, point, dy, -1) || IsForcedHorizontalTurn(map, point, dy, 1))
+        {
+            outJumpPoint = point;
+            return true;
+        }
+    }
+}
+
+static bool JumpHorizontal(const IMap& map, PathFindingPoint from, int32_t dx, PathFindingPoint goal, PathFindingPoint& outJumpPoint)
+{
+    PathFindingPoint point = from;
+    PathFindingPoint ignored;
+
+    while (true)
+    {
+        point.x += dx;
+
+        if (!IsWalkable(point, &map))
+        {
+            return false;
+        }
+
+        /* Cell is jump point when vertical scan from it reaches something interesting */
+        if (point == goal || JumpVertical(map, point, 1, goal, ignored) || JumpVertical(map, point, -1, goal, ignored))
+        {
+            outJumpPoint = point;
+            return true;
+        }
+    }
+}
+
+static int32_t GetDirection(int32_t from, int32_t to)
+{
+    return (to > from) - (to < from);
+}
+
+static EJumpDirection GetVerticalJumpDirection(int32_t dy)
+{
+    return dy > 0 ? EJumpDirection::Up : EJumpDirection::Down;
+}
+
+static bool JumpVerticalPlus(const JumpPointTable& table, PathFindingPoint from, int32_t dy, PathFindingPoint goal, PathFindingPoint& outJumpPoint)
+{
+    int32_t distance = table.GetJumpDistance(from, GetVerticalJumpDirection(dy));
+
+    /* Goal in the same column is reachable when it is not behind wall */
+    int32_t stepsToGoal = (goal.y - from.y) * dy;
+    if (goal.x == from.x && stepsToGoal > 0 && stepsToGoal <= abs(distance))
+    {
+        outJumpPoint = goal;
+        return true;
+    }
+
+    if (distance > 0)
+    {
+        outJumpPoint = {from.x, from.y + dy * distance};
+        return true;
+    }
+
+    return false;
+}
+
+static bool JumpHorizontalPlus(const JumpPointTable& table, PathFindingPoint from, int32_t dx, PathFindingPoint goal, PathFindingPoint& outJumpPoint)
+{
+    int32_t distance = table.GetJumpDistance(from, dx > 0 ? EJumpDirection::Right : EJumpDirection::Left);
+
+    /* Cell in goal column is jump point when vertical scan from it reaches goal */
+    int32_t stepsToGoalColumn = (goal.x - from.x) * dx;
+    if (stepsToGoalColumn > 0 && stepsToGoalColumn <= abs(distance))
+    {
+        PathFindingPoint column{goal.x, from.y};
+        int32_t dy = GetDirection(column.y, goal.y);
+
+        if (dy == 0 || abs(goal.y - column.y) <= abs(table.GetJumpDistance(column, GetVerticalJumpDirection(dy))))
+        {
+            outJumpPoint = column;
+            return true;
+        }
+    }
+
+    if (distance > 0)
+    {
+        outJumpPoint = {from.x + dx * distance, from.y};
+        return true;
+    }
+
+    return false;
+}
+
+/* Jump points are collinear, so fill cells between them to get walkable path */
+static Path ExpandJumpPoints(const Path& jumpPoints)
+{
+    Path path;
+
+    if (jumpPoints.empty())
+    {
+        return path;
+    }
+
+    path.push_back(jumpPoints.front());
+
+    for (size_t i = 1; i < jumpPoints.size(); ++i)
+    {
+        PathFindingPoint point = jumpPoints[i - 1];
+        PathFindingPoint step{GetDirection(point.x, jumpPoints[i].x), GetDirection(point.y, jumpPoints[i].y)};
+
+        while (point != jumpPoints[i])
+        {
+            point += step;
+            path.push_back(point);
+        }
+    }
+
+    return path;
+}
+
+PathFindingResult PathFinder::FindPathJumpPointSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    const JumpPointTable* table)
+{
+    /* Pruning relies on all steps costing the same */
+    if (!map.HasUniformTerrainCost())
+    {
+        return FindPathAStar<FourConnected>(map, start, goal);
+    }
+
+    StartNewPathFindingSession(map);
+
+    if (!OpenOrUpdate(start, InvalidCellIndex, 0, ManhattanHeuristic::Evaluate(start, goal)))
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    size_t nodesExpanded = 0;
+
+    while (!m_OpenList.IsEmpty())
+    {
+        Node* currentNode = m_OpenList.Pop();
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        if (current == goal)
+        {
+            return {EPathFindingStatus::Found, ExpandJumpPoints(ReconstructPath(goal)), nodesExpanded};
+        }
+
+        PathCost currentCost = currentRecord.CostFunc;
+        int32_t currentIndex = GetCellIndex(current);
+
+        /* Direction of arrival decides which directions canonical path may continue in */
+        PathFindingPoint directions[4];
+        int32_t numDirections = 0;
+
+        if (currentRecord.Parent == InvalidCellIndex)
+        {
+            directions[numDirections++] = {-1, 0};
+            directions[numDirections++] = {1, 0};
+            directions[numDirections++] = {0, -1};
+            directions[numDirections++] = {0, 1};
+        }
+        else
+        {
+            PathFindingPoint parent{currentRecord.Parent % m_MapWidth, currentRecord.Parent / m_MapWidth};
+            PathFindingPoint arrival{GetDirection(parent.x, current.x), GetDirection(parent.y, current.y)};
+
+            if (arrival.x != 0)
+            {
+                directions[numDirections++] = arrival;
+                directions[numDirections++] = {0, -1};
+                directions[numDirections++] = {0, 1};
+            }
+            else
+            {
+                directions[numDirections++] = arrival;
+
+                for (int32_t side : {-1, 1})
+                {
+                    if (IsForcedHorizontalTurn(map, current, arrival.y, side))
+                    {
+                        directions[numDirections++] = {side, 0};
+                    }
+                }
+            }
+        }
+
+        for (int32_t i = 0; i < numDirections; ++i)
+        {
+            PathFindingPoint jumpPoint;
+            bool bFound = false;
+
+            if (table)
+            {
+                bFound = directions[i].x != 0 ?
+                    JumpHorizontalPlus(*table, current, directions[i].x, goal, jumpPoint) :
+                    JumpVerticalPlus(*table, current, directions[i].y, goal, jumpPoint);
+            }
+            else
+            {
+                bFound = directions[i].x != 0 ?
+                    JumpHorizontal(map, current, directions[i].x, goal, jumpPoint) :
+                    JumpVertical(map, current, directions[i].y, goal, jumpPoint);
+            }
+
+            if (!bFound || IsClosed(jumpPoint))
+            {
+                continue;
+            }
+
+            PathCost costFunc = currentCost + ManhattanHeuristic::Evaluate(current, jumpPoint);
+            if (!OpenOrUpdate(jumpPoint, currentIndex, costFunc, ManhattanHeuristic::Evaluate(jumpPoint, goal)))
+            {
+                return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+            }
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
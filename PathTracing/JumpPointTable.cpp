@@ -0,0 +1,261 @@
+#include "JumpPointTable.h"
+#include "MapChangeLog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+
+typedef std::chrono::steady_clock Clock;
+
+static double GetElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/* Next distance along scan line, given distance stored in following cell */
+static int16_t ContinueDistance(int16_t next)
+{
+    return next > 0 ? next + 1 : next - 1;
+}
+
+void JumpPointTable::Build(const IMap& map)
+{
+    Clock::time_point start = Clock::now();
+
+    m_Width = map.GetMapWidth();
+    m_Height = map.GetMapHeight();
+    assert(std::max(m_Width, m_Height) < std::numeric_limits<int16_t>::max());
+
+    m_Walkable.resize(static_cast<size_t>(m_Width) * m_Height);
+    m_Distances.resize(m_Walkable.size() * static_cast<size_t>(EJumpDirection::Max));
+
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        for (int32_t x = 0; x < m_Width; ++x)
+        {
+            m_Walkable[GetCellIndex({x, y})] = ::IsWalkable({x, y}, &map);
+        }
+    }
+
+    /* Horizontal jump points depend on vertical distances, so columns go first */
+    for (int32_t x = 0; x < m_Width; ++x)
+    {
+        ComputeColumn(x);
+    }
+
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        ComputeRow(y);
+    }
+
+    m_Revision = map.GetRevision();
+    m_LastUpdateTimeMs = GetElapsedMs(start);
+    m_LastUpdateNumRows = m_Height;
+    m_LastUpdateNumColumns = m_Width;
+}
+
+void JumpPointTable::Update(const IMap& map)
+{
+    if (m_Revision == map.GetRevision() && IsBuilt())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        Build(map);
+        return;
+    }
+
+    Clock::time_point start = Clock::now();
+    m_Revision = map.GetRevision();
+
+    /* Vertical distances of column read walkability of both neighbor columns */
+    std::vector<uint8_t> dirtyColumns(m_Width, 0);
+    std::vector<uint8_t> dirtyRows(m_Height, 0);
+
+    for (glm::ivec2 position : m_Changes)
+    {
+        uint8_t bWalkable = ::IsWalkable(position, &map);
+        uint8_t& bWasWalkable = m_Walkable[GetCellIndex(position)];
+
+        if (bWalkable == bWasWalkable)
+        {
+            continue;
+        }
+
+        bWasWalkable = bWalkable;
+        dirtyRows[position.y] = 1;
+
+        for (int32_t x = std::max(position.x - 1, 0); x <= std::min(position.x + 1, m_Width - 1); ++x)
+        {
+            dirtyColumns[x] = 1;
+        }
+    }
+
+    m_LastUpdateNumColumns = 0;
+
+    for (int32_t x = 0; x < m_Width; ++x)
+    {
+        if (!dirtyColumns[x])
+        {
+            continue;
+        }
+
+        /* Row has to be recomputed only if some of its horizontal jump points appeared or disappeared */
+        std::vector<uint8_t> wasJumpPoint(m_Height);
+        for (int32_t y = 0; y < m_Height; ++y)
+        {
+            wasJumpPoint[y] = IsHorizontalJumpPoint(x, y);
+        }
+
+        ComputeColumn(x);
+        ++m_LastUpdateNumColumns;
+
+        for (int32_t y = 0; y < m_Height; ++y)
+        {
+            if (wasJumpPoint[y] != IsHorizontalJumpPoint(x, y))
+            {
+                dirtyRows[y] = 1;
+            }
+        }
+    }
+
+    m_LastUpdateNumRows = 0;
+
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        if (dirtyRows[y])
+        {
+            ComputeRow(y);
+            ++m_LastUpdateNumRows;
+        }
+    }
+
+    m_LastUpdateTimeMs = GetElapsedMs(start);
+}
+
+bool JumpPointTable::IsBuilt() const
+{
+    return !m_Distances.empty();
+}
+
+size_t JumpPointTable::GetMemoryUsage() const
+{
+    return m_Distances.capacity() * sizeof(int16_t) + m_Walkable.capacity() * sizeof(uint8_t);
+}
+
+double JumpPointTable::GetLastUpdateTimeMs() const
+{
+    return m_LastUpdateTimeMs;
+}
+
+int32_t JumpPointTable::GetLastUpdateNumRows() const
+{
+    return m_LastUpdateNumRows;
+}
+
+int32_t JumpPointTable::GetLastUpdateNumColumns() const
+{
+    return m_LastUpdateNumColumns;
+}
+
+bool JumpPointTable::IsVerticalJumpPoint(int32_t x, int32_t y, int32_t dy) const
+{
+    /* Moving vertically, turn to side is forced when cell behind on that side is blocked */
+    for (int32_t side : {-1, 1})
+    {
+        if (IsWalkable({x + side, y}) && !IsWalkable({x + side, y - dy}))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JumpPointTable::IsHorizontalJumpPoint(int32_t x, int32_t y) const
+{
+    /* Horizontal move stops where vertical scan would find jump point */
+    return GetJumpDistance({x, y}, EJumpDirection::Down) > 0 || GetJumpDistance({x, y}, EJumpDirection::Up) > 0;
+}
+
+void JumpPointTable::ComputeColumn(int32_t x)
+{
+    /* Scan against direction of movement, so every cell reuses result of cell in front of it */
+    for (int32_t y = m_Height - 1; y >= 0; --y)
+    {
+        int32_t next = y + 1;
+
+        if (next >= m_Height || !IsWalkable({x, next}))
+        {
+            DistanceAt(x, y, EJumpDirection::Up) = 0;
+        }
+        else if (IsVerticalJumpPoint(x, next, 1))
+        {
+            DistanceAt(x, y, EJumpDirection::Up) = 1;
+        }
+        else
+        {
+            DistanceAt(x, y, EJumpDirection::Up) = ContinueDistance(DistanceAt(x, next, EJumpDirection::Up));
+        }
+    }
+
+    for (int32_t y = 0; y < m_Height; ++y)
+    {
+        int32_t next = y - 1;
+
+        if (next < 0 || !IsWalkable({x, next}))
+        {
+            DistanceAt(x, y, EJumpDirection::Down) = 0;
+        }
+        else if (IsVerticalJumpPoint(x, next, -1))
+        {
+            DistanceAt(x, y, EJumpDirection::Down) = 1;
+        }
+        else
+        {
+            DistanceAt(x, y, EJumpDirection::Down) = ContinueDistance(DistanceAt(x, next, EJumpDirection::Down));
+        }
+    }
+}
+
+void JumpPointTable::ComputeRow(int32_t y)
+{
+    for (int32_t x = m_Width - 1; x >= 0; --x)
+    {
+        int32_t next = x + 1;
+
+        if (next >= m_Width || !IsWalkable({next, y}))
+        {
+            DistanceAt(x, y, EJumpDirection::Right) = 0;
+        }
+        else if (IsHorizontalJumpPoint(next, y))
+        {
+            DistanceAt(x, y, EJumpDirection::Right) = 1;
+        }
+        else
+        {
+            DistanceAt(x, y, EJumpDirection::Right) = ContinueDistance(DistanceAt(next, y, EJumpDirection::Right));
+        }
+    }
+
+    for (int32_t x = 0; x < m_Width; ++x)
+    {
+        int32_t next = x - 1;
+
+        if (next < 0 || !IsWalkable({next, y}))
+        {
+            DistanceAt(x, y, EJumpDirection::Left) = 0;
+        }
+        else if (IsHorizontalJumpPoint(next, y))
+        {
+            DistanceAt(x, y, EJumpDirection::Left) = 1;
+        }
+        else
+        {
+            DistanceAt(x, y, EJumpDirection::Left) = ContinueDistance(DistanceAt(next, y, EJumpDirection::Left));
+        }
+    }
+}
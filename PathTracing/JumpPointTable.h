@@ -0,0 +1,76 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <vector>
+
+enum class EJumpDirection : uint8_t
+{
+    Left = 0,
+    Right,
+    Down,
+    Up,
+    Max
+};
+
+/* Precomputed jump distances for JPS+ on 4-connected grid. For every cell
+   and direction table stores distance to first static jump point (positive
+   value) or negated number of free steps before wall (zero or negative).
+   Table follows map edits through Update, which recomputes only rows and
+   columns whose jump points could have changed */
+class JumpPointTable
+{
+public:
+    void Build(const IMap& map);
+
+    /* Brings table up to date with map, rebuilding it fully only when map
+       size changed or its change log does not reach revision of table */
+    void Update(const IMap& map);
+
+    int32_t GetJumpDistance(PathFindingPoint point, EJumpDirection direction) const
+    {
+        return m_Distances[GetCellIndex(point) * static_cast<size_t>(EJumpDirection::Max) + static_cast<size_t>(direction)];
+    }
+
+    bool IsWalkable(PathFindingPoint point) const
+    {
+        return point.x >= 0 && point.x < m_Width && point.y >= 0 && point.y < m_Height && m_Walkable[GetCellIndex(point)];
+    }
+
+    bool IsBuilt() const;
+
+    size_t GetMemoryUsage() const;
+    double GetLastUpdateTimeMs() const;
+    int32_t GetLastUpdateNumRows() const;
+    int32_t GetLastUpdateNumColumns() const;
+
+private:
+    std::vector<int16_t> m_Distances;
+    std::vector<uint8_t> m_Walkable;
+    std::vector<glm::ivec2> m_Changes;
+
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+    uint64_t m_Revision = 0;
+
+    double m_LastUpdateTimeMs = 0.0;
+    int32_t m_LastUpdateNumRows = 0;
+    int32_t m_LastUpdateNumColumns = 0;
+
+private:
+    size_t GetCellIndex(PathFindingPoint point) const
+    {
+        return static_cast<size_t>(point.x) + static_cast<size_t>(point.y) * m_Width;
+    }
+
+    int16_t& DistanceAt(int32_t x, int32_t y, EJumpDirection direction)
+    {
+        return m_Distances[GetCellIndex({x, y}) * static_cast<size_t>(EJumpDirection::Max) + static_cast<size_t>(direction)];
+    }
+
+    bool IsVerticalJumpPoint(int32_t x, int32_t y, int32_t dy) const;
+    bool IsHorizontalJumpPoint(int32_t x, int32_t y) const;
+
+    void ComputeColumn(int32_t x);
+    void ComputeRow(int32_t y);
+};
@@ -0,0 +1,335 @@
+#include "LandmarkTable.h"
+#include "MapChangeLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+typedef std::chrono::steady_clock Clock;
+
+static const glm::ivec2 NeighborOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+static double GetElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/* Dijkstra over passable cells from source. Forward search gives costs from source, backward
+   one costs to source, both charge terrain cost of every entered cell */
+static void ComputeCosts(const std::vector<uint8_t>& stepCosts, int32_t width, int32_t height, int32_t source,
+    bool bForward, PathCost unreachableCost, std::vector<PathCost>& outCosts)
+{
+    typedef std::pair<PathCost, int32_t> HeapEntry;
+    std::vector<HeapEntry> heap;
+
+    outCosts.assign(stepCosts.size(), unreachableCost);
+    outCosts[source] = 0;
+    heap.push_back({0, source});
+
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        auto [cost, cell] = heap.back();
+        heap.pop_back();
+
+        if (cost != outCosts[cell])
+        {
+            continue;
+        }
+
+        PathFindingPoint point{cell % width, cell / width};
+
+        for (glm::ivec2 offset : NeighborOffsets)
+        {
+            PathFindingPoint neighbor = point + offset;
+            if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height)
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = neighbor.x + neighbor.y * width;
+            if (stepCosts[neighborIndex] == 0)
+            {
+                continue;
+            }
+
+            /* Backward search walks edges in reverse, so step enters cell being expanded */
+            PathCost newCost = cost + (bForward ? stepCosts[neighborIndex] : stepCosts[cell]);
+            if (newCost < outCosts[neighborIndex])
+            {
+                outCosts[neighborIndex] = newCost;
+                heap.push_back({newCost, neighborIndex});
+                std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+            }
+        }
+    }
+}
+
+/* Any cell of largest group of connected passable cells, -1 when there is none */
+static int32_t FindCellOfLargestComponent(const std::vector<uint8_t>& stepCosts, int32_t width, int32_t height)
+{
+    std::vector<bool> bVisited(stepCosts.size(), false);
+    std::vector<int32_t> queue;
+    int32_t bestCell = -1;
+    size_t bestSize = 0;
+
+    for (int32_t seed = 0; seed < static_cast<int32_t>(stepCosts.size()); ++seed)
+    {
+        if (stepCosts[seed] == 0 || bVisited[seed])
+        {
+            continue;
+        }
+
+        queue.clear();
+        queue.push_back(seed);
+        bVisited[seed] = true;
+
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            PathFindingPoint point{queue[head] % width, queue[head] / width};
+
+            for (glm::ivec2 offset : NeighborOffsets)
+            {
+                PathFindingPoint neighbor = point + offset;
+                if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height)
+                {
+                    continue;
+                }
+
+                int32_t neighborIndex = neighbor.x + neighbor.y * width;
+                if (stepCosts[neighborIndex] != 0 && !bVisited[neighborIndex])
+                {
+                    bVisited[neighborIndex] = true;
+                    queue.push_back(neighborIndex);
+                }
+            }
+        }
+
+        if (queue.size() > bestSize)
+        {
+            bestSize = queue.size();
+            bestCell = seed;
+        }
+    }
+
+    return bestCell;
+}
+
+/* Reachable cell with largest cost, -1 when every reachable cell has zero cost */
+static int32_t FindFarthestCell(const std::vector<PathCost>& costs, PathCost unreachableCost)
+{
+    int32_t farthestCell = -1;
+    PathCost farthestCost = 0;
+
+    for (int32_t cell = 0; cell < static_cast<int32_t>(costs.size()); ++cell)
+    {
+        if (costs[cell] != unreachableCost && costs[cell] > farthestCost)
+        {
+            farthestCost = costs[cell];
+            farthestCell = cell;
+        }
+    }
+
+    return farthestCell;
+}
+
+LandmarkTable::LandmarkTable(int32_t numLandmarks) :
+    m_NumLandmarks(numLandmarks)
+{
+}
+
+void LandmarkTable::Build(const IMap& map)
+{
+    SetTables(BuildTables(GetStepCosts(map), map.GetMapWidth(), map.GetMapHeight(), map.GetRevision(), m_NumLandmarks));
+}
+
+void LandmarkTable::Update(const IMap& map)
+{
+    if (m_PendingBuild.valid() && m_PendingBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        SetTables(m_PendingBuild.get());
+    }
+
+    CheckChanges(map);
+
+    /* Build works on snapshot of map, edits made meanwhile are checked once it is taken over */
+    if (m_bStale && !m_PendingBuild.valid())
+    {
+        m_PendingBuild = std::async(std::launch::async, &LandmarkTable::BuildTables, GetStepCosts(map),
+            map.GetMapWidth(), map.GetMapHeight(), map.GetRevision(), m_NumLandmarks);
+    }
+}
+
+bool LandmarkTable::IsUsable() const
+{
+    return m_Tables && m_bAdmissible;
+}
+
+bool LandmarkTable::IsBuilt() const
+{
+    return m_Tables != nullptr;
+}
+
+bool LandmarkTable::IsRebuilding() const
+{
+    return m_PendingBuild.valid();
+}
+
+const std::vector<PathFindingPoint>& LandmarkTable::GetLandmarks() const
+{
+    static const std::vector<PathFindingPoint> NoLandmarks;
+    return m_Tables ? m_Tables->Landmarks : NoLandmarks;
+}
+
+size_t LandmarkTable::GetMemoryUsage() const
+{
+    if (!m_Tables)
+    {
+        return 0;
+    }
+
+    return m_Tables->StepCosts.capacity() * sizeof(uint8_t) +
+        m_Tables->FromLandmarks.capacity() * sizeof(PathCost) +
+        m_Tables->ToLandmarks.capacity() * sizeof(PathCost);
+}
+
+double LandmarkTable::GetLastBuildTimeMs() const
+{
+    return m_Tables ? m_Tables->BuildTimeMs : 0.0;
+}
+
+std::vector<uint8_t> LandmarkTable::GetStepCosts(const IMap& map)
+{
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+    std::vector<uint8_t> stepCosts(static_cast<size_t>(width) * height);
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            stepCosts[x + y * width] = GetStepCost(map, {x, y});
+        }
+    }
+
+    return stepCosts;
+}
+
+std::shared_ptr<const LandmarkTable::Tables> LandmarkTable::BuildTables(std::vector<uint8_t> stepCosts, int32_t width,
+    int32_t height, uint64_t revision, int32_t numLandmarks)
+{
+    Clock::time_point start = Clock::now();
+
+    auto tables = std::make_shared<Tables>();
+    tables->Width = width;
+    tables->Height = height;
+    tables->Revision = revision;
+    tables->StepCosts = std::move(stepCosts);
+
+    const std::vector<uint8_t>& steps = tables->StepCosts;
+    size_t numCells = steps.size();
+    bool bUniform = std::all_of(steps.begin(), steps.end(), [](uint8_t stepCost) { return stepCost <= 1; });
+
+    /* Landmarks are spread over largest component, others keep Manhattan heuristic */
+    int32_t seed = FindCellOfLargestComponent(steps, width, height);
+    std::vector<PathCost> costs;
+    std::vector<PathCost> minCosts(numCells, UnreachableLandmarkCost);
+    std::vector<std::vector<PathCost>> fromLandmarks;
+    std::vector<std::vector<PathCost>> toLandmarks;
+
+    int32_t landmark = -1;
+    if (seed >= 0)
+    {
+        ComputeCosts(steps, width, height, seed, true, UnreachableLandmarkCost, costs);
+        landmark = FindFarthestCell(costs, UnreachableLandmarkCost);
+        landmark = landmark >= 0 ? landmark : seed;
+    }
+
+    while (landmark >= 0 && static_cast<int32_t>(tables->Landmarks.size()) < numLandmarks)
+    {
+        tables->Landmarks.push_back({landmark % width, landmark / width});
+
+        ComputeCosts(steps, width, height, landmark, true, UnreachableLandmarkCost, costs);
+        for (size_t cell = 0; cell < numCells; ++cell)
+        {
+            minCosts[cell] = std::min(minCosts[cell], costs[cell]);
+        }
+        fromLandmarks.push_back(costs);
+
+        if (!bUniform)
+        {
+            ComputeCosts(steps, width, height, landmark, false, UnreachableLandmarkCost, costs);
+            toLandmarks.push_back(costs);
+        }
+
+        /* Next landmark is cell farthest from all picked so far, none when every cell is landmark */
+        landmark = FindFarthestCell(minCosts, UnreachableLandmarkCost);
+    }
+
+    /* Interleave tables, so bounds of one cell are read from single cache line */
+    int32_t count = static_cast<int32_t>(tables->Landmarks.size());
+    tables->NumLandmarks = count;
+    tables->FromLandmarks.resize(numCells * count);
+    tables->ToLandmarks.resize(bUniform ? 0 : numCells * count);
+
+    for (size_t cell = 0; cell < numCells; ++cell)
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            tables->FromLandmarks[cell * count + i] = fromLandmarks[i][cell];
+
+            if (!bUniform)
+            {
+                tables->ToLandmarks[cell * count + i] = toLandmarks[i][cell];
+            }
+        }
+    }
+
+    tables->BuildTimeMs = GetElapsedMs(start);
+    return tables;
+}
+
+void LandmarkTable::SetTables(std::shared_ptr<const Tables> tables)
+{
+    m_Tables = std::move(tables);
+    m_CheckedRevision = m_Tables->Revision;
+    m_bStale = false;
+    m_bAdmissible = true;
+}
+
+void LandmarkTable::CheckChanges(const IMap& map)
+{
+    if (!m_Tables || m_CheckedRevision == map.GetRevision())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Tables->Width, m_Tables->Height, m_CheckedRevision, m_Changes))
+    {
+        m_bStale = true;
+        m_bAdmissible = false;
+    }
+    else
+    {
+        for (glm::ivec2 position : m_Changes)
+        {
+            uint8_t oldStepCost = m_Tables->StepCosts[position.x + position.y * m_Tables->Width];
+            uint8_t newStepCost = GetStepCost(map, position);
+
+            if (oldStepCost == newStepCost)
+            {
+                continue;
+            }
+
+            m_bStale = true;
+
+            /* Cell that got passable or cheaper may shorten paths below bounds stored in tables */
+            if (oldStepCost == 0 || (newStepCost != 0 && newStepCost < oldStepCost))
+            {
+                m_bAdmissible = false;
+            }
+        }
+    }
+
+    m_CheckedRevision = map.GetRevision();
+}
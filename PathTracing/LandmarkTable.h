@@ -0,0 +1,130 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "Neighborhood.h"
+
+#include <climits>
+#include <future>
+#include <memory>
+#include <vector>
+
+constexpr int32_t DefaultNumLandmarks = 8;
+
+/* Precomputed costs between few landmark cells and every other cell on
+   4-connected grid, used as lower bounds for A* (ALT). By triangle
+   inequality d(a, b) >= d(L, b) - d(L, a) and d(a, b) >= d(a, L) - d(b, L)
+   for every landmark L, so largest of these bounds is consistent heuristic.
+   Landmarks are picked one by one as cell farthest from landmarks picked
+   so far, which places them at map borders and dead ends. Only obstacles
+   block tables, so agents walking around do not make them stale.
+
+   Tables follow map edits through Update, which rebuilds them on another
+   thread. Old tables stay in use meanwhile as long as edits only made cells
+   more expensive or blocked, which can not break their lower bounds */
+class LandmarkTable
+{
+public:
+    explicit LandmarkTable(int32_t numLandmarks = DefaultNumLandmarks);
+
+    /* Builds tables on calling thread */
+    void Build(const IMap& map);
+
+    /* Takes over tables built in background, starts new build when map edits made current ones stale */
+    void Update(const IMap& map);
+
+    /* Lower bound of cost from a to b, tables must be usable */
+    PathCost GetLowerBound(PathFindingPoint a, PathFindingPoint b) const
+    {
+        const Tables& tables = *m_Tables;
+        const PathCost* fromA = tables.FromLandmarks.data() + GetCellOffset(a);
+        const PathCost* fromB = tables.FromLandmarks.data() + GetCellOffset(b);
+
+        /* On uniform terrain costs are symmetric, so both directions share one table */
+        const std::vector<PathCost>& toLandmarks = tables.ToLandmarks.empty() ? tables.FromLandmarks : tables.ToLandmarks;
+        const PathCost* toA = toLandmarks.data() + GetCellOffset(a);
+        const PathCost* toB = toLandmarks.data() + GetCellOffset(b);
+
+        PathCost bound = 0;
+
+        for (int32_t i = 0; i < tables.NumLandmarks; ++i)
+        {
+            /* Landmark in another component than both cells says nothing about them */
+            if (fromA[i] != UnreachableLandmarkCost && fromB[i] != UnreachableLandmarkCost)
+            {
+                bound = std::max(bound, std::max(fromB[i] - fromA[i], toA[i] - toB[i]));
+            }
+        }
+
+        return bound;
+    }
+
+    /* True when tables exist and their bounds hold for map seen by last Update */
+    bool IsUsable() const;
+
+    bool IsBuilt() const;
+    bool IsRebuilding() const;
+
+    const std::vector<PathFindingPoint>& GetLandmarks() const;
+    size_t GetMemoryUsage() const;
+    double GetLastBuildTimeMs() const;
+
+private:
+    static constexpr PathCost UnreachableLandmarkCost = INT32_MAX;
+
+    /* Immutable result of single build, costs of cell are stored next to each other */
+    struct Tables
+    {
+        int32_t Width = 0;
+        int32_t Height = 0;
+        int32_t NumLandmarks = 0;
+        uint64_t Revision = 0;
+        double BuildTimeMs = 0.0;
+
+        /* Terrain cost of every cell tables were built for, zero for obstacles */
+        std::vector<uint8_t> StepCosts;
+        std::vector<PathFindingPoint> Landmarks;
+        std::vector<PathCost> FromLandmarks;
+
+        /* Empty when terrain is uniform and costs to landmarks equal costs from them */
+        std::vector<PathCost> ToLandmarks;
+    };
+
+    int32_t m_NumLandmarks;
+    std::shared_ptr<const Tables> m_Tables;
+    std::future<std::shared_ptr<const Tables>> m_PendingBuild;
+
+    /* Map revision edits were checked up to, and what they did to current tables */
+    uint64_t m_CheckedRevision = 0;
+    bool m_bStale = true;
+    bool m_bAdmissible = false;
+    std::vector<glm::ivec2> m_Changes;
+
+private:
+    size_t GetCellOffset(PathFindingPoint point) const
+    {
+        return (static_cast<size_t>(point.x) + static_cast<size_t>(point.y) * m_Tables->Width) * m_Tables->NumLandmarks;
+    }
+
+    static uint8_t GetStepCost(const IMap& map, PathFindingPoint point)
+    {
+        return map.GetFieldAt(point) == EFieldType::Obstacle ? 0 : map.GetTerrainCost(point);
+    }
+
+    static std::vector<uint8_t> GetStepCosts(const IMap& map);
+    static std::shared_ptr<const Tables> BuildTables(std::vector<uint8_t> stepCosts, int32_t width, int32_t height,
+        uint64_t revision, int32_t numLandmarks);
+
+    void SetTables(std::shared_ptr<const Tables> tables);
+    void CheckChanges(const IMap& map);
+};
+
+/* Largest of landmark lower bound and Manhattan distance, max of consistent heuristics is consistent too */
+struct LandmarkHeuristic
+{
+    const LandmarkTable* Table;
+
+    PathCost Evaluate(PathFindingPoint a, PathFindingPoint b) const
+    {
+        return std::max(ManhattanHeuristic::Evaluate(a, b), Table->GetLowerBound(a, b));
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+/* Any-angle path costs are Euclidean lengths scaled by that much, so they stay integer */
+constexpr PathCost AnyAngleCostScale = 100;
+
+inline PathCost GetEuclideanCost(PathFindingPoint a, PathFindingPoint b)
+{
+    PathFindingPoint delta = b - a;
+    return static_cast<PathCost>(std::lround(std::sqrt(static_cast<double>(delta.x * delta.x + delta.y * delta.y)) * AnyAngleCostScale));
+}
+
+/* Rounded down, so it never exceeds cost of path */
+struct EuclideanHeuristic
+{
+    static PathCost Evaluate(PathFindingPoint a, PathFindingPoint b)
+    {
+        PathFindingPoint delta = b - a;
+        return static_cast<PathCost>(std::sqrt(static_cast<double>(delta.x * delta.x + delta.y * delta.y)) * AnyAngleCostScale);
+    }
+};
+
+/*
+ * Straight line between two cells, walked one cell at a time. Every step moves
+ * one cell along longer axis, and also one cell along shorter axis whenever
+ * line crossed middle between two cells on it (Bresenham). Diagonal step passes
+ * by two cells and, like on 8-connected grid, needs both of them walkable.
+ *
+ * Cell after any step can be computed directly, so agents walking line between
+ * two waypoints do not have to store its cells. Line from a to b may differ from
+ * line from b to a, waypoints are always walked in order they were found in.
+ */
+
+/* Number of steps of line, cells of line are its steps plus starting cell */
+inline int32_t GetLineLength(PathFindingPoint from, PathFindingPoint to)
+{
+    return std::max(std::abs(to.x - from.x), std::abs(to.y - from.y));
+}
+
+inline PathFindingPoint GetLinePoint(PathFindingPoint from, PathFindingPoint to, int32_t step)
+{
+    int32_t dx = to.x - from.x;
+    int32_t dy = to.y - from.y;
+    int32_t major = std::max(std::abs(dx), std::abs(dy));
+    int32_t minor = std::min(std::abs(dx), std::abs(dy));
+
+    if (major == 0)
+    {
+        return from;
+    }
+
+    /* Offset on shorter axis is rounded, half way up */
+    int32_t minorOffset = (2 * step * minor + major) / (2 * major);
+    int32_t stepX = dx < 0 ? -1 : 1;
+    int32_t stepY = dy < 0 ? -1 : 1;
+
+    if (std::abs(dx) >= std::abs(dy))
+    {
+        return {from.x + stepX * step, from.y + stepY * minorOffset};
+    }
+
+    return {from.x + stepX * minorOffset, from.y + stepY * step};
+}
+
+/* Walks line from cell after start up to end, stops at first cell isWalkable(cellIndex) rejects */
+template<typename TIsWalkable>
+inline bool WalkLine(PathFindingPoint from, PathFindingPoint to, int32_t width, TIsWalkable&& isWalkable)
+{
+    int32_t dx = to.x - from.x;
+    int32_t dy = to.y - from.y;
+    bool bXMajor = std::abs(dx) >= std::abs(dy);
+    int32_t major = bXMajor ? std::abs(dx) : std::abs(dy);
+    int32_t minor = bXMajor ? std::abs(dy) : std::abs(dx);
+
+    /* Cell index moves by fixed amount along each axis */
+    int32_t stepX = dx < 0 ? -1 : 1;
+    int32_t stepY = dy < 0 ? -width : width;
+    int32_t majorStep = bXMajor ? stepX : stepY;
+    int32_t minorStep = bXMajor ? stepY : stepX;
+
+    int32_t index = from.x + from.y * width;
+
+    /* Twice the distance of line from middle of last cell on shorter axis, offset by half cell */
+    int32_t remainder = major;
+
+    for (int32_t step = 0; step < major; ++step)
+    {
+        remainder += 2 * minor;
+
+        if (remainder >= 2 * major)
+        {
+            remainder -= 2 * major;
+
+            /* Diagonal step, cells on both sides of it must be walkable */
+            if (!isWalkable(index + majorStep) || !isWalkable(index + minorStep))
+            {
+                return false;
+            }
+
+            index += minorStep;
+        }
+
+        index += majorStep;
+
+        if (!isWalkable(index))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* True when every cell of line after its start is walkable. Reads field buffer of map
+   when it has one. Both points must lie inside map, and so does whole line then */
+inline bool HasLineOfSight(const IMap& map, PathFindingPoint from, PathFindingPoint to)
+{
+    int32_t width = map.GetMapWidth();
+
+    if (const EFieldType* fields = map.GetFieldData())
+    {
+        return WalkLine(from, to, width, [fields](int32_t index)
+        {
+            return fields[index] == EFieldType::Empty || fields[index] == EFieldType::Goal;
+        });
+    }
+
+    return WalkLine(from, to, width, [&map, width](int32_t index)
+    {
+        EFieldType field = map.GetFieldAt({index % width, index / width});
+        return field == EFieldType::Empty || field == EFieldType::Goal;
+    });
+}
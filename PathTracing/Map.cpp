@@ -21,9 +21,11 @@ glm::vec4 GetColorForField(EFieldType field)
 
 Map::Map(int32_t width, int32_t height) :
     m_Fields(static_cast<size_t>(width* height), EFieldType::Empty),
+    m_TerrainCosts(static_cast<size_t>(width* height), DefaultTerrainCost),
     m_Width(width),
     m_Height(height)
 {
+    m_Components.Reset(width, height);
 }
 
 
@@ -50,10 +52,70 @@ EFieldType Map::GetFieldAt(glm::ivec2 gridPosition) const
     return m_Fields[gridPosition.x + gridPosition.y * m_Width];
 }
 
+const EFieldType* Map::GetFieldData() const
+{
+    return m_Fields.data();
+}
+
 void Map::SetField(glm::ivec2 gridPosition, EFieldType field)
 {
     int32_t index = gridPosition.x + gridPosition.y * m_Width;
+
+    if (m_Fields[index] == field)
+    {
+        return;
+    }
+
+    /* Agents and goals do not block each other in components, only obstacles split them */
+    bool bWasObstacle = m_Fields[index] == EFieldType::Obstacle;
     m_Fields[index] = field;
+
+    if (bWasObstacle != (field == EFieldType::Obstacle))
+    {
+        m_Components.SetPassable(gridPosition, bWasObstacle);
+    }
+
+    m_ChangeLog.LogChange(gridPosition);
+}
+
+uint8_t Map::GetTerrainCost(glm::ivec2 gridPosition) const
+{
+    return m_TerrainCosts[gridPosition.x + gridPosition.y * m_Width];
+}
+
+void Map::SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost)
+{
+    assert(cost >= DefaultTerrainCost);
+    uint8_t& currentCost = m_TerrainCosts[gridPosition.x + gridPosition.y * m_Width];
+
+    if (currentCost == cost)
+    {
+        return;
+    }
+
+    m_NumWeightedCells += (cost != DefaultTerrainCost) - (currentCost != DefaultTerrainCost);
+    currentCost = cost;
+    m_ChangeLog.LogChange(gridPosition);
+}
+
+const uint8_t* Map::GetTerrainCostData() const
+{
+    return m_TerrainCosts.data();
+}
+
+bool Map::HasUniformTerrainCost() const
+{
+    return m_NumWeightedCells == 0;
+}
+
+bool Map::AreConnected(glm::ivec2 a, glm::ivec2 b) const
+{
+    return m_Components.AreConnected(a, b);
+}
+
+const ComponentLabels* Map::GetComponentLabels() const
+{
+    return &m_Components;
 }
 
 bool Map::IsEmpty(glm::ivec2 gridPosition) const
@@ -71,6 +133,16 @@ int32_t Map::GetMapHeight() const
     return m_Height;
 }
 
+uint64_t Map::GetRevision() const
+{
+    return m_ChangeLog.GetRevision();
+}
+
+bool Map::GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const
+{
+    return m_ChangeLog.GetChangesSince(revision, outPositions);
+}
+
 FieldsByPositionIterator Map::begin() const
 {
     return FieldsByPositionIterator{this, glm::ivec2(0, 0)};
@@ -106,6 +178,13 @@ void Map::DrawCell(glm::ivec2 pos, EFieldType field)
         color = GetColorForField(EFieldType::Empty);
     }
 
+    /* Tint walkable cells towards brown the more expensive their terrain is */
+    if (field != EFieldType::Obstacle)
+    {
+        float weight = (GetTerrainCost(pos) - DefaultTerrainCost) / 254.0f;
+        color = glm::mix(color, glm::vec4{0.45f, 0.3f, 0.1f, 1.0f}, weight);
+    }
+
     /* Render bounds first */
     Renderer::DrawRect(glm::vec3{posX, posY, -1.0f},
         glm::vec3{CellSize, CellSize, 0.0f}, DrawCommandArgs{color * 0.4f});
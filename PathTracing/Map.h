@@ -2,6 +2,8 @@
 
 #include "MapInterface.h"
 #include "PathFindingAlgorithm.h"
+#include "ComponentLabels.h"
+#include "MapChangeLog.h"
 
 #include <vector>
 
@@ -22,12 +24,24 @@ public:
 public:
     virtual EFieldType GetFieldAt(glm::ivec2 gridPosition) const override;
     virtual void SetField(glm::ivec2 gridPosition, EFieldType field) override;
+    virtual const EFieldType* GetFieldData() const override;
 
     bool IsEmpty(glm::ivec2 gridPosition) const;
 
+    virtual uint8_t GetTerrainCost(glm::ivec2 gridPosition) const override;
+    virtual void SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost) override;
+    virtual const uint8_t* GetTerrainCostData() const override;
+    virtual bool HasUniformTerrainCost() const override;
+
+    virtual bool AreConnected(glm::ivec2 a, glm::ivec2 b) const override;
+    virtual const ComponentLabels* GetComponentLabels() const override;
+
     virtual int32_t GetMapWidth() const override;
     virtual int32_t GetMapHeight() const override;
 
+    virtual uint64_t GetRevision() const override;
+    virtual bool GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const override;
+
     virtual FieldsByPositionIterator begin() const override;
     virtual FieldsByPositionIterator end() const override;
 
@@ -39,10 +53,15 @@ private:
 
 private:
     std::vector<EFieldType> m_Fields;
+    std::vector<uint8_t> m_TerrainCosts;
+    size_t m_NumWeightedCells = 0;
+    ComponentLabels m_Components;
     int32_t m_Width;
     int32_t m_Height;
     float CellSize = 64.0f;
 
+    MapChangeLog m_ChangeLog;
+
 private:
     void DrawCell(glm::ivec2 pos, EFieldType field);
 };
@@ -0,0 +1,44 @@
+#include "MapChangeLog.h"
+
+#include <cassert>
+
+MapChangeLog::MapChangeLog(size_t capacity) :
+    m_Capacity(capacity)
+{
+    assert(capacity > 0);
+}
+
+void MapChangeLog::LogChange(glm::ivec2 gridPosition)
+{
+    if (m_Changes.size() < m_Capacity)
+    {
+        m_Changes.push_back(gridPosition);
+    }
+    else
+    {
+        m_Changes[m_Revision % m_Capacity] = gridPosition;
+    }
+
+    ++m_Revision;
+}
+
+bool MapChangeLog::GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const
+{
+    if (revision > m_Revision || m_Revision - revision > m_Changes.size())
+    {
+        return false;
+    }
+
+    for (uint64_t r = revision; r < m_Revision; ++r)
+    {
+        outPositions.push_back(m_Changes[r % m_Capacity]);
+    }
+
+    return true;
+}
+
+bool GetMapChangesSince(const IMap& map, int32_t width, int32_t height, uint64_t revision, std::vector<glm::ivec2>& outPositions)
+{
+    outPositions.clear();
+    return map.GetMapWidth() == width && map.GetMapHeight() == height && map.GetChangesSince(revision, outPositions);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "MapInterface.h"
+
+#include <vector>
+
+/* Revision and positions changed by last edits of map. Every edit grows revision
+   by one, change made at revision r is stored at (r - 1) % capacity of ring buffer */
+class MapChangeLog
+{
+public:
+    static constexpr size_t DefaultCapacity = 4096;
+
+    explicit MapChangeLog(size_t capacity = DefaultCapacity);
+
+    void LogChange(glm::ivec2 gridPosition);
+
+    uint64_t GetRevision() const
+    {
+        return m_Revision;
+    }
+
+    /* Appends positions changed after given revision in order they were changed,
+       false when revision is in the future or older than buffer remembers */
+    bool GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const;
+
+private:
+    std::vector<glm::ivec2> m_Changes;
+    size_t m_Capacity;
+    uint64_t m_Revision = 0;
+};
+
+/* Replaces outPositions with positions map changed after given revision. False when
+   caller built its data for other width x height or map does not remember that far,
+   caller has to rebuild from whole map then */
+bool GetMapChangesSince(const IMap& map, int32_t width, int32_t height, uint64_t revision, std::vector<glm::ivec2>& outPositions);
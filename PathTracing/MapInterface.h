@@ -3,6 +3,10 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
+
+/* Cost of entering cell with default terrain, costs range from it up to 255 */
+constexpr uint8_t DefaultTerrainCost = 1;
 
 enum class EFieldType : uint8_t
 {
@@ -49,9 +53,47 @@ public:
     virtual EFieldType GetFieldAt(glm::ivec2 gridPosition) const = 0;
     virtual void SetField(glm::ivec2 gridPosition, EFieldType field) = 0;
 
+    /* Fields row by row, x + y * width, for scans reading many cells in a row. Maps not
+       keeping fields in single buffer return nullptr, and callers fall back to GetFieldAt */
+    virtual const EFieldType* GetFieldData() const
+    {
+        return nullptr;
+    }
+
+    /* Cost of entering cell, independent of field type standing on it */
+    virtual uint8_t GetTerrainCost(glm::ivec2 gridPosition) const = 0;
+    virtual void SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost) = 0;
+
+    /* Terrain costs in the same layout as GetFieldData, nullptr when map does not keep them in single buffer */
+    virtual const uint8_t* GetTerrainCostData() const
+    {
+        return nullptr;
+    }
+
+    /* True when every cell has DefaultTerrainCost, searches relying on uniform step cost check it */
+    virtual bool HasUniformTerrainCost() const = 0;
+
+    /* False when no 4 or 8-connected path joins both cells. Answered from component
+       labels kept up to date by SetField, so searches can reject walled off goals at once */
+    virtual bool AreConnected(glm::ivec2 a, glm::ivec2 b) const = 0;
+
+    /* Labels AreConnected answers from, nullptr when map does not keep them */
+    virtual const class ComponentLabels* GetComponentLabels() const
+    {
+        return nullptr;
+    }
+
     virtual int32_t GetMapWidth() const = 0;
     virtual int32_t GetMapHeight() const = 0;
 
+    /* Revision grows by one with every field or terrain cost change */
+    virtual uint64_t GetRevision() const = 0;
+
+    /* Appends positions changed after given revision (possibly with repeats).
+       Returns false when changes are older than map remembers, in which case
+       caller must treat whole map as changed */
+    virtual bool GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const = 0;
+
     virtual FieldsByPositionIterator begin() const = 0;
     virtual FieldsByPositionIterator end() const = 0;
 
@@ -0,0 +1,165 @@
+#include "MapSnapshot.h"
+#include "ComponentLabels.h"
+#include "MapChangeLog.h"
+
+#include <cassert>
+
+MapSnapshot::MapSnapshot(const IMap& map, const MapSnapshot* previous) :
+    m_bUniformTerrainCost(map.HasUniformTerrainCost()),
+    m_Width(map.GetMapWidth()),
+    m_Height(map.GetMapHeight()),
+    m_Revision(map.GetRevision()),
+    m_CellSize(map.GetCellSize())
+{
+    size_t numCells = static_cast<size_t>(m_Width) * m_Height;
+
+    if (const EFieldType* fields = map.GetFieldData())
+    {
+        m_Fields.assign(fields, fields + numCells);
+    }
+    else
+    {
+        m_Fields.reserve(numCells);
+
+        for (int32_t y = 0; y < m_Height; ++y)
+        {
+            for (int32_t x = 0; x < m_Width; ++x)
+            {
+                m_Fields.push_back(map.GetFieldAt({x, y}));
+            }
+        }
+    }
+
+    /* Edits unknown to change log may have touched anything */
+    std::vector<glm::ivec2> changes;
+    bool bTerrainChanged = true;
+    bool bComponentsChanged = true;
+
+    if (previous && GetMapChangesSince(map, previous->m_Width, previous->m_Height, previous->m_Revision, changes))
+    {
+        bTerrainChanged = false;
+        bComponentsChanged = false;
+
+        for (glm::ivec2 position : changes)
+        {
+            int32_t index = position.x + position.y * m_Width;
+            bTerrainChanged |= (*previous->m_TerrainCosts)[index] != map.GetTerrainCost(position);
+            bComponentsChanged |= (previous->m_Fields[index] == EFieldType::Obstacle) != (m_Fields[index] == EFieldType::Obstacle);
+        }
+    }
+
+    if (!bTerrainChanged)
+    {
+        m_TerrainCosts = previous->m_TerrainCosts;
+    }
+    else if (const uint8_t* terrainCosts = map.GetTerrainCostData())
+    {
+        m_TerrainCosts = std::make_shared<const std::vector<uint8_t>>(terrainCosts, terrainCosts + numCells);
+    }
+    else
+    {
+        auto copiedCosts = std::make_shared<std::vector<uint8_t>>();
+        copiedCosts->reserve(numCells);
+
+        for (int32_t y = 0; y < m_Height; ++y)
+        {
+            for (int32_t x = 0; x < m_Width; ++x)
+            {
+                copiedCosts->push_back(map.GetTerrainCost({x, y}));
+            }
+        }
+
+        m_TerrainCosts = std::move(copiedCosts);
+    }
+
+    if (!bComponentsChanged)
+    {
+        m_Components = previous->m_Components;
+    }
+    else
+    {
+        auto components = std::make_shared<std::vector<int32_t>>();
+        if (const ComponentLabels* labels = map.GetComponentLabels())
+        {
+            labels->GetComponents(*components);
+        }
+
+        m_Components = std::move(components);
+    }
+}
+
+EFieldType MapSnapshot::GetFieldAt(glm::ivec2 gridPosition) const
+{
+    return m_Fields[gridPosition.x + gridPosition.y * m_Width];
+}
+
+const EFieldType* MapSnapshot::GetFieldData() const
+{
+    return m_Fields.data();
+}
+
+void MapSnapshot::SetField(glm::ivec2, EFieldType)
+{
+    assert(false && "Map snapshot can not be modified");
+}
+
+uint8_t MapSnapshot::GetTerrainCost(glm::ivec2 gridPosition) const
+{
+    return (*m_TerrainCosts)[gridPosition.x + gridPosition.y * m_Width];
+}
+
+void MapSnapshot::SetTerrainCost(glm::ivec2, uint8_t)
+{
+    assert(false && "Map snapshot can not be modified");
+}
+
+bool MapSnapshot::HasUniformTerrainCost() const
+{
+    return m_bUniformTerrainCost;
+}
+
+bool MapSnapshot::AreConnected(glm::ivec2 a, glm::ivec2 b) const
+{
+    if (m_Components->empty())
+    {
+        return true;
+    }
+
+    int32_t component = (*m_Components)[a.x + a.y * m_Width];
+    return component != InvalidComponent && component == (*m_Components)[b.x + b.y * m_Width];
+}
+
+int32_t MapSnapshot::GetMapWidth() const
+{
+    return m_Width;
+}
+
+int32_t MapSnapshot::GetMapHeight() const
+{
+    return m_Height;
+}
+
+uint64_t MapSnapshot::GetRevision() const
+{
+    return m_Revision;
+}
+
+bool MapSnapshot::GetChangesSince(uint64_t revision, std::vector<glm::ivec2>&) const
+{
+    return revision == m_Revision;
+}
+
+FieldsByPositionIterator MapSnapshot::begin() const
+{
+    return FieldsByPositionIterator{this, glm::ivec2(0, 0)};
+}
+
+FieldsByPositionIterator MapSnapshot::end() const
+{
+    return FieldsByPositionIterator{this, glm::ivec2(0, m_Height)};
+}
+
+float MapSnapshot::GetCellSize() const
+{
+    return m_CellSize;
+}
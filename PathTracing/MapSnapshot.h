@@ -0,0 +1,55 @@
+#pragma once
+
+#include "MapInterface.h"
+
+#include <memory>
+#include <vector>
+
+/* Read only copy of fields, terrain costs and components of map, taken on main
+   thread so that searches on other threads never race with map edits. Snapshot
+   has no change log, so GetChangesSince only knows that nothing changed since
+   snapshot. Snapshot of map without component labels answers AreConnected with true */
+class MapSnapshot : public IMap
+{
+public:
+    /* Fields are copied every time, as agents moving around change them. Terrain costs and
+       components no edit since previous snapshot touched are shared with it instead */
+    explicit MapSnapshot(const IMap& map, const MapSnapshot* previous = nullptr);
+
+public:
+    virtual EFieldType GetFieldAt(glm::ivec2 gridPosition) const override;
+    virtual const EFieldType* GetFieldData() const override;
+
+    /* Snapshot is immutable, setters only assert */
+    virtual void SetField(glm::ivec2 gridPosition, EFieldType field) override;
+
+    virtual uint8_t GetTerrainCost(glm::ivec2 gridPosition) const override;
+    virtual void SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost) override;
+    virtual bool HasUniformTerrainCost() const override;
+
+    virtual bool AreConnected(glm::ivec2 a, glm::ivec2 b) const override;
+
+    virtual int32_t GetMapWidth() const override;
+    virtual int32_t GetMapHeight() const override;
+
+    /* Revision of map snapshot was taken at */
+    virtual uint64_t GetRevision() const override;
+    virtual bool GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const override;
+
+    virtual FieldsByPositionIterator begin() const override;
+    virtual FieldsByPositionIterator end() const override;
+
+    virtual float GetCellSize() const override;
+
+private:
+    std::vector<EFieldType> m_Fields;
+    std::shared_ptr<const std::vector<uint8_t>> m_TerrainCosts;
+
+    /* Component of every cell, empty when map has no labels */
+    std::shared_ptr<const std::vector<int32_t>> m_Components;
+    bool m_bUniformTerrainCost;
+    int32_t m_Width;
+    int32_t m_Height;
+    uint64_t m_Revision;
+    float m_CellSize;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+/* Costs of straight and diagonal moves on 8-connected grid, integer approximation of 1 : sqrt(2) */
+constexpr PathCost OctileStraightCost = 10;
+constexpr PathCost OctileDiagonalCost = 14;
+
+/* Single move of neighborhood, relative to cell it starts from */
+struct NeighborOffset
+{
+    int32_t X;
+    int32_t Y;
+    PathCost Cost;
+};
+
+/* Heuristics assume cheapest terrain, so they stay admissible on weighted maps */
+struct ManhattanHeuristic
+{
+    static PathCost Evaluate(PathFindingPoint a, PathFindingPoint b)
+    {
+        return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+    }
+};
+
+/* Exact distance on empty 8-connected grid */
+struct OctileHeuristic
+{
+    static PathCost Evaluate(PathFindingPoint a, PathFindingPoint b)
+    {
+        int32_t dx = std::abs(a.x - b.x);
+        int32_t dy = std::abs(a.y - b.y);
+
+        return OctileStraightCost * std::max(dx, dy) + (OctileDiagonalCost - OctileStraightCost) * std::min(dx, dy);
+    }
+};
+
+/* Exact distance on empty hex grid in "odd-r" layout, where odd rows are shifted half cell right */
+struct HexHeuristic
+{
+    static PathCost Evaluate(PathFindingPoint a, PathFindingPoint b)
+    {
+        /* Axial coordinates, third cube coordinate is implied by -q - r */
+        int32_t dq = (a.x - (a.y - (a.y & 1)) / 2) - (b.x - (b.y - (b.y & 1)) / 2);
+        int32_t dr = a.y - b.y;
+
+        return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2;
+    }
+};
+
+/* Neighborhoods describe moves allowed from cell. Every one provides
+   NumNeighbors, GetOffset returning move by index and CanMove, which is
+   called for cells inside map only when target cell is walkable */
+struct FourConnected
+{
+    typedef ManhattanHeuristic DefaultHeuristic;
+
+    static constexpr size_t NumNeighbors = 4;
+    static constexpr NeighborOffset Offsets[NumNeighbors] = {
+        {-1, 0, 1}, {1, 0, 1}, {0, -1, 1}, {0, 1, 1}
+    };
+
+    static constexpr NeighborOffset GetOffset(PathFindingPoint, size_t index)
+    {
+        return Offsets[index];
+    }
+
+    static bool CanMove(const IMap&, PathFindingPoint, NeighborOffset)
+    {
+        return true;
+    }
+};
+
+/* Diagonal move is allowed only when both cells it passes by are walkable, so path never cuts corners.
+   Costs are scaled by OctileStraightCost, so diagonal moves can have integer cost too */
+struct EightConnected
+{
+    typedef OctileHeuristic DefaultHeuristic;
+
+    static constexpr size_t NumNeighbors = 8;
+    static constexpr NeighborOffset Offsets[NumNeighbors] = {
+        {-1, 0, OctileStraightCost}, {1, 0, OctileStraightCost}, {0, -1, OctileStraightCost}, {0, 1, OctileStraightCost},
+        {-1, -1, OctileDiagonalCost}, {1, -1, OctileDiagonalCost}, {-1, 1, OctileDiagonalCost}, {1, 1, OctileDiagonalCost}
+    };
+
+    static constexpr NeighborOffset GetOffset(PathFindingPoint, size_t index)
+    {
+        return Offsets[index];
+    }
+
+    static bool CanMove(const IMap& map, PathFindingPoint from, NeighborOffset offset)
+    {
+        return offset.X == 0 || offset.Y == 0 ||
+            (IsWalkable({from.x + offset.X, from.y}, &map) && IsWalkable({from.x, from.y + offset.Y}, &map));
+    }
+};
+
+/* Hex grid stored row by row in "odd-r" layout. Diagonal neighbors lie on
+   different side for even and odd rows, so table is picked by row parity */
+struct HexConnected
+{
+    typedef HexHeuristic DefaultHeuristic;
+
+    static constexpr size_t NumNeighbors = 6;
+    static constexpr NeighborOffset Offsets[2][NumNeighbors] = {
+        {{-1, 0, 1}, {1, 0, 1}, {-1, -1, 1}, {0, -1, 1}, {-1, 1, 1}, {0, 1, 1}},
+        {{-1, 0, 1}, {1, 0, 1}, {0, -1, 1}, {1, -1, 1}, {0, 1, 1}, {1, 1, 1}}
+    };
+
+    static constexpr NeighborOffset GetOffset(PathFindingPoint point, size_t index)
+    {
+        return Offsets[point.y & 1][index];
+    }
+
+    static bool CanMove(const IMap&, PathFindingPoint, NeighborOffset)
+    {
+        return true;
+    }
+};
+
+/* Calls func(neighbor, stepCost) for every allowed move from point, stops early when func returns false.
+   Step cost is move cost times terrain cost of neighbor.
+   Loop over neighbors is unrolled at compile time, so every offset is a constant in its own call */
+template<typename TNeighborhood, typename Func>
+inline bool ForEachNeighbor(const IMap& map, PathFindingPoint point, Func&& func)
+{
+    auto visit = [&](NeighborOffset offset)
+    {
+        PathFindingPoint neighbor{point.x + offset.X, point.y + offset.Y};
+
+        if (!IsWalkable(neighbor, &map) || !TNeighborhood::CanMove(map, point, offset))
+        {
+            return true;
+        }
+
+        return func(neighbor, offset.Cost * map.GetTerrainCost(neighbor));
+    };
+
+    return [&]<size_t... Indices>(std::index_sequence<Indices...>)
+    {
+        return (visit(TNeighborhood::GetOffset(point, Indices)) && ...);
+    }(std::make_index_sequence<TNeighborhood::NumNeighbors>{});
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Arena handing out objects from fixed size pages. Pages are allocated on
+   demand and kept after Reset, so consecutive searches of similar size do
+   not touch the system allocator at all. Number of bytes handed out between
+   two Resets is limited by budget, Allocate returns nullptr when exceeded */
+template<typename T>
+class PagedArena
+{
+    static_assert(std::is_trivially_destructible_v<T>, "PagedArena never calls destructors");
+
+public:
+    explicit PagedArena(size_t itemsPerPage = 4096) :
+        m_ItemsPerPage(itemsPerPage)
+    {
+    }
+
+    ~PagedArena() noexcept
+    {
+        for (T* page : m_Pages)
+        {
+            operator delete(page);
+        }
+    }
+
+    PagedArena(const PagedArena&) = delete;
+    PagedArena& operator=(const PagedArena&) = delete;
+
+    template<typename... Args>
+    T* Allocate(Args&&... args)
+    {
+        if ((m_NumAllocated + 1) * sizeof(T) > m_Budget)
+        {
+            return nullptr;
+        }
+
+        if (m_CurrentOffset == m_ItemsPerPage)
+        {
+            ++m_CurrentPage;
+            m_CurrentOffset = 0;
+        }
+
+        if (m_CurrentPage == m_Pages.size())
+        {
+            m_Pages.push_back(static_cast<T*>(operator new(sizeof(T) * m_ItemsPerPage)));
+        }
+
+        T* item = m_Pages[m_CurrentPage] + m_CurrentOffset;
+        ++m_CurrentOffset;
+        ++m_NumAllocated;
+
+        return new (item) T(std::forward<Args>(args)...);
+    }
+
+    /* Makes all pages available again, previously allocated objects become invalid */
+    void Reset()
+    {
+        m_CurrentPage = 0;
+        m_CurrentOffset = 0;
+        m_NumAllocated = 0;
+    }
+
+    void SetBudget(size_t budgetInBytes)
+    {
+        m_Budget = budgetInBytes;
+    }
+
+    size_t GetBudget() const
+    {
+        return m_Budget;
+    }
+
+    size_t GetUsedBytes() const
+    {
+        return m_NumAllocated * sizeof(T);
+    }
+
+    size_t GetReservedBytes() const
+    {
+        return m_Pages.size() * m_ItemsPerPage * sizeof(T);
+    }
+
+private:
+    std::vector<T*> m_Pages;
+    size_t m_ItemsPerPage;
+    size_t m_CurrentPage = 0;
+    size_t m_CurrentOffset = 0;
+    size_t m_NumAllocated = 0;
+    size_t m_Budget = SIZE_MAX;
+};
@@ -0,0 +1,242 @@
+#include "PathCache.h"
+#include "MapChangeLog.h"
+#include "Neighborhood.h"
+
+#include <algorithm>
+
+/* Lowest cost of path from start to goal that could use point, either entering it
+   or, on 8-connected grid, moving diagonally past it */
+static PathCost GetLowestCostThrough(ENeighborhood neighborhood, PathFindingPoint start, PathFindingPoint point,
+    PathFindingPoint goal)
+{
+    switch (neighborhood)
+    {
+    case ENeighborhood::Eight:
+        /* Diagonal move past point leaves and enters its neighbors, each straight step away from it */
+        return OctileHeuristic::Evaluate(start, point) + OctileHeuristic::Evaluate(point, goal) -
+            (2 * OctileStraightCost - OctileDiagonalCost);
+    case ENeighborhood::Hex:
+        return HexHeuristic::Evaluate(start, point) + HexHeuristic::Evaluate(point, goal);
+    case ENeighborhood::Four:
+    default:
+        return ManhattanHeuristic::Evaluate(start, point) + ManhattanHeuristic::Evaluate(point, goal);
+    }
+}
+
+static PathCost GetMoveCost(ENeighborhood neighborhood, PathFindingPoint from, PathFindingPoint to)
+{
+    if (neighborhood != ENeighborhood::Eight)
+    {
+        return 1;
+    }
+
+    return (from.x != to.x && from.y != to.y) ? OctileDiagonalCost : OctileStraightCost;
+}
+
+size_t PathCache::KeyHash::operator()(const Key& key) const
+{
+    std::hash<PathFindingPoint> hashPoint;
+    size_t hash = hashPoint(key.Start);
+    hash ^= hashPoint(key.Goal) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+
+    hash ^= std::hash<float>{}(key.SuboptimalityBound) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+
+    return hash ^ (static_cast<size_t>(key.Mode) << 8 | static_cast<size_t>(key.Neighborhood));
+}
+
+PathCache::PathCache(size_t capacity) :
+    m_Capacity(capacity)
+{
+}
+
+void PathCache::Update(const IMap& map)
+{
+    if (m_Revision == map.GetRevision() && m_Width == map.GetMapWidth() && m_Height == map.GetMapHeight())
+    {
+        return;
+    }
+
+    if (!GetMapChangesSince(map, m_Width, m_Height, m_Revision, m_Changes))
+    {
+        m_Stats.Invalidations += m_Entries.size();
+        Clear();
+
+        m_Width = map.GetMapWidth();
+        m_Height = map.GetMapHeight();
+        m_Revision = map.GetRevision();
+        return;
+    }
+
+    m_Revision = map.GetRevision();
+
+    std::sort(m_Changes.begin(), m_Changes.end(), [](glm::ivec2 a, glm::ivec2 b)
+    {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    m_Changes.erase(std::unique(m_Changes.begin(), m_Changes.end()), m_Changes.end());
+
+    for (auto entry = m_Entries.begin(); entry != m_Entries.end();)
+    {
+        auto next = std::next(entry);
+
+        bool bAffected = std::any_of(m_Changes.begin(), m_Changes.end(), [&](glm::ivec2 position)
+        {
+            return IsAffectedBy(*entry, map, position);
+        });
+
+        if (bAffected)
+        {
+            Erase(entry);
+            ++m_Stats.Invalidations;
+        }
+
+        entry = next;
+    }
+}
+
+const CompactPath* PathCache::Find(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode, ENeighborhood neighborhood,
+    float suboptimalityBound, bool bCountMiss)
+{
+    auto found = m_Lookup.find(Key{start, goal, mode, neighborhood, suboptimalityBound});
+
+    if (found == m_Lookup.end())
+    {
+        if (bCountMiss)
+        {
+            ++m_Stats.Misses;
+        }
+
+        return nullptr;
+    }
+
+    ++m_Stats.Hits;
+    m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+
+    return &found->second->CachedPath;
+}
+
+void PathCache::Insert(const IMap& map, PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+    ENeighborhood neighborhood, const CompactPath& path, float suboptimalityBound)
+{
+    if (m_Capacity == 0 || path.empty())
+    {
+        return;
+    }
+
+    Key key{start, goal, mode, neighborhood, suboptimalityBound};
+    auto found = m_Lookup.find(key);
+
+    if (found != m_Lookup.end())
+    {
+        Erase(found->second);
+    }
+    else if (m_Entries.size() >= m_Capacity)
+    {
+        Erase(std::prev(m_Entries.end()));
+        ++m_Stats.Evictions;
+    }
+
+    Entry entry;
+    entry.EntryKey = key;
+    entry.CachedPath = path;
+    entry.Min = path.front();
+    entry.Max = path.front();
+
+    /* Start cell is left, not entered, so path depends only on cells after it */
+    PathFindingPoint from = path.front();
+
+    for (auto point = std::next(path.begin()); point != path.end(); ++point)
+    {
+        PathFindingPoint to = *point;
+
+        entry.Cost += GetMoveCost(neighborhood, from, to) * map.GetTerrainCost(to);
+        entry.Cells.push_back(to.x + to.y * m_Width);
+
+        /* Diagonal move needs both cells it passes by to stay walkable, on 4-connected grid
+           only lines between any-angle waypoints take such steps */
+        if (neighborhood != ENeighborhood::Hex && from.x != to.x && from.y != to.y)
+        {
+            entry.Cells.push_back(to.x + from.y * m_Width);
+            entry.Cells.push_back(from.x + to.y * m_Width);
+        }
+
+        from = to;
+    }
+
+    for (int32_t cellIndex : entry.Cells)
+    {
+        PathFindingPoint point{cellIndex % m_Width, cellIndex / m_Width};
+        entry.Min = glm::min(entry.Min, point);
+        entry.Max = glm::max(entry.Max, point);
+    }
+
+    std::sort(entry.Cells.begin(), entry.Cells.end());
+    entry.Cells.erase(std::unique(entry.Cells.begin(), entry.Cells.end()), entry.Cells.end());
+
+    m_Entries.push_front(std::move(entry));
+    m_Lookup.emplace(key, m_Entries.begin());
+}
+
+void PathCache::Clear()
+{
+    m_Entries.clear();
+    m_Lookup.clear();
+}
+
+void PathCache::SetCapacity(size_t capacity)
+{
+    m_Capacity = capacity;
+
+    while (m_Entries.size() > m_Capacity)
+    {
+        Erase(std::prev(m_Entries.end()));
+        ++m_Stats.Evictions;
+    }
+}
+
+size_t PathCache::GetCapacity() const
+{
+    return m_Capacity;
+}
+
+size_t PathCache::GetSize() const
+{
+    return m_Entries.size();
+}
+
+const PathCacheStats& PathCache::GetStats() const
+{
+    return m_Stats;
+}
+
+void PathCache::ResetStats()
+{
+    m_Stats = PathCacheStats{};
+}
+
+bool PathCache::IsAffectedBy(const Entry& entry, const IMap& map, PathFindingPoint point) const
+{
+    const Key& key = entry.EntryKey;
+
+    if (point == key.Start)
+    {
+        return false;
+    }
+
+    /* Cell path depends on got blocked or more expensive */
+    if (point.x >= entry.Min.x && point.x <= entry.Max.x && point.y >= entry.Min.y && point.y <= entry.Max.y &&
+        std::binary_search(entry.Cells.begin(), entry.Cells.end(), point.x + point.y * m_Width))
+    {
+        return true;
+    }
+
+    /* Cell that got walkable or cheaper may offer shorter path, but only when even
+       straight line through it would be cheaper than cached path */
+    return IsWalkable(point, &map) && GetLowestCostThrough(key.Neighborhood, key.Start, point, key.Goal) < entry.Cost;
+}
+
+void PathCache::Erase(std::list<Entry>::iterator entry)
+{
+    m_Lookup.erase(entry->EntryKey);
+    m_Entries.erase(entry);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "CompactPath.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+constexpr size_t DefaultPathCacheCapacity = 256;
+
+struct PathCacheStats
+{
+    size_t Hits = 0;
+    size_t Misses = 0;
+
+    /* Entries dropped to make room for new ones */
+    size_t Evictions = 0;
+
+    /* Entries dropped because map edit could change their path */
+    size_t Invalidations = 0;
+};
+
+/* Least recently used cache of found paths keyed by start, goal, mode,
+   neighborhood and suboptimality bound of bounded suboptimal modes. Cache follows map edits through Update. Edited cell drops
+   only paths it could change: paths entering it or passing by it diagonally,
+   and, when cell is walkable now, paths whose cost exceeds lowest possible
+   cost of path through it. Open list is not part of key, as it does not
+   change path cost */
+class PathCache
+{
+public:
+    explicit PathCache(size_t capacity = DefaultPathCacheCapacity);
+
+    /* Drops entries affected by map edits made since last call, all of them
+       when map size changed or its change log does not reach that far */
+    void Update(const IMap& map);
+
+    /* Returns cached path or nullptr, pointer is valid until next call to non const method.
+       Caller trying another key after miss passes bCountMiss false, so lookup counts once */
+    const CompactPath* Find(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode, ENeighborhood neighborhood,
+        float suboptimalityBound = 1.0f, bool bCountMiss = true);
+
+    /* Path must be found on map in state seen by last Update */
+    void Insert(const IMap& map, PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+        ENeighborhood neighborhood, const CompactPath& path, float suboptimalityBound = 1.0f);
+
+    void Clear();
+
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const;
+    size_t GetSize() const;
+
+    const PathCacheStats& GetStats() const;
+    void ResetStats();
+
+private:
+    struct Key
+    {
+        PathFindingPoint Start;
+        PathFindingPoint Goal;
+        EPathFindingMode Mode;
+        ENeighborhood Neighborhood;
+        float SuboptimalityBound;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Key EntryKey;
+        CompactPath CachedPath;
+        PathCost Cost = 0;
+
+        /* Sorted indices of cells path depends on, with bounding box of them */
+        std::vector<int32_t> Cells;
+        PathFindingPoint Min;
+        PathFindingPoint Max;
+    };
+
+    size_t m_Capacity;
+
+    /* Most recently used entry is at front */
+    std::list<Entry> m_Entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_Lookup;
+
+    int32_t m_Width = 0;
+    int32_t m_Height = 0;
+    uint64_t m_Revision = 0;
+    std::vector<glm::ivec2> m_Changes;
+
+    PathCacheStats m_Stats;
+
+private:
+    bool IsAffectedBy(const Entry& entry, const IMap& map, PathFindingPoint point) const;
+    void Erase(std::list<Entry>::iterator entry);
+};
@@ -0,0 +1,483 @@
+#include "PathFinder.h"
+#include "LineOfSight.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+PathFinder::PathFinder()
+{
+    m_NodeArena.SetBudget(DefaultSearchMemoryBudget);
+}
+
+void PathFinder::SetSearchMemoryBudget(size_t budgetInBytes)
+{
+    m_NodeArena.SetBudget(budgetInBytes);
+}
+
+size_t PathFinder::GetSearchMemoryBudget() const
+{
+    return m_NodeArena.GetBudget();
+}
+
+void PathFinder::SetMemoryBoundedExpansionLimit(size_t maxExpansions)
+{
+    m_MemoryBoundedExpansionLimit = maxExpansions;
+}
+
+size_t PathFinder::GetLastSearchMemoryUsage() const
+{
+    if (m_MemoryBoundedPeakUsage > 0)
+    {
+        return m_MemoryBoundedPeakUsage;
+    }
+
+    return m_Records.size() * sizeof(SearchRecord) + m_NodeArena.GetUsedBytes();
+}
+
+void PathFinder::SetJumpPointTable(const JumpPointTable* table)
+{
+    m_JumpPointTable = table;
+}
+
+void PathFinder::SetHierarchicalMap(const HierarchicalMap* hierarchicalMap)
+{
+    m_HierarchicalMap = hierarchicalMap;
+}
+
+void PathFinder::SetLandmarkTable(const LandmarkTable* table)
+{
+    m_LandmarkTable = table;
+}
+
+void PathFinder::SetContractionHierarchy(const ContractionHierarchy* hierarchy)
+{
+    m_ContractionHierarchy = hierarchy;
+}
+
+void PathFinder::SetWorkerPool(WorkerPool* workerPool)
+{
+    m_WorkerPool = workerPool;
+}
+
+PathFindingResult PathFinder::FindPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+    ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound)
+{
+    m_MemoryBoundedPeakUsage = 0;
+
+    /* Walled off goal would make search flood whole area reachable from start. Hex moves
+       join cells that are not 4-connected, so hex queries can not trust component labels */
+    if (neighborhood != ENeighborhood::Hex && !map.AreConnected(start, goal))
+    {
+        return {EPathFindingStatus::NoPath};
+    }
+
+    /* Bounded suboptimal modes pick their own open lists and run on every neighborhood */
+    if (IsBoundedSuboptimal(mode))
+    {
+        return FindPathBoundedSuboptimal(map, start, goal, mode, neighborhood, suboptimalityBound);
+    }
+
+    /* Neighborhood and open list are resolved once per query, search loop itself is instantiated for each pair */
+    bool bBuckets = openList == EOpenList::Buckets;
+
+    if (neighborhood == ENeighborhood::Eight)
+    {
+        return bBuckets ? FindPathAStar<EightConnected, BucketPriorityQueue>(map, start, goal) : FindPathAStar<EightConnected>(map, start, goal);
+    }
+    else if (neighborhood == ENeighborhood::Hex)
+    {
+        return bBuckets ? FindPathAStar<HexConnected, BucketPriorityQueue>(map, start, goal) : FindPathAStar<HexConnected>(map, start, goal);
+    }
+
+    switch (mode)
+    {
+    case EPathFindingMode::JumpPointSearch:
+        return FindPathJumpPointSearch(map, start, goal, nullptr);
+    case EPathFindingMode::JumpPointSearchPlus:
+        return FindPathJumpPointSearch(map, start, goal, m_JumpPointTable);
+    case EPathFindingMode::Hierarchical:
+        return FindPathHierarchical(map, start, goal);
+    case EPathFindingMode::Bidirectional:
+        return FindPathBidirectional(map, start, goal, false);
+    case EPathFindingMode::BidirectionalParallel:
+        return FindPathBidirectional(map, start, goal, true);
+    case EPathFindingMode::Landmarks:
+        if (m_LandmarkTable && m_LandmarkTable->IsUsable())
+        {
+            LandmarkHeuristic heuristic{m_LandmarkTable};
+            return bBuckets ?
+                FindPathAStar<FourConnected, BucketPriorityQueue, LandmarkHeuristic>(map, start, goal, nullptr, heuristic) :
+                FindPathAStar<FourConnected, AStarPriorityQueue, LandmarkHeuristic>(map, start, goal, nullptr, heuristic);
+        }
+        break;
+    case EPathFindingMode::ContractionHierarchy:
+        return FindPathContraction(map, start, goal);
+    case EPathFindingMode::LazyThetaStar:
+        return FindPathLazyThetaStar(map, start, goal);
+    case EPathFindingMode::IterativeDeepening:
+        return FindPathIterativeDeepening(map, start, goal);
+    case EPathFindingMode::SMAStar:
+        return FindPathSMAStar(map, start, goal);
+    case EPathFindingMode::AStar:
+    default:
+        break;
+    }
+
+    return bBuckets ? FindPathAStar<FourConnected, BucketPriorityQueue>(map, start, goal) : FindPathAStar<FourConnected>(map, start, goal);
+}
+
+PathFindingResult PathFinder::FindCompactPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal, CompactPath& outPath,
+    EPathFindingMode mode, ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound)
+{
+    outPath.clear();
+
+    /* Other modes assemble path from pieces or jump points, so their A* runs must reconstruct it */
+    m_bDeferPathReconstruction = neighborhood != ENeighborhood::Four ||
+        mode == EPathFindingMode::AStar || mode == EPathFindingMode::Landmarks || IsBoundedSuboptimal(mode);
+
+    PathFindingResult result = FindPath(map, start, goal, mode, neighborhood, openList, suboptimalityBound);
+    bool bDeferred = m_bDeferPathReconstruction;
+    m_bDeferPathReconstruction = false;
+
+    if (result.Status != EPathFindingStatus::Found)
+    {
+        return result;
+    }
+
+    if (bDeferred)
+    {
+        outPath = ReconstructCompactPath(goal);
+    }
+    else if (mode == EPathFindingMode::LazyThetaStar && neighborhood == ENeighborhood::Four)
+    {
+        /* Compact form holds neighbors only, so lines between waypoints are walked into it */
+        outPath.push_back(result.FoundPath.front());
+
+        for (size_t i = 1; i < result.FoundPath.size(); ++i)
+        {
+            PathFindingPoint from = result.FoundPath[i - 1];
+            PathFindingPoint to = result.FoundPath[i];
+
+            for (int32_t step = 1; step <= GetLineLength(from, to); ++step)
+            {
+                outPath.push_back(GetLinePoint(from, to, step));
+            }
+        }
+
+        outPath.shrink_to_fit();
+        result.FoundPath = Path{};
+    }
+    else
+    {
+        outPath = CompactPath(result.FoundPath);
+        result.FoundPath = Path{};
+    }
+
+    return result;
+}
+
+/* Clock is read only every that many expansions, reading it costs about as much as expanding node */
+static constexpr size_t ExpansionsPerClockCheck = 32;
+
+/* Path requests check whether they were cancelled after every that many expanded nodes */
+static constexpr size_t ExpansionsPerCancelCheck = 4096;
+
+EPathFindingStatus PathFinder::StartSlicedSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    ENeighborhood neighborhood, EOpenList openList)
+{
+    m_bSlicedSearchActive = false;
+
+    /* Same early out as in FindPath */
+    if (neighborhood != ENeighborhood::Hex && !map.AreConnected(start, goal))
+    {
+        return EPathFindingStatus::NoPath;
+    }
+
+    m_SlicedGoal = goal;
+    m_SlicedNeighborhood = neighborhood;
+    m_SlicedOpenList = openList;
+
+    StartNewPathFindingSession(map);
+
+    PathCost heuristics = neighborhood == ENeighborhood::Eight ? OctileHeuristic::Evaluate(start, goal) :
+        neighborhood == ENeighborhood::Hex ? HexHeuristic::Evaluate(start, goal) : ManhattanHeuristic::Evaluate(start, goal);
+
+    bool bOpened = openList == EOpenList::Buckets ?
+        OpenOrUpdate(m_BucketOpenList, start, InvalidCellIndex, 0, heuristics) :
+        OpenOrUpdate(m_OpenList, start, InvalidCellIndex, 0, heuristics);
+
+    if (!bOpened)
+    {
+        return EPathFindingStatus::BudgetExceeded;
+    }
+
+    m_bSlicedSearchActive = true;
+    return EPathFindingStatus::InProgress;
+}
+
+PathFindingResult PathFinder::ContinueSlicedSearch(const IMap& map, const SearchBudget& budget)
+{
+    assert(m_bSlicedSearchActive);
+
+    bool bBuckets = m_SlicedOpenList == EOpenList::Buckets;
+    PathFindingResult result;
+
+    if (m_SlicedNeighborhood == ENeighborhood::Eight)
+    {
+        result = bBuckets ?
+            ExpandAStar<EightConnected, BucketPriorityQueue>(map, m_SlicedGoal, nullptr, OctileHeuristic{}, budget) :
+            ExpandAStar<EightConnected, AStarPriorityQueue>(map, m_SlicedGoal, nullptr, OctileHeuristic{}, budget);
+    }
+    else if (m_SlicedNeighborhood == ENeighborhood::Hex)
+    {
+        result = bBuckets ?
+            ExpandAStar<HexConnected, BucketPriorityQueue>(map, m_SlicedGoal, nullptr, HexHeuristic{}, budget) :
+            ExpandAStar<HexConnected, AStarPriorityQueue>(map, m_SlicedGoal, nullptr, HexHeuristic{}, budget);
+    }
+    else
+    {
+        result = bBuckets ?
+            ExpandAStar<FourConnected, BucketPriorityQueue>(map, m_SlicedGoal, nullptr, ManhattanHeuristic{}, budget) :
+            ExpandAStar<FourConnected, AStarPriorityQueue>(map, m_SlicedGoal, nullptr, ManhattanHeuristic{}, budget);
+    }
+
+    m_bSlicedSearchActive = result.Status == EPathFindingStatus::InProgress;
+    return result;
+}
+
+PathCost PathFinder::GetSlicedSearchFrontierHeuristic()
+{
+    if (m_SlicedOpenList == EOpenList::Buckets)
+    {
+        return m_BucketOpenList.IsEmpty() ? 0 : m_BucketOpenList.Top()->Heuristics;
+    }
+
+    return m_OpenList.IsEmpty() ? 0 : m_OpenList.Top()->Heuristics;
+}
+
+PathFindingResult PathFinder::FindPathCancellable(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound, const std::atomic<bool>& bCancelled)
+{
+    if (bCancelled.load(std::memory_order_relaxed))
+    {
+        return {EPathFindingStatus::Cancelled};
+    }
+
+    /* Weighted A* expands few nodes, so it runs in one go and can not be cancelled once started */
+    if (suboptimalityBound > 1.0f)
+    {
+        return FindPath(map, start, goal, EPathFindingMode::WeightedAStar, neighborhood, openList, suboptimalityBound);
+    }
+
+    EPathFindingStatus status = StartSlicedSearch(map, start, goal, neighborhood, openList);
+    if (status != EPathFindingStatus::InProgress)
+    {
+        return {status};
+    }
+
+    SearchBudget budget;
+    budget.MaxExpansions = ExpansionsPerCancelCheck;
+    size_t nodesExpanded = 0;
+
+    while (true)
+    {
+        PathFindingResult result = ContinueSlicedSearch(map, budget);
+        nodesExpanded += result.NodesExpanded;
+
+        if (result.Status != EPathFindingStatus::InProgress)
+        {
+            result.NodesExpanded = nodesExpanded;
+            return result;
+        }
+
+        if (bCancelled.load(std::memory_order_relaxed))
+        {
+            m_bSlicedSearchActive = false;
+            return {EPathFindingStatus::Cancelled, {}, nodesExpanded};
+        }
+    }
+}
+
+template<typename TNeighborhood, typename TOpenList, typename THeuristic>
+PathFindingResult PathFinder::FindPathAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    const SearchBounds* bounds, const THeuristic& heuristic)
+{
+    /* Find path using A* algorithm */
+    StartNewPathFindingSession(map);
+
+    if (!OpenOrUpdate(GetOpenList<TOpenList>(), start, InvalidCellIndex, 0, heuristic.Evaluate(start, goal)))
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    return ExpandAStar<TNeighborhood, TOpenList>(map, goal, bounds, heuristic, SearchBudget{});
+}
+
+template<typename TNeighborhood, typename TOpenList, typename THeuristic>
+PathFindingResult PathFinder::ExpandAStar(const IMap& map, PathFindingPoint goal, const SearchBounds* bounds,
+    const THeuristic& heuristic, const SearchBudget& budget)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    TOpenList& openList = GetOpenList<TOpenList>();
+    bool bTimed = budget.MaxMicroseconds != std::numeric_limits<double>::infinity();
+    Clock::time_point deadline = bTimed ?
+        Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(budget.MaxMicroseconds)) :
+        Clock::time_point::max();
+
+    size_t nodesExpanded = 0;
+
+    while (!openList.IsEmpty())
+    {
+        /* Open list and records stay as they are, so next call continues where this one stopped */
+        if (nodesExpanded >= budget.MaxExpansions ||
+            (bTimed && nodesExpanded % ExpansionsPerClockCheck == 0 && nodesExpanded > 0 && Clock::now() >= deadline))
+        {
+            return {EPathFindingStatus::InProgress, {}, nodesExpanded};
+        }
+
+        Node* currentNode = openList.Pop();
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        if (current == goal)
+        {
+            return {EPathFindingStatus::Found, m_bDeferPathReconstruction ? Path{} : ReconstructPath(goal), nodesExpanded};
+        }
+
+        PathCost currentCost = currentRecord.CostFunc;
+        int32_t currentIndex = GetCellIndex(current);
+
+        bool bWithinBudget = ForEachNeighbor<TNeighborhood>(map, current, [&](PathFindingPoint neighbor, PathCost stepCost)
+        {
+            if (IsClosed(neighbor) || (bounds && !bounds->Contains(neighbor)))
+            {
+                return true;
+            }
+
+            return OpenOrUpdate(openList, neighbor, currentIndex, currentCost + stepCost, heuristic.Evaluate(neighbor, goal));
+        });
+
+        if (!bWithinBudget)
+        {
+            return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded}; // Return an empty path if no path is found
+}
+
+template PathFindingResult PathFinder::FindPathAStar<FourConnected>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const ManhattanHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<EightConnected>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const OctileHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<HexConnected>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const HexHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<FourConnected, BucketPriorityQueue>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const ManhattanHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<EightConnected, BucketPriorityQueue>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const OctileHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<HexConnected, BucketPriorityQueue>(const IMap&, PathFindingPoint, PathFindingPoint, const SearchBounds*,
+    const HexHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<FourConnected, AStarPriorityQueue, LandmarkHeuristic>(const IMap&, PathFindingPoint,
+    PathFindingPoint, const SearchBounds*, const LandmarkHeuristic&);
+template PathFindingResult PathFinder::FindPathAStar<FourConnected, BucketPriorityQueue, LandmarkHeuristic>(const IMap&, PathFindingPoint,
+    PathFindingPoint, const SearchBounds*, const LandmarkHeuristic&);
+
+bool PathFinder::OpenOrUpdate(PathFindingPoint point, int32_t parentIndex, PathCost costFunc, PathCost heuristics)
+{
+    return OpenOrUpdate(m_OpenList, point, parentIndex, costFunc, heuristics);
+}
+
+template<typename TOpenList>
+bool PathFinder::OpenOrUpdate(TOpenList& openList, PathFindingPoint point, int32_t parentIndex, PathCost costFunc, PathCost heuristics)
+{
+    SearchRecord& record = GetRecord(point);
+
+    if (record.State == ENodeState::Unvisited)
+    {
+        Node* node = m_NodeArena.Allocate(point);
+        if (!node)
+        {
+            return false;
+        }
+
+        node->Heuristics = heuristics;
+        node->EvaluationFunc = costFunc + heuristics;
+
+        record.State = ENodeState::Open;
+        record.Parent = parentIndex;
+        record.CostFunc = costFunc;
+        record.OpenNode = node;
+        openList.Push(node);
+    }
+    else if (record.State == ENodeState::Open && costFunc < record.CostFunc)
+    {
+        /* Cheaper path to cell already in open list, update it in place */
+        Node* node = record.OpenNode;
+
+        record.Parent = parentIndex;
+        record.CostFunc = costFunc;
+        openList.DecreaseKey(node, costFunc + node->Heuristics);
+    }
+
+    return true;
+}
+
+Path PathFinder::ReconstructPath(PathFindingPoint goal) const
+{
+    Path path;
+
+    /* Traverse parents from target to start */
+    int32_t index = GetCellIndex(goal);
+    while (index != InvalidCellIndex)
+    {
+        path.emplace_back(index % m_MapWidth, index / m_MapWidth);
+        index = m_Records[index].Parent;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+CompactPath PathFinder::ReconstructCompactPath(PathFindingPoint goal) const
+{
+    return CompactPath::FromParentChain(goal, [this](PathFindingPoint point, PathFindingPoint& outParent)
+    {
+        int32_t parent = m_Records[GetCellIndex(point)].Parent;
+        outParent = {parent % m_MapWidth, parent / m_MapWidth};
+
+        return parent != InvalidCellIndex;
+    });
+}
+
+void PathFinder::StartNewPathFindingSession(const IMap& map)
+{
+    m_NodeArena.Reset();
+    m_OpenList.Clear();
+    m_BucketOpenList.Clear();
+
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+
+    if (width != m_MapWidth || height != m_MapHeight)
+    {
+        m_MapWidth = width;
+        m_MapHeight = height;
+        m_Records.assign(static_cast<size_t>(width) * height, SearchRecord{});
+        m_Generation = 0;
+    }
+
+    /* Bumping generation invalidates all records at once. On wrap around
+       stale records could look current again, so wipe them explicitly */
+    if (++m_Generation == 0)
+    {
+        std::fill(m_Records.begin(), m_Records.end(), SearchRecord{});
+        m_Generation = 1;
+    }
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "CompactPath.h"
+#include "AStarPriorityQueue.h"
+#include "BucketPriorityQueue.h"
+#include "PagedArena.h"
+#include "HierarchicalMap.h"
+#include "LandmarkTable.h"
+#include "ContractionHierarchy.h"
+#include "Neighborhood.h"
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+constexpr int32_t InvalidCellIndex = -1;
+
+enum class ENodeState : uint8_t
+{
+    Unvisited = 0,
+    Open,
+    Closed
+};
+
+/* Per cell search state. Record is valid only when its Generation equals
+   generation of current search, otherwise cell is treated as unvisited */
+struct SearchRecord
+{
+    uint32_t Generation = 0;
+    ENodeState State = ENodeState::Unvisited;
+    int32_t Parent = InvalidCellIndex;
+    PathCost CostFunc = 0;
+    Node* OpenNode = nullptr;
+};
+
+/* Inclusive rectangle search is not allowed to leave */
+struct SearchBounds
+{
+    PathFindingPoint Min;
+    PathFindingPoint Max;
+
+    bool Contains(PathFindingPoint point) const
+    {
+        return point.x >= Min.x && point.x <= Max.x && point.y >= Min.y && point.y <= Max.y;
+    }
+};
+
+/* One direction of bidirectional search. Costs of discovered cells are
+   mirrored in PublishedCosts as (generation << 32) | cost, so opposite
+   direction can read them while running on another thread */
+struct SearchFrontier
+{
+    PagedArena<Node> NodeArena;
+    AStarPriorityQueue OpenList;
+    std::vector<SearchRecord> Records;
+    std::unique_ptr<std::atomic<uint64_t>[]> PublishedCosts;
+    uint32_t Generation = 0;
+    size_t NodesExpanded = 0;
+};
+
+/* Per node state of contraction hierarchy query, valid only when its Generation equals generation of current query */
+struct ContractionRecord
+{
+    uint32_t Generation = 0;
+    PathCost Cost = 0;
+    int32_t Parent = ContractionHierarchy::InvalidNode;
+};
+
+/* One direction of contraction hierarchy query. Records are indexed by node
+   of hierarchy, open list holds (cost, node) pairs and skips outdated ones */
+struct ContractionFrontier
+{
+    std::vector<ContractionRecord> Records;
+    std::vector<std::pair<PathCost, int32_t>> OpenList;
+};
+
+/* Transposition table slot of IterativeDeepening query. Cell was reached with Cost
+   in iteration Iteration, slots of older iterations are treated as empty */
+struct TranspositionEntry
+{
+    int32_t CellIndex = InvalidCellIndex;
+    PathCost Cost = 0;
+    uint32_t Iteration = 0;
+};
+
+/* Cell on current path of IterativeDeepening query, NextMove is index of next neighbor to try */
+struct DepthFirstFrame
+{
+    PathFindingPoint Point;
+    PathCost Cost;
+    uint32_t NextMove;
+};
+
+/* Node of SMAStar query. Node keeps cost estimate of every move it forgot child
+   of, so child regenerated later starts from it instead of from heuristic */
+struct BoundedNode
+{
+    PathFindingPoint Point;
+    PathCost Cost;
+
+    /* Estimate node was generated with, lowest estimate of successors it does not hold,
+       and lowest estimate of all its successors backed up from them */
+    PathCost BaseEstimate;
+    PathCost OpenEstimate;
+    PathCost Estimate;
+
+    int32_t Parent;
+    int32_t Depth;
+    int32_t Children[FourConnected::NumNeighbors];
+    PathCost ForgottenEstimates[FourConnected::NumNeighbors];
+
+    /* Positions in open and leaf heaps, InvalidCellIndex when node is not there */
+    int32_t HeapPositions[2];
+    uint32_t ParentMove;
+};
+
+/* Entry of focal list of FocalSearch query. Entry is outdated once its node left
+   open list or got cheaper, outdated entries are skipped when they come up */
+struct FocalEntry
+{
+    PathCost Heuristics;
+    PathCost EvaluationFunc;
+    Node* FocalNode;
+};
+
+/* Self contained A* searcher. Owns its node arena, open list and per cell
+   records, map is passed explicitly to every query. Single instance must
+   not be used by two threads at once, but separate instances share nothing
+   and can search the same map concurrently */
+class PathFinder
+{
+public:
+    PathFinder();
+
+    /* Suboptimality bound is used by bounded suboptimal modes only, open list by AStar ones */
+    PathFindingResult FindPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        EPathFindingMode mode = EPathFindingMode::AStar, ENeighborhood neighborhood = ENeighborhood::Four,
+        EOpenList openList = EOpenList::BinaryHeap, float suboptimalityBound = 1.0f);
+
+    /* Same as FindPath, but found path goes to outPath and FoundPath of result stays empty. AStar,
+       Landmarks and bounded suboptimal queries, and queries on 8-connected and hex grids, build it
+       straight from search records, other modes compact path they assembled */
+    PathFindingResult FindCompactPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal, CompactPath& outPath,
+        EPathFindingMode mode = EPathFindingMode::AStar, ENeighborhood neighborhood = ENeighborhood::Four,
+        EOpenList openList = EOpenList::BinaryHeap, float suboptimalityBound = 1.0f);
+
+    /* IterativeDeepening and SMAStar queries keep their whole state within this budget */
+    void SetSearchMemoryBudget(size_t budgetInBytes);
+    size_t GetSearchMemoryBudget() const;
+
+    void SetMemoryBoundedExpansionLimit(size_t maxExpansions);
+
+    /* Memory last query held at its peak. Whole state of memory bounded queries,
+       per cell records and allocated nodes for others */
+    size_t GetLastSearchMemoryUsage() const;
+
+    /* Table must describe map searched by JumpPointSearchPlus queries and stay unmodified during them */
+    void SetJumpPointTable(const class JumpPointTable* table);
+
+    /* Graph must describe map searched by Hierarchical queries and stay unmodified during them */
+    void SetHierarchicalMap(const HierarchicalMap* hierarchicalMap);
+
+    /* Table must describe map searched by Landmarks queries and stay unmodified during them */
+    void SetLandmarkTable(const LandmarkTable* table);
+
+    /* Hierarchy must describe map searched by ContractionHierarchy queries and stay unmodified during them */
+    void SetContractionHierarchy(const ContractionHierarchy* hierarchy);
+
+    /* Pool BidirectionalParallel queries run backward search on. Without pool, or when no worker
+       picks backward search up soon, query searches both directions on calling thread */
+    void SetWorkerPool(class WorkerPool* workerPool);
+
+    /* Time sliced A* query. StartSlicedSearch sets query up and returns InProgress, or its outcome when it
+       ends right away. Every ContinueSlicedSearch then expands nodes until budget runs out and returns
+       InProgress until search ends. No other query may be run on this searcher until then */
+    EPathFindingStatus StartSlicedSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        ENeighborhood neighborhood = ENeighborhood::Four, EOpenList openList = EOpenList::BinaryHeap);
+    PathFindingResult ContinueSlicedSearch(const IMap& map, const SearchBudget& budget);
+
+    /* Heuristic of best node in open list of sliced search, 0 when list is empty */
+    PathCost GetSlicedSearchFrontierHeuristic();
+
+    /* Query of path request. AStar query runs sliced and returns Cancelled once it sees bCancelled set,
+       bounded query runs WeightedAStar in one go. Cancelled query returns no path */
+    PathFindingResult FindPathCancellable(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound, const std::atomic<bool>& bCancelled);
+
+    /* First phase of Hierarchical query. Returned path holds only waypoints, every two
+       consecutive waypoints are either neighbors or lie in the same cluster */
+    PathFindingResult FindAbstractPath(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+
+    /* Second phase of Hierarchical query, turns two consecutive waypoints into cells.
+       Callers may refine segments lazily, only when agent is about to walk them */
+    PathFindingResult RefineAbstractSegment(const IMap& map, PathFindingPoint from, PathFindingPoint to);
+
+private:
+    PagedArena<Node> m_NodeArena;
+    AStarPriorityQueue m_OpenList;
+    BucketPriorityQueue m_BucketOpenList;
+
+    /* Dense records indexed by x + y * width, reused between searches */
+    std::vector<SearchRecord> m_Records;
+    uint32_t m_Generation = 0;
+    int32_t m_MapWidth = 0;
+    int32_t m_MapHeight = 0;
+
+    const class JumpPointTable* m_JumpPointTable = nullptr;
+    const HierarchicalMap* m_HierarchicalMap = nullptr;
+    const LandmarkTable* m_LandmarkTable = nullptr;
+    const ContractionHierarchy* m_ContractionHierarchy = nullptr;
+    class WorkerPool* m_WorkerPool = nullptr;
+
+    /* Scratch edges connecting start and goal to abstract graph for single query */
+    struct TemporaryEdge
+    {
+        int32_t From;
+        HierarchicalMap::Edge Edge;
+    };
+
+    std::vector<TemporaryEdge> m_TemporaryEdges;
+    std::vector<HierarchicalMap::Edge> m_ScratchEdges;
+
+    /* Forward and backward direction of bidirectional search */
+    SearchFrontier m_Frontiers[2];
+
+    /* Forward and backward direction of contraction hierarchy search */
+    ContractionFrontier m_ContractionFrontiers[2];
+    uint32_t m_ContractionGeneration = 0;
+
+    /* Query of sliced search, open list and records hold the rest of its state */
+    PathFindingPoint m_SlicedGoal{0, 0};
+    ENeighborhood m_SlicedNeighborhood = ENeighborhood::Four;
+    EOpenList m_SlicedOpenList = EOpenList::BinaryHeap;
+    bool m_bSlicedSearchActive = false;
+
+    /* Set by FindCompactPath, A* then leaves path in records instead of reconstructing it */
+    bool m_bDeferPathReconstruction = false;
+
+    /* State of memory bounded queries, sized by memory budget. Peak usage is 0 after other queries */
+    std::vector<TranspositionEntry> m_TranspositionTable;
+    uint32_t m_TranspositionIteration = 0;
+    std::vector<DepthFirstFrame> m_DepthFirstStack;
+    std::vector<BoundedNode> m_BoundedNodes;
+    std::vector<int32_t> m_BoundedHeaps[2];
+    std::vector<int32_t> m_BoundedTable;
+    size_t m_MemoryBoundedExpansionLimit = DefaultMemoryBoundedExpansionLimit;
+    size_t m_MemoryBoundedPeakUsage = 0;
+
+    /* Heap of FocalSearch query, nearest to goal first */
+    std::vector<FocalEntry> m_FocalList;
+
+private:
+    /* Instantiated in PathFinder.cpp for every neighborhood and open list with default heuristic of
+       neighborhood, and for 4-connected grid with landmark heuristic */
+    template<typename TNeighborhood, typename TOpenList = AStarPriorityQueue,
+        typename THeuristic = typename TNeighborhood::DefaultHeuristic>
+    PathFindingResult FindPathAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        const SearchBounds* bounds = nullptr, const THeuristic& heuristic = THeuristic{});
+
+    /* Main loop of A*, expands nodes of open list until goal is closed, list runs empty or budget runs out */
+    template<typename TNeighborhood, typename TOpenList, typename THeuristic>
+    PathFindingResult ExpandAStar(const IMap& map, PathFindingPoint goal, const SearchBounds* bounds,
+        const THeuristic& heuristic, const SearchBudget& budget);
+    PathFindingResult FindPathJumpPointSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        const class JumpPointTable* table);
+    PathFindingResult FindPathHierarchical(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+    PathFindingResult FindPathBidirectional(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        bool bParallel);
+    PathFindingResult FindPathContraction(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+    PathFindingResult FindPathLazyThetaStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+    PathFindingResult FindPathIterativeDeepening(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+    PathFindingResult FindPathSMAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal);
+
+    /* Defined in BoundedSuboptimalSearch.cpp, which is the only place that instantiates them */
+    template<typename TNeighborhood>
+    PathFindingResult FindPathWeightedAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal, float weight);
+    template<typename TNeighborhood>
+    PathFindingResult FindPathFocal(const IMap& map, PathFindingPoint start, PathFindingPoint goal, float suboptimalityBound);
+    PathFindingResult FindPathBoundedSuboptimal(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        EPathFindingMode mode, ENeighborhood neighborhood, float suboptimalityBound);
+
+    /* Like OpenOrUpdate, but closed cell reached at lower cost is opened again. Node
+       opened or made cheaper goes to outNode, which stays nullptr when nothing changed */
+    template<typename TOpenList>
+    bool OpenOrReopen(TOpenList& openList, PathFindingPoint point, int32_t parentIndex, PathCost costFunc,
+        PathCost heuristics, Node*& outNode);
+
+    void StartBidirectionalSession(const IMap& map);
+    void StartContractionSession(size_t numNodes);
+
+    /* Adds temporary edges between point and abstract nodes of its cluster (and goal, when it lies there too) */
+    void ConnectToAbstractGraph(PathFindingPoint point, PathFindingPoint goal, bool bReversed);
+
+    void StartNewPathFindingSession(const IMap& map);
+
+    /* Puts point into open list or lowers its cost when it is already there.
+       Returns false when node could not be allocated within memory budget */
+    bool OpenOrUpdate(PathFindingPoint point, int32_t parentIndex, PathCost costFunc, PathCost heuristics);
+
+    template<typename TOpenList>
+    bool OpenOrUpdate(TOpenList& openList, PathFindingPoint point, int32_t parentIndex, PathCost costFunc, PathCost heuristics);
+
+    template<typename TOpenList>
+    TOpenList& GetOpenList()
+    {
+        if constexpr (std::is_same_v<TOpenList, BucketPriorityQueue>)
+        {
+            return m_BucketOpenList;
+        }
+        else
+        {
+            return m_OpenList;
+        }
+    }
+
+    /* Returns record of point, resetting it first when it was left by previous search */
+    SearchRecord& GetRecord(PathFindingPoint point)
+    {
+        SearchRecord& record = m_Records[GetCellIndex(point)];
+
+        if (record.Generation != m_Generation)
+        {
+            record = SearchRecord{};
+            record.Generation = m_Generation;
+        }
+
+        return record;
+    }
+
+    bool IsClosed(PathFindingPoint point) const
+    {
+        const SearchRecord& record = m_Records[GetCellIndex(point)];
+        return record.Generation == m_Generation && record.State == ENodeState::Closed;
+    }
+
+    int32_t GetCellIndex(PathFindingPoint point) const
+    {
+        return point.x + point.y * m_MapWidth;
+    }
+
+    Path ReconstructPath(PathFindingPoint goal) const;
+    CompactPath ReconstructCompactPath(PathFindingPoint goal) const;
+};
@@ -1,169 +1,581 @@
 #include "PathFindingAlgorithm.h"
+#include "PathFinder.h"
+#include "JumpPointTable.h"
+#include "HierarchicalMap.h"
+#include "LandmarkTable.h"
+#include "ContractionHierarchy.h"
+#include "PathCache.h"
+#include "FlowField.h"
+#include "WorkerPool.h"
+#include "MapSnapshot.h"
+#include "GeneticPathFinder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+/* Instance used by static interface, for callers living on main thread */
+static PathFinder* s_DefaultPathFinder = nullptr;
+
+/* Pool used by FindPaths, every worker searches with its own PathFinder */
+static WorkerPool* s_WorkerPool = nullptr;
+static std::vector<std::unique_ptr<PathFinder>> s_WorkerPathFinders;
+
+/* Per map acceleration structures shared by all searchers, updated lazily on main thread */
+static JumpPointTable* s_JumpPointTable = nullptr;
+static HierarchicalMap* s_HierarchicalMap = nullptr;
+static LandmarkTable* s_LandmarkTable = nullptr;
+static ContractionHierarchy* s_ContractionHierarchy = nullptr;
+
+/* Snapshot handed to path requests, shared by all requests made until map changes */
+static std::shared_ptr<const MapSnapshot> s_LatestSnapshot;
+
+/* Genetic solver and statistics of its last query, used only from main thread */
+static GeneticPathFinder* s_GeneticPathFinder = nullptr;
+static GeneticStats* s_LastGeneticStats = nullptr;
+
+/* Trade-off of memory bounded mode on last query measured for UI */
+static MemoryBoundedStats* s_LastMemoryBoundedStats = nullptr;
+
+/* Budgets memory bounded modes are measured with, 1 KB up to 4 MB */
+static constexpr size_t MinMeasuredMemoryBudget = 1024;
+static constexpr size_t MaxMeasuredMemoryBudget = 4 * 1024 * 1024;
+
+/* Measurement runs on main thread, so query that re-expands too much gives up sooner than usual */
+static constexpr size_t MeasuredExpansionLimit = 5'000'000;
+
+/* Paths returned by FindPathTo, used only from main thread */
+static PathCache* s_PathCache = nullptr;
+
+/* Agents heading to every goal, field is built once goal has enough of them */
+struct GoalFlowField
+{
+    int32_t NumSubscribers = 0;
+    std::unique_ptr<FlowField> Field;
+};
 
-#include <queue>
+static std::unordered_map<PathFindingPoint, GoalFlowField>* s_GoalFlowFields = nullptr;
 
-struct Node
+static void AttachSharedTables(PathFinder& pathFinder)
 {
-    PathFindingPoint Point;
-    Node* Parent;
-    double CostFunc = 0.0;
-    double Heuristics = 0.0;
-    double EvaluationFunc = 0.0;
+    pathFinder.SetJumpPointTable(s_JumpPointTable);
+    pathFinder.SetHierarchicalMap(s_HierarchicalMap);
+    pathFinder.SetLandmarkTable(s_LandmarkTable);
+    pathFinder.SetContractionHierarchy(s_ContractionHierarchy);
+    pathFinder.SetWorkerPool(s_WorkerPool);
+}
 
-    Node(PathFindingPoint p, Node* parent = nullptr) :
-        Point(p),
-        Parent(parent)
+/* Shared tables are only read by searchers, so they must be updated before search starts */
+static void UpdateSharedTables(const IMap& map, EPathFindingMode mode)
+{
+    if (mode == EPathFindingMode::JumpPointSearchPlus)
     {
+        s_JumpPointTable->Update(map);
     }
-};
+    else if (mode == EPathFindingMode::Hierarchical)
+    {
+        s_HierarchicalMap->Update(map);
+    }
+    else if (mode == EPathFindingMode::Landmarks)
+    {
+        s_LandmarkTable->Update(map);
+    }
+    else if (mode == EPathFindingMode::ContractionHierarchy)
+    {
+        s_ContractionHierarchy->Update(map);
+    }
+}
+
+/* Bound only matters for bounded suboptimal modes, other modes share one cache entry for any bound */
+static float GetSuboptimalityBound(EPathFindingMode mode, float suboptimalityBound)
+{
+    return IsBoundedSuboptimal(mode) ? std::max(suboptimalityBound, 1.0f) : 1.0f;
+}
 
-static double GetHeuristicsForFields(const PathFindingPoint& a, const PathFindingPoint& b)
+PathRequest::~PathRequest() noexcept
 {
-    return abs(a.x - b.x) + abs(a.y - b.y);
+    Cancel();
 }
 
-struct CompareNode
+PathRequest& PathRequest::operator=(PathRequest&& other) noexcept
 {
-    bool operator()(const Node* a, const Node* b) const
+    if (this != &other)
     {
-        return a->EvaluationFunc > b->EvaluationFunc;
+        Cancel();
+        m_bCancelled = std::move(other.m_bCancelled);
+        m_Result = std::move(other.m_Result);
+        m_OnTaken = std::move(other.m_OnTaken);
     }
-};
 
-static Path ReconstructPath(Node* node)
+    return *this;
+}
+
+bool PathRequest::IsValid() const
+{
+    return m_Result.valid();
+}
+
+bool PathRequest::IsReady() const
+{
+    return m_Result.valid() && m_Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+PathFindingResult PathRequest::Get()
 {
-    Path path;
+    m_bCancelled.reset();
+    PathFindingResult result = m_Result.get();
 
-    /* Traverse nodes from target to start */
-    while (node)
+    if (m_OnTaken)
     {
-        path.push_back(node->Point);
-        node = node->Parent;
+        m_OnTaken(result);
+        m_OnTaken = nullptr;
     }
 
-    std::reverse(path.begin(), path.end());
-    return path;
+    return result;
+}
+
+void PathRequest::Cancel()
+{
+    if (m_bCancelled)
+    {
+        m_bCancelled->store(true, std::memory_order_relaxed);
+        m_bCancelled.reset();
+    }
+
+    /* Future is dropped without waiting, worker finishes on its own */
+    m_Result = {};
+    m_OnTaken = nullptr;
+}
+
+void PathFindingAlgorithm::Initialize()
+{
+    s_JumpPointTable = new JumpPointTable();
+    s_HierarchicalMap = new HierarchicalMap();
+    s_LandmarkTable = new LandmarkTable();
+    s_ContractionHierarchy = new ContractionHierarchy();
+    s_PathCache = new PathCache();
+    s_GeneticPathFinder = new GeneticPathFinder();
+    s_LastGeneticStats = new GeneticStats();
+    s_LastMemoryBoundedStats = new MemoryBoundedStats();
+    s_GoalFlowFields = new std::unordered_map<PathFindingPoint, GoalFlowField>();
+
+    s_WorkerPool = new WorkerPool(WorkerPool::GetDefaultNumWorkers());
+    s_DefaultPathFinder = new PathFinder();
+    AttachSharedTables(*s_DefaultPathFinder);
+
+    /* One finder per task slot, last one belongs to thread that runs batch */
+    for (uint32_t i = 0; i < s_WorkerPool->GetNumTaskSlots(); ++i)
+    {
+        s_WorkerPathFinders.push_back(std::make_unique<PathFinder>());
+        AttachSharedTables(*s_WorkerPathFinders.back());
+    }
+}
+
+void PathFindingAlgorithm::Quit()
+{
+    /* Queued requests run before workers quit, cancelled ones end right away */
+    delete s_WorkerPool;
+    s_WorkerPool = nullptr;
+    s_WorkerPathFinders.clear();
+    s_LatestSnapshot.reset();
+
+    delete s_DefaultPathFinder;
+    s_DefaultPathFinder = nullptr;
+
+    delete s_JumpPointTable;
+    s_JumpPointTable = nullptr;
+
+    delete s_HierarchicalMap;
+    s_HierarchicalMap = nullptr;
+
+    delete s_LandmarkTable;
+    s_LandmarkTable = nullptr;
+
+    delete s_ContractionHierarchy;
+    s_ContractionHierarchy = nullptr;
+
+    delete s_PathCache;
+    s_PathCache = nullptr;
+
+    delete s_GeneticPathFinder;
+    s_GeneticPathFinder = nullptr;
+
+    delete s_LastGeneticStats;
+    s_LastGeneticStats = nullptr;
+
+    delete s_LastMemoryBoundedStats;
+    s_LastMemoryBoundedStats = nullptr;
+
+    delete s_GoalFlowFields;
+    s_GoalFlowFields = nullptr;
+}
+
+PathFindingResult PathFindingAlgorithm::FindPath(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+    ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound)
+{
+    const IMap& map = *IMap::GetInstance();
+    UpdateSharedTables(map, mode);
+
+    return s_DefaultPathFinder->FindPath(map, start, goal, mode, neighborhood, openList, suboptimalityBound);
 }
 
-struct AStarProrityQueue : public std::priority_queue<Node*, std::vector<Node*>, CompareNode>
+Path PathFindingAlgorithm::FindPathTo(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+    ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound)
 {
-    container_type& GetContainer()
+    const IMap& map = *IMap::GetInstance();
+    s_PathCache->Update(map);
+    suboptimalityBound = GetSuboptimalityBound(mode, suboptimalityBound);
+
+    /* Cache keeps paths in compact form, which can not hold waypoints of any-angle paths */
+    if (mode == EPathFindingMode::LazyThetaStar && neighborhood == ENeighborhood::Four)
     {
-        return c;
+        return FindPath(start, goal, mode, neighborhood, openList).FoundPath;
     }
 
-    container_type::iterator begin()
+    if (const CompactPath* cachedPath = s_PathCache->Find(start, goal, mode, neighborhood, suboptimalityBound))
     {
-        return c.begin();
+        return cachedPath->Expand();
     }
 
-    container_type::iterator end()
+    Path path = FindPath(start, goal, mode, neighborhood, openList, suboptimalityBound).FoundPath;
+    s_PathCache->Insert(map, start, goal, mode, neighborhood, CompactPath(path), suboptimalityBound);
+
+    return path;
+}
+
+CompactPath PathFindingAlgorithm::FindCompactPathTo(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode,
+    ENeighborhood neighborhood, EOpenList openList, float suboptimalityBound)
+{
+    const IMap& map = *IMap::GetInstance();
+    s_PathCache->Update(map);
+    suboptimalityBound = GetSuboptimalityBound(mode, suboptimalityBound);
+
+    if (const CompactPath* cachedPath = s_PathCache->Find(start, goal, mode, neighborhood, suboptimalityBound))
     {
-        return c.end();
+        return *cachedPath;
     }
-};
 
-#define NODE_POOL_SIZE 800
+    UpdateSharedTables(map, mode);
+
+    CompactPath path;
+    s_DefaultPathFinder->FindCompactPath(map, start, goal, path, mode, neighborhood, openList, suboptimalityBound);
+    s_PathCache->Insert(map, start, goal, mode, neighborhood, path, suboptimalityBound);
+
+    return path;
+}
 
-class PathFindingData
+PathRequest PathFindingAlgorithm::RequestPath(PathFindingPoint start, PathFindingPoint goal, ENeighborhood neighborhood,
+    EOpenList openList, float suboptimalityBound)
 {
-public:
-    PathFindingData()
+    const IMap& map = *IMap::GetInstance();
+    s_PathCache->Update(map);
+
+    PathRequest request;
+    request.m_bCancelled = std::make_shared<std::atomic<bool>>(false);
+    auto promise = std::make_shared<std::promise<PathFindingResult>>();
+    request.m_Result = promise->get_future();
+
+    /* Walled off goals are answered right away instead of queueing behind other requests */
+    if (neighborhood != ENeighborhood::Hex && !map.AreConnected(start, goal))
     {
-        m_Buffer = (Node*)operator new(sizeof(Node) * NODE_POOL_SIZE);
-        m_CurrentAllocationNode = m_Buffer;
+        promise->set_value({EPathFindingStatus::NoPath});
+        return request;
     }
 
-    ~PathFindingData() noexcept
+    /* Ratio weighted A* achieved is not cached, only bound it was asked for is known */
+    suboptimalityBound = GetSuboptimalityBound(EPathFindingMode::WeightedAStar, suboptimalityBound);
+
+    /* Bounded request looks up weighted path after optimal one, only second lookup counts its miss */
+    if (const CompactPath* cachedPath = s_PathCache->Find(start, goal, EPathFindingMode::AStar, neighborhood, 1.0f,
+        suboptimalityBound == 1.0f))
     {
-        operator delete(m_Buffer);
+        PathFindingResult result{EPathFindingStatus::Found, cachedPath->Expand()};
+        result.CostRatioBound = suboptimalityBound > 1.0f ? 1.0f : 0.0f;
+        promise->set_value(std::move(result));
+        return request;
     }
 
-    Node* AllocateNode(PathFindingPoint point, struct Node* parent)
+    if (suboptimalityBound > 1.0f)
     {
-        assert(m_CurrentAllocationNode - m_Buffer < NODE_POOL_SIZE);
-        new (m_CurrentAllocationNode) Node(point, parent);
-        return m_CurrentAllocationNode++;
+        if (const CompactPath* cachedPath = s_PathCache->Find(start, goal, EPathFindingMode::WeightedAStar, neighborhood, suboptimalityBound))
+        {
+            PathFindingResult result{EPathFindingStatus::Found, cachedPath->Expand()};
+            result.CostRatioBound = suboptimalityBound;
+            promise->set_value(std::move(result));
+            return request;
+        }
     }
 
-    void StartNewPathFindingSession();
+    if (!s_LatestSnapshot || s_LatestSnapshot->GetRevision() != map.GetRevision() ||
+        s_LatestSnapshot->GetMapWidth() != map.GetMapWidth() || s_LatestSnapshot->GetMapHeight() != map.GetMapHeight())
+    {
+        s_LatestSnapshot = std::make_shared<const MapSnapshot>(map, s_LatestSnapshot.get());
+    }
 
-private:
-    Node* m_Buffer;
-    Node* m_CurrentAllocationNode;
-};
+    /* Worker can not touch cache, so path it found is cached once main thread takes it */
+    request.m_OnTaken = [start, goal, neighborhood, suboptimalityBound, revision = s_LatestSnapshot->GetRevision()](
+        const PathFindingResult& result)
+    {
+        std::shared_ptr<IMap> map = IMap::GetInstance();
+        if (!s_PathCache || !map || result.Status != EPathFindingStatus::Found || map->GetRevision() != revision)
+        {
+            return;
+        }
 
-static PathFindingData* s_PathFindingData = nullptr;
+        EPathFindingMode mode = suboptimalityBound > 1.0f ? EPathFindingMode::WeightedAStar : EPathFindingMode::AStar;
+        s_PathCache->Update(*map);
+        s_PathCache->Insert(*map, start, goal, mode, neighborhood, CompactPath(result.FoundPath), suboptimalityBound);
+    };
 
-void PathFindingAlgorithm::Initialize()
-{
-    s_PathFindingData = new PathFindingData();
+    s_WorkerPool->Submit([snapshot = s_LatestSnapshot, bCancelled = request.m_bCancelled, promise, start, goal, neighborhood,
+        openList, suboptimalityBound](uint32_t workerIndex)
+    {
+        promise->set_value(s_WorkerPathFinders[workerIndex]->FindPathCancellable(*snapshot, start, goal, neighborhood,
+            openList, suboptimalityBound, *bCancelled));
+    });
+
+    return request;
 }
 
-void PathFindingAlgorithm::Quit()
+PathFindingResult PathFindingAlgorithm::FindPathGenetic(PathFindingPoint start, PathFindingPoint goal)
 {
-    delete s_PathFindingData;
-    s_PathFindingData = nullptr;
+    typedef std::chrono::steady_clock Clock;
+
+    const IMap& map = *IMap::GetInstance();
+    PathFindingResult result = s_GeneticPathFinder->FindPath(map, start, goal, *s_WorkerPool, s_LastGeneticStats);
+
+    Clock::time_point referenceStart = Clock::now();
+    PathFindingResult reference = s_DefaultPathFinder->FindPath(map, start, goal);
+    s_LastGeneticStats->ReferenceTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - referenceStart).count();
+    s_LastGeneticStats->ReferenceCost = -1;
+
+    if (reference.Status == EPathFindingStatus::Found)
+    {
+        s_LastGeneticStats->ReferenceCost = 0;
+        for (size_t i = 1; i < reference.FoundPath.size(); ++i)
+        {
+            s_LastGeneticStats->ReferenceCost += map.GetTerrainCost(reference.FoundPath[i]);
+        }
+    }
+
+    return result;
 }
 
-Path PathFindingAlgorithm::FindPathTo(PathFindingPoint start, PathFindingPoint goal)
+const GeneticStats& PathFindingAlgorithm::GetLastGeneticStats()
 {
-    /* Find path using A* algorithm */
-    AStarProrityQueue openList;
-    std::unordered_map<PathFindingPoint, bool> closedList;
+    return *s_LastGeneticStats;
+}
 
-    Node startNode(start);
-    Node goalNode(goal);
-    openList.push(&startNode);
+const MemoryBoundedStats& PathFindingAlgorithm::MeasureMemoryBoundedSearch(PathFindingPoint start, PathFindingPoint goal,
+    EPathFindingMode mode)
+{
+    typedef std::chrono::steady_clock Clock;
 
-    s_PathFindingData->StartNewPathFindingSession();
+    const IMap& map = *IMap::GetInstance();
+    MemoryBoundedStats& stats = *s_LastMemoryBoundedStats;
+    stats = MemoryBoundedStats{};
+    stats.Mode = mode;
 
-    while (!openList.empty())
+    auto getCost = [&map](const PathFindingResult& result)
     {
-        Node* currentNode = openList.top();
-        openList.pop();
-        closedList[currentNode->Point] = true;
-
-        if (currentNode->Point == goal)
+        PathCost cost = result.Status == EPathFindingStatus::Found ? 0 : -1;
+        for (size_t i = 1; i < result.FoundPath.size(); ++i)
         {
-            return ReconstructPath(currentNode);
+            cost += map.GetTerrainCost(result.FoundPath[i]);
         }
 
-        PathFindingPoint neighbors[4] = {
-            {currentNode->Point.x - 1, currentNode->Point.y},
-            {currentNode->Point.x + 1, currentNode->Point.y},
-            {currentNode->Point.x, currentNode->Point.y - 1},
-            {currentNode->Point.x, currentNode->Point.y + 1}
-        };
+        return cost;
+    };
+
+    PathFinder pathFinder;
+    pathFinder.SetMemoryBoundedExpansionLimit(MeasuredExpansionLimit);
+
+    Clock::time_point referenceStart = Clock::now();
+    PathFindingResult reference = pathFinder.FindPath(map, start, goal);
+    stats.ReferenceTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - referenceStart).count();
+    stats.ReferenceNodesExpanded = reference.NodesExpanded;
+    stats.ReferenceMemoryUsage = pathFinder.GetLastSearchMemoryUsage();
+    stats.ReferenceCost = getCost(reference);
+
+    for (size_t budget = MinMeasuredMemoryBudget; budget <= MaxMeasuredMemoryBudget; budget *= 4)
+    {
+        pathFinder.SetSearchMemoryBudget(budget);
+
+        Clock::time_point sampleStart = Clock::now();
+        PathFindingResult result = pathFinder.FindPath(map, start, goal, mode);
+
+        MemoryBoundedSample& sample = stats.Samples.emplace_back();
+        sample.MemoryBudget = budget;
+        sample.Status = result.Status;
+        sample.TimeMs = std::chrono::duration<double, std::milli>(Clock::now() - sampleStart).count();
+        sample.PeakMemoryUsage = pathFinder.GetLastSearchMemoryUsage();
+        sample.NodesExpanded = result.NodesExpanded;
+        sample.FoundCost = getCost(result);
+    }
+
+    return stats;
+}
+
+const MemoryBoundedStats& PathFindingAlgorithm::GetLastMemoryBoundedStats()
+{
+    return *s_LastMemoryBoundedStats;
+}
+
+PathBatchStats PathFindingAlgorithm::FindPaths(std::span<const PathQuery> queries, std::span<PathFindingResult> results)
+{
+    typedef std::chrono::steady_clock Clock;
+    assert(queries.size() == results.size());
+
+    const IMap& map = *IMap::GetInstance();
+    uint32_t numSlots = s_WorkerPool->GetNumTaskSlots();
+
+    for (const PathQuery& query : queries)
+    {
+        UpdateSharedTables(map, query.Mode);
+    }
+
+    /* Every worker writes only its own slot, so no synchronization is needed */
+    std::vector<Clock::duration> busyTimes(numSlots, Clock::duration::zero());
+    std::vector<size_t> nodesExpanded(numSlots, 0);
+
+    Clock::time_point batchStart = Clock::now();
+
+    s_WorkerPool->ParallelFor(queries.size(), [&](uint32_t workerIndex, size_t queryIndex)
+    {
+        Clock::time_point start = Clock::now();
+
+        const PathQuery& query = queries[queryIndex];
+        results[queryIndex] = s_WorkerPathFinders[workerIndex]->FindPath(map, query.Start, query.Goal, query.Mode,
+            query.Neighborhood, query.OpenList, query.SuboptimalityBound);
+
+        busyTimes[workerIndex] += Clock::now() - start;
+        nodesExpanded[workerIndex] += results[queryIndex].NodesExpanded;
+    });
 
-        for (PathFindingPoint neighbor : neighbors)
+    Clock::duration wallTime = Clock::now() - batchStart;
+
+    PathBatchStats stats;
+    stats.WallTimeMs = std::chrono::duration<double, std::milli>(wallTime).count();
+    stats.WorkerUtilisation.resize(numSlots, 0.0);
+
+    for (uint32_t i = 0; i < numSlots; ++i)
+    {
+        stats.NodesExpanded += nodesExpanded[i];
+
+        if (wallTime.count() > 0)
         {
-            if (!IsWalkable(neighbor, IMap::GetInstance().get()) || closedList[neighbor])
-            {
-                continue;
-            }
-
-            Node* neighborNode = s_PathFindingData->AllocateNode(neighbor, currentNode);
-            neighborNode->CostFunc = currentNode->CostFunc + 1;
-            neighborNode->Heuristics = GetHeuristicsForFields(neighbor, goal);
-            neighborNode->EvaluationFunc = neighborNode->CostFunc + neighborNode->Heuristics;
-
-            auto it = std::find_if(openList.begin(), openList.end(), [&](Node* n)
-            {
-                return n->Point == neighbor;
-            });
-
-            if (it == openList.end() || neighborNode->CostFunc < (*it)->CostFunc)
-            {
-                openList.push(neighborNode);
-            }
+            stats.WorkerUtilisation[i] = static_cast<double>(busyTimes[i].count()) / wallTime.count();
         }
     }
 
-    return {}; // Return an empty path if no path is found
+    return stats;
+}
+
+void PathFindingAlgorithm::UpdateTables(EPathFindingMode mode)
+{
+    UpdateSharedTables(*IMap::GetInstance(), mode);
+}
+
+void PathFindingAlgorithm::SetSearchMemoryBudget(size_t budgetInBytes)
+{
+    s_DefaultPathFinder->SetSearchMemoryBudget(budgetInBytes);
+
+    for (std::unique_ptr<PathFinder>& pathFinder : s_WorkerPathFinders)
+    {
+        pathFinder->SetSearchMemoryBudget(budgetInBytes);
+    }
+}
+
+size_t PathFindingAlgorithm::GetSearchMemoryBudget()
+{
+    return s_DefaultPathFinder->GetSearchMemoryBudget();
+}
+
+const JumpPointTable& PathFindingAlgorithm::GetJumpPointTable()
+{
+    return *s_JumpPointTable;
+}
+
+const HierarchicalMap& PathFindingAlgorithm::GetHierarchicalMap()
+{
+    return *s_HierarchicalMap;
+}
+
+const LandmarkTable& PathFindingAlgorithm::GetLandmarkTable()
+{
+    return *s_LandmarkTable;
+}
+
+ContractionHierarchy& PathFindingAlgorithm::GetContractionHierarchy()
+{
+    return *s_ContractionHierarchy;
+}
+
+GeneticPathFinder& PathFindingAlgorithm::GetGeneticPathFinder()
+{
+    return *s_GeneticPathFinder;
+}
+
+PathCache& PathFindingAlgorithm::GetPathCache()
+{
+    return *s_PathCache;
+}
+
+void PathFindingAlgorithm::SubscribeToGoal(PathFindingPoint goal)
+{
+    ++(*s_GoalFlowFields)[goal].NumSubscribers;
+}
+
+void PathFindingAlgorithm::UnsubscribeFromGoal(PathFindingPoint goal)
+{
+    /* Agents may outlive path finding when application shuts down */
+    if (!s_GoalFlowFields)
+    {
+        return;
+    }
+
+    auto found = s_GoalFlowFields->find(goal);
+    assert(found != s_GoalFlowFields->end());
+
+    GoalFlowField& goalFlowField = found->second;
+    if (--goalFlowField.NumSubscribers == 0)
+    {
+        s_GoalFlowFields->erase(found);
+    }
+    else if (goalFlowField.NumSubscribers < FlowFieldMinSubscribers)
+    {
+        goalFlowField.Field.reset();
+    }
+}
+
+int32_t PathFindingAlgorithm::GetNumGoalSubscribers(PathFindingPoint goal)
+{
+    auto found = s_GoalFlowFields->find(goal);
+    return found != s_GoalFlowFields->end() ? found->second.NumSubscribers : 0;
 }
 
-void PathFindingData::StartNewPathFindingSession()
+const FlowField* PathFindingAlgorithm::GetFlowField(PathFindingPoint goal)
 {
-    m_CurrentAllocationNode = m_Buffer;
+    auto found = s_GoalFlowFields->find(goal);
+    if (found == s_GoalFlowFields->end() || found->second.NumSubscribers < FlowFieldMinSubscribers)
+    {
+        return nullptr;
+    }
+
+    const IMap& map = *IMap::GetInstance();
+    std::unique_ptr<FlowField>& field = found->second.Field;
+
+    if (!field)
+    {
+        field = std::make_unique<FlowField>();
+        field->Build(map, goal);
+    }
+    else
+    {
+        field->Update(map);
+    }
+
+    return field.get();
 }
@@ -1,7 +1,14 @@
 #pragma once
 
 #include "MapInterface.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
 #include <vector>
+#include <span>
 #include <unordered_map>
 
 typedef glm::ivec2 PathFindingPoint;
@@ -13,13 +20,19 @@ namespace std
     {
         size_t operator()(const PathFindingPoint& p) const
         {
-            return hash<int32_t>()(p.x) ^ hash<int32_t>()(p.y);
+            /* Pack both coordinates into one key, xoring them would make every cell on diagonal collide */
+            uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(p.x)) << 32) | static_cast<uint32_t>(p.y);
+            return hash<uint64_t>()(key);
         }
     };
 }
 
 typedef std::vector<PathFindingPoint> Path;
 
+/* Integer path cost. Every step costs terrain cost of cell it enters times
+   move cost of neighborhood (1 for straight moves, 10 and 14 on 8-connected grid) */
+typedef int32_t PathCost;
+
 inline bool IsWalkable(const PathFindingPoint& point, const IMap* map)
 {
     return point.x >= 0 &&
@@ -32,6 +45,227 @@ inline bool IsWalkable(const PathFindingPoint& point, const IMap* map)
         );
 }
 
+enum class EPathFindingMode : uint8_t
+{
+    AStar = 0,
+
+    /* Jump point search, expands only cells where path may turn. Returns
+       paths of the same length as AStar, falls back to AStar when map has
+       weighted terrain */
+    JumpPointSearch,
+
+    /* Jump point search reading precomputed jump distances instead of scanning
+       grid. Falls back to JumpPointSearch when searcher has no jump point table */
+    JumpPointSearchPlus,
+
+    /* Search over cluster entrance graph refined by small in-cluster searches.
+       Paths are close to, but not guaranteed shortest. Falls back to AStar
+       when searcher has no hierarchical map */
+    Hierarchical,
+
+    /* A* run from both ends at once, stops when frontiers meet. Returns
+       paths of the same length as AStar */
+    Bidirectional,
+
+    /* Bidirectional with backward search running on worker of searcher's pool */
+    BidirectionalParallel,
+
+    /* AStar guided by costs to few precomputed landmark cells (ALT), expands
+       far fewer cells on maze-like maps. Returns paths of the same length as
+       AStar, falls back to AStar while searcher has no usable landmark table */
+    Landmarks,
+
+    /* Bidirectional search over contraction hierarchy, for maps not edited at
+       runtime. Returns paths of the same length as AStar, but ignores agents
+       standing in the way. Falls back to AStar while searcher has no usable hierarchy */
+    ContractionHierarchy,
+
+    /* Any-angle search (Lazy Theta*). Returns only waypoints, agents walk straight
+       lines between them (see LineOfSight.h), so consecutive waypoints are not
+       neighbors. Paths are close to shortest Euclidean ones and have few turns.
+       Falls back to AStar when map has weighted terrain */
+    LazyThetaStar,
+
+    /* IDA* for searchers with tiny memory budget, whole state of query fits in it.
+       Transposition table takes half of budget, rest holds current path. Returns
+       paths of the same length as AStar, but expands cells again and again, the
+       more so the smaller the budget is. Query that does not fit into budget, or
+       expands too many cells, ends with BudgetExceeded */
+    IterativeDeepening,
+
+    /* SMA*, memory bounded like IterativeDeepening. Keeps as many nodes as fit into
+       budget and forgets worst leaves to make room for new ones. Path can not have
+       more cells than there are nodes, so when cheapest path is longer, cheapest
+       one that fits is returned instead */
+    SMAStar,
+
+    /* Bounded suboptimal modes, query passes bound on ratio of path cost to cost
+       of shortest path (1.1 accepts paths 10% more expensive). Both search any
+       neighborhood and report ratio they proved for path they found */
+
+    /* A* with heuristic multiplied by bound, fastest when map has few obstacles */
+    WeightedAStar,
+
+    /* Focal search, expands node closest to goal among open nodes whose evaluation
+       is within bound of lowest one. Keeps closer to bound on maps with many obstacles */
+    FocalSearch
+};
+
+inline bool IsBoundedSuboptimal(EPathFindingMode mode)
+{
+    return mode == EPathFindingMode::WeightedAStar || mode == EPathFindingMode::FocalSearch;
+}
+
+/* Moves allowed from cell. Only AStar and bounded suboptimal modes search Eight
+   and Hex grids, other modes are 4-connected and fall back to AStar for them */
+enum class ENeighborhood : uint8_t
+{
+    Four = 0,
+
+    /* Diagonal moves cost sqrt(2) and may not cut corners of blocked cells */
+    Eight,
+
+    /* Hex cells in "odd-r" layout, odd rows are shifted half cell right */
+    Hex
+};
+
+/* Open list used by AStar queries, other modes always use BinaryHeap */
+enum class EOpenList : uint8_t
+{
+    BinaryHeap = 0,
+
+    /* Bucket per integer evaluation (Dial's algorithm), O(1) push and pop.
+       Pays off when step costs are small, returns paths of the same length */
+    Buckets
+};
+
+enum class EPathFindingStatus : uint8_t
+{
+    Found = 0,
+    NoPath,
+    BudgetExceeded,
+
+    /* Sliced search ran out of its step budget, and continues with next step */
+    InProgress,
+
+    /* Path request was cancelled before its search finished */
+    Cancelled
+};
+
+struct PathFindingResult
+{
+    PathFindingResult() = default;
+
+    PathFindingResult(EPathFindingStatus status, Path foundPath = {}, size_t nodesExpanded = 0) :
+        Status(status),
+        FoundPath(std::move(foundPath)),
+        NodesExpanded(nodesExpanded)
+    {
+    }
+
+    EPathFindingStatus Status = EPathFindingStatus::NoPath;
+    Path FoundPath;
+    size_t NodesExpanded = 0;
+
+    /* Cost of found path is at most that many times cost of shortest path. Reported
+       by bounded suboptimal queries, and never above their bound, 0 for other modes */
+    float CostRatioBound = 0.0f;
+};
+
+struct PathQuery
+{
+    PathFindingPoint Start;
+    PathFindingPoint Goal;
+    EPathFindingMode Mode = EPathFindingMode::AStar;
+    ENeighborhood Neighborhood = ENeighborhood::Four;
+    EOpenList OpenList = EOpenList::BinaryHeap;
+    float SuboptimalityBound = 1.0f;
+};
+
+/* Limits of single step of sliced search, step ends at whichever is reached first */
+struct SearchBudget
+{
+    size_t MaxExpansions = SIZE_MAX;
+    double MaxMicroseconds = std::numeric_limits<double>::infinity();
+};
+
+struct PathBatchStats
+{
+    double WallTimeMs = 0.0;
+    size_t NodesExpanded = 0;
+
+    /* Fraction of batch wall time every worker spent searching, last entry is calling thread */
+    std::vector<double> WorkerUtilisation;
+};
+
+/* Handle of path search running on background worker. Handle is move only,
+   replacing or destroying it cancels search, which worker then skips or
+   abandons within few thousand expanded nodes */
+class PathRequest
+{
+public:
+    PathRequest() = default;
+    ~PathRequest() noexcept;
+
+    PathRequest(PathRequest&& other) noexcept = default;
+    PathRequest& operator=(PathRequest&& other) noexcept;
+
+    /* True from request until its result is taken or it is cancelled */
+    bool IsValid() const;
+    bool IsReady() const;
+
+    /* Waits for result and takes it, request is no longer valid afterwards. Path found
+       on map that did not change since request goes to path cache, so it is called on main thread */
+    PathFindingResult Get();
+
+    void Cancel();
+
+private:
+    friend class PathFindingAlgorithm;
+
+    std::shared_ptr<std::atomic<bool>> m_bCancelled;
+    std::future<PathFindingResult> m_Result;
+
+    /* Runs on thread taking result, empty when result did not come from worker */
+    std::function<void(const PathFindingResult&)> m_OnTaken;
+};
+
+/* Memory bounded query run with single memory budget */
+struct MemoryBoundedSample
+{
+    size_t MemoryBudget = 0;
+    EPathFindingStatus Status = EPathFindingStatus::NoPath;
+
+    /* Most memory query held at once */
+    size_t PeakMemoryUsage = 0;
+    size_t NodesExpanded = 0;
+    PathCost FoundCost = -1;
+    double TimeMs = 0.0;
+};
+
+/* Trade-off between memory and re-expansions of memory bounded mode on one query */
+struct MemoryBoundedStats
+{
+    EPathFindingMode Mode = EPathFindingMode::IterativeDeepening;
+    std::vector<MemoryBoundedSample> Samples;
+
+    /* AStar answer to the same query. Its nodes are expanded once at most, and
+       its memory usage counts per cell records and allocated nodes */
+    size_t ReferenceNodesExpanded = 0;
+    size_t ReferenceMemoryUsage = 0;
+    PathCost ReferenceCost = -1;
+    double ReferenceTimeMs = 0.0;
+};
+
+/* Goals with at least that many agents heading to them are given flow field */
+constexpr int32_t FlowFieldMinSubscribers = 4;
+
+/* Default limit of memory single search may allocate for its nodes */
+constexpr size_t DefaultSearchMemoryBudget = 64 * 1024 * 1024;
+
+/* Default number of nodes memory bounded query may expand before it gives up */
+constexpr size_t DefaultMemoryBoundedExpansionLimit = 50'000'000;
+
 class PathFindingAlgorithm
 {
 public:
@@ -39,5 +273,75 @@ public:
     static void Quit();
 
 public:
-    static Path FindPathTo(PathFindingPoint start, PathFindingPoint goal);
+    /* Suboptimality bound is used by bounded suboptimal modes only, open list by AStar ones */
+    static PathFindingResult FindPath(PathFindingPoint start, PathFindingPoint goal,
+        EPathFindingMode mode = EPathFindingMode::AStar, ENeighborhood neighborhood = ENeighborhood::Four,
+        EOpenList openList = EOpenList::BinaryHeap, float suboptimalityBound = 1.0f);
+
+    /* Same as FindPath, but returns just empty path when search failed. Found paths
+       are kept in path cache, so repeated queries are answered without searching */
+    static Path FindPathTo(PathFindingPoint start, PathFindingPoint goal,
+        EPathFindingMode mode = EPathFindingMode::AStar, ENeighborhood neighborhood = ENeighborhood::Four,
+        EOpenList openList = EOpenList::BinaryHeap, float suboptimalityBound = 1.0f);
+
+    /* Same as FindPathTo, but returns path in compact form, which AStar, Landmarks and bounded suboptimal
+       queries build without expanding it first. Shares path cache with FindPathTo */
+    static class CompactPath FindCompactPathTo(PathFindingPoint start, PathFindingPoint goal,
+        EPathFindingMode mode = EPathFindingMode::AStar, ENeighborhood neighborhood = ENeighborhood::Four,
+        EOpenList openList = EOpenList::BinaryHeap, float suboptimalityBound = 1.0f);
+
+    /* Searches path with AStar on background worker, against snapshot of map taken now. Walled off
+       goals and paths found in path cache are answered right away. Bound above 1 makes worker run
+       WeightedAStar instead, which is cancelled only before it starts. Other modes read tables
+       updated on main thread, so they are not offered here */
+    static PathRequest RequestPath(PathFindingPoint start, PathFindingPoint goal,
+        ENeighborhood neighborhood = ENeighborhood::Four, EOpenList openList = EOpenList::BinaryHeap,
+        float suboptimalityBound = 1.0f);
+
+    /* Searches 4-connected path with genetic algorithm on all workers, and runs AStar on the same query
+       for comparison. Blocks until both are done, statistics of last call are kept for UI */
+    static PathFindingResult FindPathGenetic(PathFindingPoint start, PathFindingPoint goal);
+    static const struct GeneticStats& GetLastGeneticStats();
+
+    /* Solves all queries on worker threads, results[i] receives answer to queries[i].
+       Map must not be modified until call returns */
+    static PathBatchStats FindPaths(std::span<const PathQuery> queries, std::span<PathFindingResult> results);
+
+    /* Runs memory bounded mode on query with budgets from 1 KB up to 4 MB, and AStar on it for comparison.
+       Uses its own searcher, so memory budget of other queries stays as it is. Statistics of last call are kept for UI */
+    static const MemoryBoundedStats& MeasureMemoryBoundedSearch(PathFindingPoint start, PathFindingPoint goal, EPathFindingMode mode);
+    static const MemoryBoundedStats& GetLastMemoryBoundedStats();
+
+    /* Brings tables read by mode up to date with map. Queries of that mode do it on their own,
+       calling it ahead of them starts builds before first query needs tables */
+    static void UpdateTables(EPathFindingMode mode);
+
+    static void SetSearchMemoryBudget(size_t budgetInBytes);
+    static size_t GetSearchMemoryBudget();
+
+    /* Table used by JumpPointSearchPlus queries, brought up to date with map before every query */
+    static const class JumpPointTable& GetJumpPointTable();
+
+    /* Abstract graph used by Hierarchical queries, brought up to date with map before every query */
+    static const class HierarchicalMap& GetHierarchicalMap();
+
+    /* Tables used by Landmarks queries, rebuilt in background after map edits */
+    static const class LandmarkTable& GetLandmarkTable();
+
+    /* Hierarchy used by ContractionHierarchy queries, built in background on first such query
+       unless loaded from disk before, and again after edits of terrain or obstacles */
+    static class ContractionHierarchy& GetContractionHierarchy();
+
+    static class GeneticPathFinder& GetGeneticPathFinder();
+
+    /* Cache in front of FindPathTo, brought up to date with map before every lookup */
+    static class PathCache& GetPathCache();
+
+    /* Counts agents heading to goal, prefer FlowFieldSubscription over calling these directly */
+    static void SubscribeToGoal(PathFindingPoint goal);
+    static void UnsubscribeFromGoal(PathFindingPoint goal);
+    static int32_t GetNumGoalSubscribers(PathFindingPoint goal);
+
+    /* Flow field of goal brought up to date with map, nullptr when goal has fewer than FlowFieldMinSubscribers agents */
+    static const class FlowField* GetFlowField(PathFindingPoint goal);
 };
\ No newline at end of file
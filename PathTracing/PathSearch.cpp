@@ -0,0 +1,105 @@
+#include "PathSearch.h"
+#include "PathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+
+PathSearch::PathSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal, ENeighborhood neighborhood,
+    EOpenList openList) :
+    m_PathFinder(std::make_unique<PathFinder>()),
+    m_Start(start),
+    m_Goal(goal),
+    m_Neighborhood(neighborhood),
+    m_OpenList(openList)
+{
+    m_PathFinder->SetSearchMemoryBudget(PathFindingAlgorithm::GetSearchMemoryBudget());
+    Start(map);
+}
+
+PathSearch::~PathSearch() noexcept = default;
+
+EPathFindingStatus PathSearch::Step(const IMap& map, const SearchBudget& budget)
+{
+    if (IsDone())
+    {
+        return m_Result.Status;
+    }
+
+    /* Records are indexed by map width, so they are useless once size changed */
+    if (map.GetMapWidth() != m_MapWidth || map.GetMapHeight() != m_MapHeight)
+    {
+        Start(map);
+
+        if (IsDone())
+        {
+            return m_Result.Status;
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point stepStart = Clock::now();
+
+    PathFindingResult result = m_PathFinder->ContinueSlicedSearch(map, budget);
+
+    m_Progress.NodesExpanded += result.NodesExpanded;
+    m_Progress.SearchTimeMs += std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count();
+    ++m_Progress.NumSteps;
+
+    if (result.Status == EPathFindingStatus::InProgress)
+    {
+        /* Best open node gets closer to goal as search goes on, but not steadily */
+        if (m_StartHeuristic > 0)
+        {
+            float fraction = 1.0f - static_cast<float>(m_PathFinder->GetSlicedSearchFrontierHeuristic()) / m_StartHeuristic;
+            m_Progress.Fraction = std::max(m_Progress.Fraction, fraction);
+        }
+    }
+    else
+    {
+        m_Result.Status = result.Status;
+        m_Result.FoundPath = std::move(result.FoundPath);
+        m_Result.NodesExpanded = m_Progress.NodesExpanded;
+        m_Progress.Fraction = 1.0f;
+    }
+
+    return m_Result.Status;
+}
+
+bool PathSearch::IsDone() const
+{
+    return m_Result.Status != EPathFindingStatus::InProgress;
+}
+
+EPathFindingStatus PathSearch::GetStatus() const
+{
+    return m_Result.Status;
+}
+
+const Path& PathSearch::GetPath() const
+{
+    return m_Result.FoundPath;
+}
+
+PathFindingPoint PathSearch::GetStart() const
+{
+    return m_Start;
+}
+
+PathFindingPoint PathSearch::GetGoal() const
+{
+    return m_Goal;
+}
+
+const PathSearchProgress& PathSearch::GetProgress() const
+{
+    return m_Progress;
+}
+
+void PathSearch::Start(const IMap& map)
+{
+    m_MapWidth = map.GetMapWidth();
+    m_MapHeight = map.GetMapHeight();
+    m_Result = {m_PathFinder->StartSlicedSearch(map, m_Start, m_Goal, m_Neighborhood, m_OpenList)};
+    m_StartHeuristic = IsDone() ? 0 : m_PathFinder->GetSlicedSearchFrontierHeuristic();
+    m_Progress.Fraction = IsDone() ? 1.0f : 0.0f;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+
+#include <memory>
+
+struct PathSearchProgress
+{
+    size_t NodesExpanded = 0;
+    int32_t NumSteps = 0;
+    double SearchTimeMs = 0.0;
+
+    /* Rough share of work done, from heuristic of best open node relative to start. Never decreases */
+    float Fraction = 0.0f;
+};
+
+/* A* query spread over many frames. Every Step expands nodes until its budget
+   runs out and keeps open list and records for the next one, so time spent
+   per frame stays bounded however hard the query is. Search owns its own
+   searcher, so any number of them may be in progress at once.
+
+   Map may be edited between steps. Cells expanded before the edit are not
+   looked at again, so found path may cross cell blocked meanwhile, just like
+   any path walked over many frames. Only change of map size restarts search */
+class PathSearch
+{
+public:
+    PathSearch(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+        ENeighborhood neighborhood = ENeighborhood::Four, EOpenList openList = EOpenList::BinaryHeap);
+    ~PathSearch() noexcept;
+
+    PathSearch(const PathSearch&) = delete;
+    PathSearch& operator=(const PathSearch&) = delete;
+
+    /* Continues search within budget, returns InProgress while it is not finished */
+    EPathFindingStatus Step(const IMap& map, const SearchBudget& budget);
+
+    bool IsDone() const;
+    EPathFindingStatus GetStatus() const;
+
+    /* Found path, empty until search is done and when it failed */
+    const Path& GetPath() const;
+
+    PathFindingPoint GetStart() const;
+    PathFindingPoint GetGoal() const;
+    const PathSearchProgress& GetProgress() const;
+
+private:
+    std::unique_ptr<class PathFinder> m_PathFinder;
+
+    PathFindingPoint m_Start;
+    PathFindingPoint m_Goal;
+    ENeighborhood m_Neighborhood;
+    EOpenList m_OpenList;
+    int32_t m_MapWidth = 0;
+    int32_t m_MapHeight = 0;
+
+    PathCost m_StartHeuristic = 0;
+    PathFindingResult m_Result;
+    PathSearchProgress m_Progress;
+
+private:
+    void Start(const IMap& map);
+};
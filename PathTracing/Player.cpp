@@ -1,5 +1,6 @@
 #include "Player.h"
 #include "Renderer.h"
+#include "LineOfSight.h"
 #include "imgui/imgui.h"
 
 Player::Player(PathFindingPoint startPos, PathFindingPoint goalPos, glm::vec4 lineColor) :
@@ -11,6 +12,26 @@ Player::Player(PathFindingPoint startPos, PathFindingPoint goalPos, glm::vec4 li
 
 void Player::Move()
 {
+    if (const FlowField* flowField = GetFlowField())
+    {
+        MoveAlongFlowField(*flowField);
+        return;
+    }
+
+    if (m_bFollowedFlowField)
+    {
+        /* Field was dropped as other agents left goal, so own path has to be found again */
+        m_bFollowedFlowField = false;
+        CalculatePath(false);
+        m_CurrentNodeIndex = 0;
+    }
+
+    if (!m_Waypoints.empty())
+    {
+        MoveAlongWaypoints();
+        return;
+    }
+
     if (m_CurrentNodeIndex >= m_CurrentPath.size())
     {
         return;
@@ -36,7 +57,12 @@ void Player::Draw()
 {
     auto map = IMap::GetInstance();
 
-    map->SetField(m_PrevPosition, EFieldType::Empty);
+    /* Touch fields only after move, so map revision does not change every frame */
+    if (m_PrevPosition != m_Position)
+    {
+        map->SetField(m_PrevPosition, EFieldType::Empty);
+    }
+
     map->SetField(m_Position, EFieldType::Player);
 
     if (m_InterpolatedPos == glm::vec2(0.0f))
@@ -60,25 +86,51 @@ void Player::Draw()
         glm::vec3{cellSize - 25, cellSize - 25, 0.0f},
         DrawCommandArgs{GetColorForField(EFieldType::Player)});
 
-    /* Quit quickly, because otherwise index would overflow */
-    if (m_CurrentPath.empty())
+    if (const FlowField* flowField = GetFlowField())
+    {
+        /* Path starts at agent position, its next node is the second one */
+        DrawPathLines(flowField->ExtractPath(m_Position), 1);
+    }
+    else if (!m_Waypoints.empty())
+    {
+        DrawWaypointLines();
+    }
+    else
+    {
+        DrawPathLines(m_CurrentPath, m_CurrentNodeIndex);
+    }
+}
+
+void Player::DrawPathLines(const CompactPath& path, size_t currentNodeIndex)
+{
+    /* Path is decoded once from next node on, instead of looking up every node by index */
+    auto node = path.GetIteratorAt(currentNodeIndex + 1);
+    if (node == path.end())
     {
         return;
     }
 
     /* Draw line from player middle to next node in path */
-    if (m_CurrentNodeIndex + 1 < m_CurrentPath.size())
+    glm::vec3 pos{m_InterpolatedPos, 0};
+
+    for (; node != path.end(); ++node)
     {
-        glm::vec3 nextpos = glm::vec3{m_CurrentPath[m_CurrentNodeIndex + 1], 0};
-        glm::vec3 pos{m_InterpolatedPos, 0};
+        glm::vec3 nextpos = glm::vec3{*node, 0};
         DrawPath(pos, nextpos);
+        pos = nextpos;
     }
+}
 
-    for (size_t i = m_CurrentNodeIndex + 1; i < m_CurrentPath.size() - 1; ++i)
+void Player::DrawWaypointLines()
+{
+    /* Line from player middle to waypoint it heads to, then one line per waypoint */
+    glm::vec3 pos{m_InterpolatedPos, 0};
+
+    for (size_t i = m_CurrentWaypoint; i < m_Waypoints.size(); ++i)
     {
-        glm::vec3 pos = glm::vec3{m_CurrentPath[i], 0};
-        glm::vec3 nextpos = glm::vec3{m_CurrentPath[i + 1], 0};
+        glm::vec3 nextpos = glm::vec3{m_Waypoints[i], 0};
         DrawPath(pos, nextpos);
+        pos = nextpos;
     }
 }
 
@@ -93,34 +145,107 @@ void Player::RecalculatePath()
 {
     auto map = IMap::GetInstance();
 
+    /* Path to new goal is on its way, blocked agent just stops walking the old one */
+    if (IsSearchingPath())
+    {
+        ClearPath();
+        return;
+    }
+
     if (!m_CurrentPath.empty())
     {
         m_Goal = m_CurrentPath.back();
     }
 
-    m_CurrentPath = std::move(PathFindingAlgorithm::FindPathTo(m_Position, m_Goal));
+    CalculatePath(true);
 }
 
 void Player::SetNewGoal(PathFindingPoint newGoal)
 {
     auto map = IMap::GetInstance();
 
-    glm::ivec2 oldGoal = m_Goal;
+    /* Goal of other agents may be shared, enough agents sharing it walk its flow field */
+    EFieldType field = map->GetFieldAt(newGoal);
+    if (field != EFieldType::Empty && field != EFieldType::Goal)
+    {
+        return;
+    }
 
-    map->SetField(oldGoal, EFieldType::Empty);
+    glm::ivec2 oldGoal = m_Goal;
     m_Goal = newGoal;
+    m_GoalSubscription.Subscribe(m_Goal);
 
-    if (map->GetFieldAt(m_Goal) == EFieldType::Empty)
+    /* Old goal stays marked while other agents still head there */
+    if (oldGoal != m_Goal && map->GetFieldAt(oldGoal) == EFieldType::Goal && PathFindingAlgorithm::GetNumGoalSubscribers(oldGoal) == 0)
     {
-        m_CurrentPath = PathFindingAlgorithm::FindPathTo(m_Position, m_Goal);
-        m_CurrentNodeIndex = 0;
+        map->SetField(oldGoal, EFieldType::Empty);
     }
-    else
+
+    map->SetField(m_Goal, EFieldType::Goal);
+
+    /* Old path is walked until new one arrives, its node index is replaced together with it */
+    CalculatePath(false);
+}
+
+void Player::StepPathSearch(const SearchBudget& budget)
+{
+    if (m_PathRequest.IsReady())
+    {
+        PathFindingResult result = m_PathRequest.Get();
+        m_LastCostRatioBound = result.CostRatioBound;
+        TakeFoundPath(CompactPath(result.FoundPath));
+    }
+    else if (m_PathSearch && m_PathSearch->Step(*IMap::GetInstance(), budget) != EPathFindingStatus::InProgress)
     {
-        m_Goal = oldGoal;
+        CompactPath path(m_PathSearch->GetPath());
+        m_PathSearch.reset();
+        TakeFoundPath(std::move(path));
     }
+}
 
-    map->SetField(m_Goal, EFieldType::Goal);
+bool Player::IsSearchingPath() const
+{
+    return m_PathRequest.IsValid() || m_PathSearch;
+}
+
+const PathSearch* Player::GetPathSearch() const
+{
+    return m_PathSearch.get();
+}
+
+void Player::SetNeighborhood(ENeighborhood neighborhood)
+{
+    m_Neighborhood = neighborhood;
+}
+
+void Player::SetBackgroundPathSearch(bool bBackground)
+{
+    m_bBackgroundPathSearch = bBackground;
+}
+
+void Player::SetGeneticPathFinding(bool bGenetic)
+{
+    m_bGeneticPathFinding = bGenetic;
+}
+
+void Player::SetAnyAnglePathFinding(bool bAnyAngle)
+{
+    m_bAnyAnglePathFinding = bAnyAngle;
+}
+
+void Player::SetSearchMode(EPathFindingMode mode)
+{
+    m_SearchMode = mode;
+}
+
+void Player::SetSuboptimalityBound(float suboptimalityBound)
+{
+    m_SuboptimalityBound = suboptimalityBound;
+}
+
+float Player::GetLastCostRatioBound() const
+{
+    return m_LastCostRatioBound;
 }
 
 PathFindingPoint Player::GetGridPosition() const
@@ -128,11 +253,187 @@ PathFindingPoint Player::GetGridPosition() const
     return m_Position;
 }
 
+PathFindingPoint Player::GetGoal() const
+{
+    return m_Goal;
+}
+
+size_t Player::GetPathMemoryUsage() const
+{
+    return m_CurrentPath.GetMemoryUsage() + m_Waypoints.capacity() * sizeof(PathFindingPoint);
+}
+
+size_t Player::GetPathLength() const
+{
+    size_t length = m_CurrentPath.size();
+
+    for (size_t i = 1; i < m_Waypoints.size(); ++i)
+    {
+        length += GetLineLength(m_Waypoints[i - 1], m_Waypoints[i]);
+    }
+
+    return length + (m_Waypoints.empty() ? 0 : 1);
+}
+
 void Player::DrawImGuiLineColorSelection()
 {
     ImGui::ColorEdit4("Agent line color: ", &m_LineColor[0]);
 }
 
+void Player::CalculatePath(bool bReuseSearch)
+{
+    auto map = IMap::GetInstance();
+
+    /* Search for previous goal is of no use anymore */
+    m_PathSearch.reset();
+    m_PathRequest.Cancel();
+
+    if (GetFlowField())
+    {
+        /* Agent walks shared field of its goal instead */
+        ClearPath();
+        return;
+    }
+
+    if (m_Neighborhood == ENeighborhood::Four && !map->AreConnected(m_Position, m_Goal))
+    {
+        /* Planner is left as it is, it catches up with edits made meanwhile once goal is reachable again */
+        ClearPath();
+        return;
+    }
+
+    /* Genetic solver keeps all workers busy by itself, so it can not run in background */
+    if (m_bGeneticPathFinding && m_Neighborhood == ENeighborhood::Four)
+    {
+        TakeFoundPath(CompactPath(PathFindingAlgorithm::FindPathGenetic(m_Position, m_Goal).FoundPath));
+        return;
+    }
+
+    /* Background requests and planner find grid paths only, any-angle path is searched right away */
+    if (m_bAnyAnglePathFinding && m_Neighborhood == ENeighborhood::Four)
+    {
+        TakeWaypoints(PathFindingAlgorithm::FindPath(m_Position, m_Goal, EPathFindingMode::LazyThetaStar).FoundPath);
+        return;
+    }
+
+    if (m_SearchMode != EPathFindingMode::AStar)
+    {
+        TakeFoundPath(PathFindingAlgorithm::FindCompactPathTo(m_Position, m_Goal, m_SearchMode, m_Neighborhood,
+            EOpenList::BinaryHeap, m_SuboptimalityBound));
+        return;
+    }
+
+    /* Path to new goal may take long to find, so it is searched without blocking and taken over by
+       StepPathSearch. Agent heading to new goal walks on along old path meanwhile, blocked one waits */
+    if (m_Neighborhood != ENeighborhood::Four || !bReuseSearch)
+    {
+        if (bReuseSearch)
+        {
+            ClearPath();
+        }
+
+        StartPathSearch();
+        return;
+    }
+
+    if (m_Planner.IsInitialized() && m_Planner.GetGoal() == m_Goal)
+    {
+        m_Planner.Replan(*map, m_Position);
+    }
+    else
+    {
+        m_Planner.Initialize(*map, m_Position, m_Goal);
+    }
+
+    ClearPath();
+    m_CurrentPath = m_Planner.ExtractPath();
+}
+
+void Player::StartPathSearch()
+{
+    if (m_bBackgroundPathSearch)
+    {
+        m_PathRequest = PathFindingAlgorithm::RequestPath(m_Position, m_Goal, m_Neighborhood, EOpenList::BinaryHeap,
+            m_SuboptimalityBound);
+    }
+    else
+    {
+        m_PathSearch = std::make_unique<PathSearch>(*IMap::GetInstance(), m_Position, m_Goal, m_Neighborhood);
+    }
+}
+
+void Player::TakeFoundPath(CompactPath path)
+{
+    /* Agent may have walked on along old path during search, it joins new path where it stands */
+    size_t current = path.Find(m_Position);
+
+    if (current == path.size() && !path.empty())
+    {
+        /* Agent left start of new path behind, so it waits for path searched from where it stands now */
+        ClearPath();
+        StartPathSearch();
+        return;
+    }
+
+    m_Waypoints.clear();
+    m_CurrentNodeIndex = current;
+    m_CurrentPath = std::move(path);
+}
+
+void Player::TakeWaypoints(Path waypoints)
+{
+    ClearPath();
+
+    /* Search started where agent stands, so it heads to second waypoint right away */
+    m_Waypoints = std::move(waypoints);
+    m_Waypoints.shrink_to_fit();
+    m_CurrentWaypoint = 1;
+    m_LineStep = 0;
+}
+
+void Player::ClearPath()
+{
+    m_CurrentPath.clear();
+    m_Waypoints.clear();
+}
+
+void Player::MoveAlongWaypoints()
+{
+    if (m_CurrentWaypoint >= m_Waypoints.size())
+    {
+        return;
+    }
+
+    m_PrevPosition = m_Position;
+    m_Position = GetNextPoint();
+
+    EFieldType field = IMap::GetInstance()->GetFieldAt(m_Position);
+    if (field != EFieldType::Empty && field != EFieldType::Goal)
+    {
+        m_Position = m_PrevPosition;
+        RecalculatePath();
+        return;
+    }
+
+    if (++m_LineStep == GetLineLength(m_Waypoints[m_CurrentWaypoint - 1], m_Waypoints[m_CurrentWaypoint]))
+    {
+        ++m_CurrentWaypoint;
+        m_LineStep = 0;
+    }
+}
+
+PathFindingPoint Player::GetNextPoint() const
+{
+    if (!m_Waypoints.empty())
+    {
+        return m_CurrentWaypoint < m_Waypoints.size() ?
+            GetLinePoint(m_Waypoints[m_CurrentWaypoint - 1], m_Waypoints[m_CurrentWaypoint], m_LineStep + 1) :
+            m_Position;
+    }
+
+    return m_CurrentNodeIndex < m_CurrentPath.size() ? m_CurrentPath[m_CurrentNodeIndex] : m_Position;
+}
+
 void Player::DrawPath(glm::vec3 start, glm::vec3 end)
 {
     auto map = IMap::GetInstance();
@@ -158,11 +459,7 @@ void Player::DrawPath(glm::vec3 start, glm::vec3 end)
 
 void Player::InterpolateMovement()
 {
-    PathFindingPoint point = m_Position;
-    if (m_CurrentNodeIndex < m_CurrentPath.size())
-    {
-        point = m_CurrentPath[m_CurrentNodeIndex];
-    }
+    PathFindingPoint point = GetNextPoint();
 
     if (IsAlreadyOccupiedBySomeone(point))
     {
@@ -176,3 +473,29 @@ void Player::InterpolateMovement()
         m_InterpolatedPos = m_Position;
     }
 }
+
+const FlowField* Player::GetFlowField() const
+{
+    /* Fields are 4-connected, agents moving other ways keep searching on their own */
+    if (m_Neighborhood != ENeighborhood::Four || !m_GoalSubscription.IsSubscribed())
+    {
+        return nullptr;
+    }
+
+    return PathFindingAlgorithm::GetFlowField(m_Goal);
+}
+
+void Player::MoveAlongFlowField(const FlowField& flowField)
+{
+    m_bFollowedFlowField = true;
+    m_PrevPosition = m_Position;
+
+    /* Field does not route around agents, cell taken by one is just waited out */
+    PathFindingPoint next = flowField.GetNextStep(m_Position);
+    EFieldType field = IMap::GetInstance()->GetFieldAt(next);
+
+    if (field == EFieldType::Empty || field == EFieldType::Goal)
+    {
+        m_Position = next;
+    }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "PathFindingAlgorithm.h"
+#include "CompactPath.h"
+#include "DStarLite.h"
+#include "FlowField.h"
+#include "PathSearch.h"
 #include "Map.h"
 
 class Player
@@ -15,7 +19,41 @@ public:
     void RecalculatePath();
     void SetNewGoal(PathFindingPoint newGoal);
 
+    /* Continues time sliced search for path, or takes over path found by background worker */
+    void StepPathSearch(const SearchBudget& budget);
+    bool IsSearchingPath() const;
+
+    /* Time sliced search for path, nullptr when agent is not running one */
+    const PathSearch* GetPathSearch() const;
+
+    /* Takes effect with next path calculation */
+    void SetNeighborhood(ENeighborhood neighborhood);
+
+    /* Search paths on background workers instead of spreading search over frames on main thread */
+    void SetBackgroundPathSearch(bool bBackground);
+
+    /* Find 4-connected paths with genetic solver instead of A* */
+    void SetGeneticPathFinding(bool bGenetic);
+
+    /* Walk straight lines between waypoints of any-angle path instead of 4-connected path */
+    void SetAnyAnglePathFinding(bool bAnyAngle);
+
+    /* Grid search used instead of AStar. Such modes read tables kept up to date on main thread,
+       so they search right away instead of in background or over frames */
+    void SetSearchMode(EPathFindingMode mode);
+
+    /* Background searches may return paths up to this many times costlier than shortest one */
+    void SetSuboptimalityBound(float suboptimalityBound);
+
+    /* Cost ratio bound reported for last path found on background worker, 0 when search was optimal */
+    float GetLastCostRatioBound() const;
+
     PathFindingPoint GetGridPosition() const;
+    PathFindingPoint GetGoal() const;
+
+    /* Bytes held by path agent walks */
+    size_t GetPathMemoryUsage() const;
+    size_t GetPathLength() const;
 
     void DrawImGuiLineColorSelection();
 
@@ -23,16 +61,56 @@ private:
     glm::ivec2 m_Position{0,0};
     glm::ivec2 m_PrevPosition{0, 0};
 
-    Path m_CurrentPath;
+    CompactPath m_CurrentPath;
     size_t m_CurrentNodeIndex = 0;
 
+    /* Search state kept between replans, so being blocked repairs old search instead of starting new one.
+       Planner is 4-connected, other neighborhoods search from scratch every time */
+    DStarLite m_Planner;
+    ENeighborhood m_Neighborhood = ENeighborhood::Four;
+
+    /* Search for path to new goal, at most one of them is in progress */
+    std::unique_ptr<PathSearch> m_PathSearch;
+    PathRequest m_PathRequest;
+    bool m_bBackgroundPathSearch = true;
+    bool m_bGeneticPathFinding = false;
+    EPathFindingMode m_SearchMode = EPathFindingMode::AStar;
+    float m_SuboptimalityBound = 1.0f;
+    float m_LastCostRatioBound = 0.0f;
+
+    /* Any-angle path, empty while agent walks grid path. Agent walks line from waypoint
+       before m_CurrentWaypoint to that one, m_LineStep steps of it are behind */
+    Path m_Waypoints;
+    size_t m_CurrentWaypoint = 0;
+    int32_t m_LineStep = 0;
+    bool m_bAnyAnglePathFinding = false;
+
+    /* Agents sharing goal follow its flow field once there are enough of them */
+    FlowFieldSubscription m_GoalSubscription;
+    bool m_bFollowedFlowField = false;
+
     glm::vec2 m_InterpolatedPos = m_Position;
     PathFindingPoint m_Goal;
     glm::vec4 m_LineColor{1.0f};
 
 private:
     bool IsAlreadyOccupiedBySomeone(PathFindingPoint point) const;
+    void CalculatePath(bool bReuseSearch);
+    void StartPathSearch();
+    void TakeFoundPath(CompactPath path);
+    void TakeWaypoints(Path waypoints);
+    void ClearPath();
+    void MoveAlongWaypoints();
+
+    /* Cell agent steps on next, its own cell when it has nowhere to go */
+    PathFindingPoint GetNextPoint() const;
     void DrawPath(glm::vec3 start, glm::vec3 end);
+    void DrawPathLines(const CompactPath& path, size_t currentNodeIndex);
+    void DrawWaypointLines();
     void InterpolateMovement();
+
+    /* Flow field of goal when agent should follow it, nullptr when it walks own path */
+    const FlowField* GetFlowField() const;
+    void MoveAlongFlowField(const FlowField& flowField);
 };
 
@@ -0,0 +1,482 @@
+#include "PathFinder.h"
+
+#include <algorithm>
+#include <cassert>
+
+/*
+ * SMA* on 4-connected grid. Like A*, it expands node with lowest estimate, deepest
+ * one among equal, but every expansion generates single successor, cheapest one node
+ * does not hold. Nodes are kept until memory is full, then leaf with highest estimate,
+ * shallowest among equal, is forgotten. Its parent remembers estimate of forgotten
+ * child and becomes open again. Every node backs up lowest estimate of its successors,
+ * so forgotten subtree is generated again only once it looks best again.
+ *
+ * Search runs over tree of paths, cell reached along two paths may be held by two nodes.
+ * Table with slot per cell index modulo its size points to node last generated there,
+ * successor whose cell that node reached at no higher cost is not generated at all.
+ */
+
+static constexpr PathCost UnreachableEstimate = std::numeric_limits<PathCost>::max();
+
+static constexpr int32_t OpenHeap = 0;
+static constexpr int32_t LeafHeap = 1;
+
+/* Memory bounded queries count heap entries and table slot of node together with node itself */
+static constexpr size_t BytesPerBoundedNode = sizeof(BoundedNode) + 3 * sizeof(int32_t);
+
+/* Binary heap of node indices, position of node in heap is kept in node itself. Open heap
+   puts lowest open estimate first, leaf heap puts highest estimate first */
+class BoundedHeap
+{
+public:
+    BoundedHeap(std::vector<int32_t>& items, std::vector<BoundedNode>& nodes, int32_t heap) :
+        m_Items(items),
+        m_Nodes(nodes),
+        m_Heap(heap)
+    {
+    }
+
+    bool IsEmpty() const
+    {
+        return m_Items.empty();
+    }
+
+    int32_t Top() const
+    {
+        return m_Items.front();
+    }
+
+    bool Contains(int32_t node) const
+    {
+        return m_Nodes[node].HeapPositions[m_Heap] != InvalidCellIndex;
+    }
+
+    void Push(int32_t node)
+    {
+        m_Items.push_back(node);
+        m_Nodes[node].HeapPositions[m_Heap] = static_cast<int32_t>(m_Items.size() - 1);
+        SiftUp(m_Items.size() - 1);
+    }
+
+    void Remove(int32_t node)
+    {
+        size_t position = m_Nodes[node].HeapPositions[m_Heap];
+        m_Nodes[node].HeapPositions[m_Heap] = InvalidCellIndex;
+
+        int32_t last = m_Items.back();
+        m_Items.pop_back();
+
+        if (position < m_Items.size())
+        {
+            Place(position, last);
+            Update(last);
+        }
+    }
+
+    /* Restores order after estimate of node changed */
+    void Update(int32_t node)
+    {
+        size_t position = m_Nodes[node].HeapPositions[m_Heap];
+        SiftUp(position);
+        SiftDown(m_Nodes[node].HeapPositions[m_Heap]);
+    }
+
+private:
+    std::vector<int32_t>& m_Items;
+    std::vector<BoundedNode>& m_Nodes;
+    int32_t m_Heap;
+
+private:
+    bool IsBefore(int32_t a, int32_t b) const
+    {
+        const BoundedNode& nodeA = m_Nodes[a];
+        const BoundedNode& nodeB = m_Nodes[b];
+
+        if (m_Heap == OpenHeap)
+        {
+            return nodeA.OpenEstimate != nodeB.OpenEstimate ? nodeA.OpenEstimate < nodeB.OpenEstimate : nodeA.Depth > nodeB.Depth;
+        }
+
+        return nodeA.Estimate != nodeB.Estimate ? nodeA.Estimate > nodeB.Estimate : nodeA.Depth < nodeB.Depth;
+    }
+
+    void Place(size_t position, int32_t node)
+    {
+        m_Items[position] = node;
+        m_Nodes[node].HeapPositions[m_Heap] = static_cast<int32_t>(position);
+    }
+
+    void SiftUp(size_t position)
+    {
+        int32_t node = m_Items[position];
+
+        while (position > 0)
+        {
+            size_t parent = (position - 1) / 2;
+
+            if (!IsBefore(node, m_Items[parent]))
+            {
+                break;
+            }
+
+            Place(position, m_Items[parent]);
+            position = parent;
+        }
+
+        Place(position, node);
+    }
+
+    void SiftDown(size_t position)
+    {
+        int32_t node = m_Items[position];
+
+        while (true)
+        {
+            size_t child = position * 2 + 1;
+
+            if (child >= m_Items.size())
+            {
+                break;
+            }
+
+            if (child + 1 < m_Items.size() && IsBefore(m_Items[child + 1], m_Items[child]))
+            {
+                ++child;
+            }
+
+            if (!IsBefore(m_Items[child], node))
+            {
+                break;
+            }
+
+            Place(position, m_Items[child]);
+            position = child;
+        }
+
+        Place(position, node);
+    }
+};
+
+PathFindingResult PathFinder::FindPathSMAStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    size_t maxNodes = m_NodeArena.GetBudget() / BytesPerBoundedNode;
+
+    if (maxNodes == 0)
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    /* Power of two slots, table larger than map would stay partly empty */
+    size_t numCells = static_cast<size_t>(map.GetMapWidth()) * map.GetMapHeight();
+    size_t numSlots = 1;
+    while (numSlots * 2 <= maxNodes && numSlots < numCells)
+    {
+        numSlots *= 2;
+    }
+
+    /* Slots left by earlier queries point to nodes of other cells or past the end, and are ignored */
+    if (m_BoundedTable.size() != numSlots)
+    {
+        std::vector<int32_t>(numSlots, InvalidCellIndex).swap(m_BoundedTable);
+    }
+
+    int32_t width = map.GetMapWidth();
+    size_t slotMask = numSlots - 1;
+
+    std::vector<BoundedNode>& nodes = m_BoundedNodes;
+    nodes.clear();
+
+    /* Nodes left by query with bigger budget would not count against this one */
+    if (nodes.capacity() > maxNodes)
+    {
+        std::vector<BoundedNode>().swap(nodes);
+        std::vector<int32_t>().swap(m_BoundedHeaps[OpenHeap]);
+        std::vector<int32_t>().swap(m_BoundedHeaps[LeafHeap]);
+    }
+
+    m_BoundedHeaps[OpenHeap].clear();
+    m_BoundedHeaps[LeafHeap].clear();
+
+    BoundedHeap openHeap(m_BoundedHeaps[OpenHeap], nodes, OpenHeap);
+    BoundedHeap leafHeap(m_BoundedHeaps[LeafHeap], nodes, LeafHeap);
+
+    /* Forgotten nodes are chained through their parents */
+    int32_t freeNodes = InvalidCellIndex;
+    size_t numNodes = 0;
+    size_t nodesExpanded = 0;
+
+    /* Set once path had to be cut short for lack of nodes */
+    bool bOutOfNodes = false;
+
+    auto allocateNode = [&]()
+    {
+        ++numNodes;
+
+        if (freeNodes != InvalidCellIndex)
+        {
+            int32_t index = freeNodes;
+            freeNodes = nodes[index].Parent;
+            return index;
+        }
+
+        /* Grows in steps, but never beyond budget */
+        if (nodes.size() == nodes.capacity())
+        {
+            size_t capacity = std::min(maxNodes, std::max<size_t>(256, nodes.capacity() * 2));
+            nodes.reserve(capacity);
+            m_BoundedHeaps[OpenHeap].reserve(capacity);
+            m_BoundedHeaps[LeafHeap].reserve(capacity);
+        }
+
+        nodes.emplace_back();
+        return static_cast<int32_t>(nodes.size() - 1);
+    };
+
+    /* Estimate of successor node does not hold, pathmax keeps it from dropping below estimate of node */
+    auto getMoveEstimate = [&](const BoundedNode& node, uint32_t move)
+    {
+        NeighborOffset offset = FourConnected::GetOffset(node.Point, move);
+        PathFindingPoint successor{node.Point.x + offset.X, node.Point.y + offset.Y};
+
+        if (!IsWalkable(successor, &map) || (node.Parent != InvalidCellIndex && successor == nodes[node.Parent].Point))
+        {
+            return UnreachableEstimate;
+        }
+
+        /* Path to successor would not fit into memory */
+        if (static_cast<size_t>(node.Depth) + 2 > maxNodes)
+        {
+            bOutOfNodes = true;
+            return UnreachableEstimate;
+        }
+
+        PathCost cost = node.Cost + offset.Cost * map.GetTerrainCost(successor);
+
+        /* Forgotten nodes have negative depth */
+        int32_t known = m_BoundedTable[(successor.x + successor.y * width) & slotMask];
+        if (known != InvalidCellIndex && static_cast<size_t>(known) < nodes.size() && nodes[known].Depth >= 0 &&
+            nodes[known].Point == successor && nodes[known].Cost <= cost)
+        {
+            return UnreachableEstimate;
+        }
+
+        return std::max({node.BaseEstimate, cost + ManhattanHeuristic::Evaluate(successor, goal), node.ForgottenEstimates[move]});
+    };
+
+    /* Goal stays open with its own estimate until it is picked */
+    auto updateOpenEstimate = [&](int32_t index)
+    {
+        BoundedNode& node = nodes[index];
+        node.OpenEstimate = node.Point == goal ? node.BaseEstimate : UnreachableEstimate;
+
+        if (node.Point != goal)
+        {
+            for (uint32_t move = 0; move < FourConnected::NumNeighbors; ++move)
+            {
+                if (node.Children[move] == InvalidCellIndex)
+                {
+                    node.OpenEstimate = std::min(node.OpenEstimate, getMoveEstimate(node, move));
+                }
+            }
+        }
+
+        if (node.OpenEstimate == UnreachableEstimate)
+        {
+            if (openHeap.Contains(index))
+            {
+                openHeap.Remove(index);
+            }
+        }
+        else if (openHeap.Contains(index))
+        {
+            openHeap.Update(index);
+        }
+        else
+        {
+            openHeap.Push(index);
+        }
+    };
+
+    /* Recomputes estimate of node from its successors, and of its ancestors while it changes */
+    auto backUp = [&](int32_t index)
+    {
+        while (index != InvalidCellIndex)
+        {
+            BoundedNode& node = nodes[index];
+            PathCost estimate = node.OpenEstimate;
+
+            for (int32_t child : node.Children)
+            {
+                if (child != InvalidCellIndex)
+                {
+                    estimate = std::min(estimate, nodes[child].Estimate);
+                }
+            }
+
+            if (estimate == node.Estimate)
+            {
+                break;
+            }
+
+            node.Estimate = estimate;
+
+            if (leafHeap.Contains(index))
+            {
+                leafHeap.Update(index);
+            }
+
+            index = node.Parent;
+        }
+    };
+
+    auto addNode = [&](int32_t parent, uint32_t move, PathFindingPoint point, PathCost cost, PathCost estimate)
+    {
+        int32_t index = allocateNode();
+
+        BoundedNode& node = nodes[index];
+        node.Point = point;
+        node.Cost = cost;
+        node.BaseEstimate = estimate;
+        node.Parent = parent;
+        node.Depth = parent != InvalidCellIndex ? nodes[parent].Depth + 1 : 0;
+        node.ParentMove = move;
+        std::fill(std::begin(node.Children), std::end(node.Children), InvalidCellIndex);
+        std::fill(std::begin(node.ForgottenEstimates), std::end(node.ForgottenEstimates), 0);
+        std::fill(std::begin(node.HeapPositions), std::end(node.HeapPositions), InvalidCellIndex);
+        m_BoundedTable[(point.x + point.y * width) & slotMask] = index;
+
+        updateOpenEstimate(index);
+        nodes[index].Estimate = nodes[index].OpenEstimate;
+
+        if (parent != InvalidCellIndex)
+        {
+            nodes[parent].Children[move] = index;
+            leafHeap.Push(index);
+        }
+
+        return index;
+    };
+
+    /* Leaf remains open in its parent, with its backed up estimate. Node about to get child
+       is no leaf even when it loses its last one */
+    auto forgetWorstLeaf = [&](int32_t expandedNode)
+    {
+        assert(!leafHeap.IsEmpty());
+
+        int32_t index = leafHeap.Top();
+        BoundedNode& leaf = nodes[index];
+        int32_t parent = leaf.Parent;
+
+        leafHeap.Remove(index);
+        if (openHeap.Contains(index))
+        {
+            openHeap.Remove(index);
+        }
+
+        nodes[parent].Children[leaf.ParentMove] = InvalidCellIndex;
+        nodes[parent].ForgottenEstimates[leaf.ParentMove] = leaf.Estimate;
+
+        leaf.Parent = freeNodes;
+        leaf.Depth = InvalidCellIndex;
+        freeNodes = index;
+        --numNodes;
+
+        const int32_t* children = nodes[parent].Children;
+        bool bLeaf = std::all_of(children, children + FourConnected::NumNeighbors, [](int32_t child)
+        {
+            return child == InvalidCellIndex;
+        });
+
+        if (bLeaf && parent != expandedNode && nodes[parent].Parent != InvalidCellIndex)
+        {
+            leafHeap.Push(parent);
+        }
+
+        updateOpenEstimate(parent);
+    };
+
+    auto getPeakUsage = [&]()
+    {
+        return nodes.size() * (sizeof(BoundedNode) + 2 * sizeof(int32_t)) + numSlots * sizeof(int32_t);
+    };
+
+    addNode(InvalidCellIndex, 0, start, 0, ManhattanHeuristic::Evaluate(start, goal));
+
+    while (!openHeap.IsEmpty())
+    {
+        int32_t best = openHeap.Top();
+
+        if (nodes[best].Point == goal)
+        {
+            Path path;
+
+            for (int32_t index = best; index != InvalidCellIndex; index = nodes[index].Parent)
+            {
+                path.push_back(nodes[index].Point);
+            }
+
+            std::reverse(path.begin(), path.end());
+            m_MemoryBoundedPeakUsage = getPeakUsage();
+
+            return {EPathFindingStatus::Found, std::move(path), nodesExpanded};
+        }
+
+        if (nodesExpanded == m_MemoryBoundedExpansionLimit)
+        {
+            break;
+        }
+
+        /* Successor open estimate of node comes from */
+        uint32_t bestMove = 0;
+        PathCost bestEstimate = UnreachableEstimate;
+
+        for (uint32_t move = 0; move < FourConnected::NumNeighbors; ++move)
+        {
+            if (nodes[best].Children[move] == InvalidCellIndex)
+            {
+                PathCost estimate = getMoveEstimate(nodes[best], move);
+
+                if (estimate < bestEstimate)
+                {
+                    bestMove = move;
+                    bestEstimate = estimate;
+                }
+            }
+        }
+
+        /* Cheaper node reached successor since open estimate was computed, node is put back in order first */
+        if (bestEstimate != nodes[best].OpenEstimate)
+        {
+            updateOpenEstimate(best);
+            backUp(best);
+            continue;
+        }
+
+        ++nodesExpanded;
+
+        /* Node gets child, so it is no leaf, and can not be forgotten to make room for it */
+        if (leafHeap.Contains(best))
+        {
+            leafHeap.Remove(best);
+        }
+
+        if (numNodes == maxNodes)
+        {
+            forgetWorstLeaf(best);
+        }
+
+        NeighborOffset offset = FourConnected::GetOffset(nodes[best].Point, bestMove);
+        PathFindingPoint successor{nodes[best].Point.x + offset.X, nodes[best].Point.y + offset.Y};
+        PathCost cost = nodes[best].Cost + offset.Cost * map.GetTerrainCost(successor);
+
+        addNode(best, bestMove, successor, cost, bestEstimate);
+        updateOpenEstimate(best);
+        backUp(best);
+    }
+
+    m_MemoryBoundedPeakUsage = getPeakUsage();
+
+    /* Search that stopped early or cut paths short may have missed existing path */
+    bool bBudgetExceeded = bOutOfNodes || !openHeap.IsEmpty();
+    return {bBudgetExceeded ? EPathFindingStatus::BudgetExceeded : EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
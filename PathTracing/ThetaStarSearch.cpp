@@ -0,0 +1,97 @@
+#include "PathFinder.h"
+#include "LineOfSight.h"
+
+/*
+ * Lazy Theta* on 8-connected grid.
+ *
+ * Search expands grid cells like A*, but every cell opened from expanded cell
+ * takes parent of that cell as its own parent, with Euclidean cost of straight
+ * line from it. Whether line is walkable is checked only once cell is expanded,
+ * which most opened cells never are. When line turns out to be blocked, cell
+ * takes cheapest expanded grid neighbor as its parent instead, which always
+ * sees it. Parents of goal then form chain of waypoints seeing each other.
+ */
+
+PathFindingResult PathFinder::FindPathLazyThetaStar(const IMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    /* Straight line may cross cells of any cost, Euclidean length prices only uniform ones */
+    if (!map.HasUniformTerrainCost())
+    {
+        return FindPathAStar<FourConnected>(map, start, goal);
+    }
+
+    StartNewPathFindingSession(map);
+
+    if (!OpenOrUpdate(start, InvalidCellIndex, 0, EuclideanHeuristic::Evaluate(start, goal)))
+    {
+        return {EPathFindingStatus::BudgetExceeded};
+    }
+
+    size_t nodesExpanded = 0;
+
+    while (!m_OpenList.IsEmpty())
+    {
+        Node* currentNode = m_OpenList.Pop();
+        ++nodesExpanded;
+        PathFindingPoint current = currentNode->Point;
+
+        SearchRecord& currentRecord = GetRecord(current);
+        currentRecord.State = ENodeState::Closed;
+        currentRecord.OpenNode = nullptr;
+
+        if (currentRecord.Parent != InvalidCellIndex)
+        {
+            PathFindingPoint parent{currentRecord.Parent % m_MapWidth, currentRecord.Parent / m_MapWidth};
+
+            if (!HasLineOfSight(map, parent, current))
+            {
+                /* Grid neighbors see each other, and expanded neighbor which opened cell is one of them */
+                currentRecord.CostFunc = std::numeric_limits<PathCost>::max();
+
+                ForEachNeighbor<EightConnected>(map, current, [&](PathFindingPoint neighbor, PathCost)
+                {
+                    if (IsClosed(neighbor))
+                    {
+                        PathCost cost = m_Records[GetCellIndex(neighbor)].CostFunc + GetEuclideanCost(neighbor, current);
+
+                        if (cost < currentRecord.CostFunc)
+                        {
+                            currentRecord.CostFunc = cost;
+                            currentRecord.Parent = GetCellIndex(neighbor);
+                        }
+                    }
+
+                    return true;
+                });
+            }
+        }
+
+        if (current == goal)
+        {
+            return {EPathFindingStatus::Found, ReconstructPath(goal), nodesExpanded};
+        }
+
+        /* Opened cells assume they see parent of current cell, start has none and is parent itself */
+        int32_t parentIndex = currentRecord.Parent != InvalidCellIndex ? currentRecord.Parent : GetCellIndex(current);
+        PathFindingPoint parent{parentIndex % m_MapWidth, parentIndex / m_MapWidth};
+        PathCost parentCost = m_Records[parentIndex].CostFunc;
+
+        bool bWithinBudget = ForEachNeighbor<EightConnected>(map, current, [&](PathFindingPoint neighbor, PathCost)
+        {
+            if (IsClosed(neighbor))
+            {
+                return true;
+            }
+
+            return OpenOrUpdate(neighbor, parentIndex, parentCost + GetEuclideanCost(parent, neighbor),
+                EuclideanHeuristic::Evaluate(neighbor, goal));
+        });
+
+        if (!bWithinBudget)
+        {
+            return {EPathFindingStatus::BudgetExceeded, {}, nodesExpanded};
+        }
+    }
+
+    return {EPathFindingStatus::NoPath, {}, nodesExpanded};
+}
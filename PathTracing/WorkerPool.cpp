@@ -0,0 +1,154 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(uint32_t numWorkers)
+{
+    numWorkers = std::max(numWorkers, 1u);
+    m_Threads.reserve(numWorkers);
+
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        m_Threads.emplace_back(&WorkerPool::WorkerMain, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bQuit = true;
+    }
+
+    m_WorkAvailable.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::ParallelFor(size_t numItems, const TaskFunc& task)
+{
+    if (numItems == 0)
+    {
+        return;
+    }
+
+    /* Only one batch can be in flight */
+    std::lock_guard<std::mutex> batchLock(m_BatchMutex);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    m_Task = &task;
+    m_NumItems = numItems;
+    m_NextItem.store(0, std::memory_order_relaxed);
+    m_NumBusyWorkers = 0;
+    ++m_BatchId;
+
+    m_WorkAvailable.notify_all();
+    lock.unlock();
+
+    /* Calling thread claims items too, so batch ends even when every worker is busy with job */
+    uint32_t callerIndex = GetNumWorkers();
+    for (size_t i = m_NextItem.fetch_add(1, std::memory_order_relaxed); i < numItems;
+        i = m_NextItem.fetch_add(1, std::memory_order_relaxed))
+    {
+        task(callerIndex, i);
+    }
+
+    /* Only workers that joined batch can still run its items, others will skip it */
+    lock.lock();
+    m_WorkDone.wait(lock, [this]() { return m_NumBusyWorkers == 0; });
+
+    m_Task = nullptr;
+}
+
+void WorkerPool::Submit(JobFunc job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+
+    m_WorkAvailable.notify_one();
+}
+
+uint32_t WorkerPool::GetNumWorkers() const
+{
+    return static_cast<uint32_t>(m_Threads.size());
+}
+
+uint32_t WorkerPool::GetNumTaskSlots() const
+{
+    return GetNumWorkers() + 1;
+}
+
+uint32_t WorkerPool::GetDefaultNumWorkers()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void WorkerPool::WorkerMain(uint32_t workerIndex)
+{
+    uint64_t lastBatchId = 0;
+
+    while (true)
+    {
+        const TaskFunc* task = nullptr;
+        size_t numItems = 0;
+        JobFunc job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [&]() { return m_bQuit || m_BatchId != lastBatchId || !m_Jobs.empty(); });
+
+            /* Batch that ended or whose items are all claimed already is skipped */
+            if (m_BatchId != lastBatchId)
+            {
+                lastBatchId = m_BatchId;
+
+                if (m_Task && m_NextItem.load(std::memory_order_relaxed) < m_NumItems)
+                {
+                    task = m_Task;
+                    numItems = m_NumItems;
+                    ++m_NumBusyWorkers;
+                }
+            }
+
+            if (!task)
+            {
+                /* Jobs queued before pool is destroyed still run, so nobody waits on job that never ends */
+                if (m_Jobs.empty())
+                {
+                    if (m_bQuit)
+                    {
+                        return;
+                    }
+
+                    continue;
+                }
+
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+            }
+        }
+
+        if (job)
+        {
+            job(workerIndex);
+            continue;
+        }
+
+        for (size_t i = m_NextItem.fetch_add(1, std::memory_order_relaxed); i < numItems;
+            i = m_NextItem.fetch_add(1, std::memory_order_relaxed))
+        {
+            (*task)(workerIndex, i);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_NumBusyWorkers == 0)
+        {
+            m_WorkDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of threads executing indexed work items. Items are claimed one
+   by one from shared counter, so uneven items still balance across workers.
+   Between batches workers also run single jobs submitted without waiting */
+class WorkerPool
+{
+public:
+    typedef std::function<void(uint32_t workerIndex, size_t itemIndex)> TaskFunc;
+    typedef std::function<void(uint32_t workerIndex)> JobFunc;
+
+    explicit WorkerPool(uint32_t numWorkers);
+    ~WorkerPool() noexcept;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /* Runs task for every item in [0, numItems) and blocks until all finished. Calling
+       thread runs items as well, with worker index GetNumWorkers(). Workers busy with
+       job join batch once they are done with it, unless its items are all claimed by then */
+    void ParallelFor(size_t numItems, const TaskFunc& task);
+
+    /* Queues job for first idle worker and returns at once. Batches are served
+       first, jobs still queued when pool is destroyed run before it is gone */
+    void Submit(JobFunc job);
+
+    uint32_t GetNumWorkers() const;
+
+    /* Worker indices ParallelFor tasks get are below this, calling thread included */
+    uint32_t GetNumTaskSlots() const;
+
+    static uint32_t GetDefaultNumWorkers();
+
+private:
+    std::vector<std::thread> m_Threads;
+
+    std::mutex m_BatchMutex;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_WorkDone;
+
+    std::deque<JobFunc> m_Jobs;
+
+    const TaskFunc* m_Task = nullptr;
+    size_t m_NumItems = 0;
+    std::atomic<size_t> m_NextItem{0};
+    /* Workers that joined current batch and did not finish their part of it yet */
+    uint32_t m_NumBusyWorkers = 0;
+    uint64_t m_BatchId = 0;
+    bool m_bQuit = false;
+
+private:
+    void WorkerMain(uint32_t workerIndex);
+};
@@ -0,0 +1,224 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "ContractionHierarchy.h"
+#include "HierarchicalMap.h"
+#include "JumpPointTable.h"
+#include "LandmarkTable.h"
+#include "PathFinder.h"
+#include "WorkerPool.h"
+
+#include <chrono>
+#include <cstdio>
+
+/* Benchmarks run every mode on the same queries and report time and expanded cells
+   next to plain AStar. Run with --benchmark, ideally from Release build */
+
+struct BenchmarkQuery
+{
+    PathFindingPoint Start;
+    PathFindingPoint Goal;
+};
+
+struct BenchmarkMode
+{
+    const char* Name;
+    EPathFindingMode Mode;
+    EOpenList OpenList = EOpenList::BinaryHeap;
+};
+
+static double GetElapsedMs(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+/* Maze of corridors one cell wide carved by randomized depth first search, width and height should be odd */
+static std::shared_ptr<TestMap> CreateMaze(std::mt19937& rng, int32_t width, int32_t height)
+{
+    std::shared_ptr<TestMap> map = TestMap::Create(width, height);
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            map->SetField({x, y}, EFieldType::Obstacle);
+        }
+    }
+
+    std::vector<glm::ivec2> stack{{1, 1}};
+    map->SetField({1, 1}, EFieldType::Empty);
+
+    const glm::ivec2 directions[] = {{2, 0}, {-2, 0}, {0, 2}, {0, -2}};
+
+    while (!stack.empty())
+    {
+        glm::ivec2 current = stack.back();
+        glm::ivec2 candidates[4];
+        int32_t numCandidates = 0;
+
+        for (glm::ivec2 direction : directions)
+        {
+            glm::ivec2 next = current + direction;
+            if (next.x > 0 && next.x < width - 1 && next.y > 0 && next.y < height - 1 && map->GetFieldAt(next) == EFieldType::Obstacle)
+            {
+                candidates[numCandidates++] = next;
+            }
+        }
+
+        if (numCandidates == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        glm::ivec2 next = candidates[rng() % numCandidates];
+        map->SetField((current + next) / 2, EFieldType::Empty);
+        map->SetField(next, EFieldType::Empty);
+        stack.push_back(next);
+    }
+
+    return map;
+}
+
+static std::vector<BenchmarkQuery> CreateQueries(std::mt19937& rng, const TestMap& map, int32_t numQueries)
+{
+    std::vector<BenchmarkQuery> queries;
+
+    for (int32_t i = 0; i < numQueries; ++i)
+    {
+        queries.push_back({map.GetRandomWalkableCell(rng), map.GetRandomWalkableCell(rng)});
+    }
+
+    return queries;
+}
+
+static void RunModes(const char* mapName, const TestMap& map, const std::vector<BenchmarkQuery>& queries,
+    std::initializer_list<BenchmarkMode> modes, const JumpPointTable* jumpPointTable = nullptr,
+    const HierarchicalMap* hierarchicalMap = nullptr, const LandmarkTable* landmarkTable = nullptr,
+    const ContractionHierarchy* hierarchy = nullptr)
+{
+    /* Backward search of BidirectionalParallel runs on worker of this pool */
+    WorkerPool workerPool(1);
+
+    PathFinder finder;
+    finder.SetWorkerPool(&workerPool);
+    finder.SetJumpPointTable(jumpPointTable);
+    finder.SetHierarchicalMap(hierarchicalMap);
+    finder.SetLandmarkTable(landmarkTable);
+    finder.SetContractionHierarchy(hierarchy);
+
+    std::printf("  %s %dx%d, %zu queries\n", mapName, map.GetMapWidth(), map.GetMapHeight(), queries.size());
+
+    double aStarMs = 0.0;
+    size_t aStarExpanded = 0;
+
+    for (const BenchmarkMode& mode : modes)
+    {
+        size_t nodesExpanded = 0;
+        auto startTime = std::chrono::steady_clock::now();
+
+        for (const BenchmarkQuery& query : queries)
+        {
+            nodesExpanded += finder.FindPath(map, query.Start, query.Goal, mode.Mode, ENeighborhood::Four, mode.OpenList).NodesExpanded;
+        }
+
+        double timeMs = GetElapsedMs(startTime);
+
+        if (mode.Mode == EPathFindingMode::AStar && mode.OpenList == EOpenList::BinaryHeap)
+        {
+            aStarMs = timeMs;
+            aStarExpanded = nodesExpanded;
+        }
+
+        std::printf("    %-24s %9.2f ms %11zu expanded", mode.Name, timeMs, nodesExpanded);
+
+        if (aStarExpanded > 0 && timeMs > 0.0)
+        {
+            std::printf("   speedup %5.2fx, expanded %5.3fx of AStar", aStarMs / timeMs,
+                static_cast<double>(nodesExpanded) / static_cast<double>(aStarExpanded));
+        }
+
+        std::printf("\n");
+    }
+}
+
+BENCHMARK(OpenListBackends)
+{
+    std::mt19937 rng(13);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 512, 512, 0.2f, false);
+    std::vector<BenchmarkQuery> queries = CreateQueries(rng, *map, 200);
+
+    RunModes("Random", *map, queries, {
+        {"AStar", EPathFindingMode::AStar},
+        {"AStar buckets", EPathFindingMode::AStar, EOpenList::Buckets}
+    });
+
+    map = TestMap::CreateRandom(rng, 512, 512, 0.2f, true);
+    RunModes("Weighted", *map, queries, {
+        {"AStar", EPathFindingMode::AStar},
+        {"AStar buckets", EPathFindingMode::AStar, EOpenList::Buckets}
+    });
+}
+
+BENCHMARK(JumpPointSearch)
+{
+    std::mt19937 rng(6);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 512, 512, 0.1f, false);
+
+    JumpPointTable table;
+    auto startTime = std::chrono::steady_clock::now();
+    table.Build(*map);
+    std::printf("  JPS+ table built in %.2f ms, %zu KB\n", GetElapsedMs(startTime), table.GetMemoryUsage() / 1024);
+
+    RunModes("Open", *map, CreateQueries(rng, *map, 200), {
+        {"AStar", EPathFindingMode::AStar},
+        {"JumpPointSearch", EPathFindingMode::JumpPointSearch},
+        {"JumpPointSearchPlus", EPathFindingMode::JumpPointSearchPlus}
+    }, &table);
+}
+
+BENCHMARK(Bidirectional)
+{
+    std::mt19937 rng(10);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 1024, 1024, 0.25f, false);
+
+    RunModes("Random", *map, CreateQueries(rng, *map, 50), {
+        {"AStar", EPathFindingMode::AStar},
+        {"Bidirectional", EPathFindingMode::Bidirectional},
+        {"BidirectionalParallel", EPathFindingMode::BidirectionalParallel}
+    });
+
+    map = CreateMaze(rng, 511, 511);
+    RunModes("Maze", *map, CreateQueries(rng, *map, 50), {
+        {"AStar", EPathFindingMode::AStar},
+        {"Bidirectional", EPathFindingMode::Bidirectional},
+        {"BidirectionalParallel", EPathFindingMode::BidirectionalParallel}
+    });
+}
+
+BENCHMARK(Preprocessed)
+{
+    std::mt19937 rng(17);
+    std::shared_ptr<TestMap> map = CreateMaze(rng, 255, 255);
+
+    LandmarkTable landmarks;
+    landmarks.Build(*map);
+    std::printf("  Landmarks built in %.2f ms, %zu KB\n", landmarks.GetLastBuildTimeMs(), landmarks.GetMemoryUsage() / 1024);
+
+    HierarchicalMap hierarchicalMap;
+    auto startTime = std::chrono::steady_clock::now();
+    hierarchicalMap.Build(*map);
+    std::printf("  Hierarchical map built in %.2f ms, %zu KB\n", GetElapsedMs(startTime), hierarchicalMap.GetMemoryUsage() / 1024);
+
+    ContractionHierarchy hierarchy;
+    hierarchy.Build(*map);
+    std::printf("  Contraction hierarchy built in %.2f ms, %zu shortcuts, %zu KB\n", hierarchy.GetLastBuildTimeMs(),
+        hierarchy.GetNumShortcuts(), hierarchy.GetMemoryUsage() / 1024);
+
+    RunModes("Maze", *map, CreateQueries(rng, *map, 200), {
+        {"AStar", EPathFindingMode::AStar},
+        {"Landmarks", EPathFindingMode::Landmarks},
+        {"Hierarchical", EPathFindingMode::Hierarchical},
+        {"ContractionHierarchy", EPathFindingMode::ContractionHierarchy}
+    }, nullptr, &hierarchicalMap, &landmarks, &hierarchy);
+}
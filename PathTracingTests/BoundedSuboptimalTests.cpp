@@ -0,0 +1,61 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "PathFinder.h"
+
+#include <random>
+
+/* Ratios are floats compared with integer costs, so they get small slack */
+static constexpr double RatioTolerance = 1e-4;
+
+static void CheckWithinBound(EPathFindingMode mode, ENeighborhood neighborhood, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+
+    for (int32_t i = 0; i < 8; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 48, 48, 0.25f, i % 2 == 1);
+        PathFinder finder;
+
+        for (int32_t j = 0; j < 10; ++j)
+        {
+            PathFindingPoint start = map->GetRandomWalkableCell(rng);
+            PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+            PathCost shortestCost = GetShortestPathCost(*map, start, goal, neighborhood);
+
+            for (float bound : {1.0f, 1.1f, 1.5f, 2.0f, 4.0f})
+            {
+                PathFindingResult result = finder.FindPath(*map, start, goal, mode, neighborhood, EOpenList::BinaryHeap, bound);
+
+                CHECK((result.Status == EPathFindingStatus::Found) == (shortestCost >= 0));
+                if (result.Status != EPathFindingStatus::Found || shortestCost <= 0)
+                {
+                    continue;
+                }
+
+                CHECK(IsValidPath(*map, result.FoundPath, start, goal, neighborhood));
+                CHECK(neighborhood != ENeighborhood::Eight || !CutsCorner(*map, result.FoundPath));
+
+                /* Reported ratio holds for found path and never exceeds bound asked for */
+                double ratio = static_cast<double>(GetPathCost(*map, result.FoundPath, neighborhood)) / shortestCost;
+                CHECK(ratio <= bound + RatioTolerance);
+                CHECK(result.CostRatioBound <= bound + RatioTolerance);
+                CHECK(result.CostRatioBound + RatioTolerance >= ratio);
+            }
+        }
+    }
+}
+
+TEST(WeightedAStarStaysWithinBound)
+{
+    CheckWithinBound(EPathFindingMode::WeightedAStar, ENeighborhood::Four, 30);
+    CheckWithinBound(EPathFindingMode::WeightedAStar, ENeighborhood::Eight, 31);
+    CheckWithinBound(EPathFindingMode::WeightedAStar, ENeighborhood::Hex, 32);
+}
+
+TEST(FocalSearchStaysWithinBound)
+{
+    CheckWithinBound(EPathFindingMode::FocalSearch, ENeighborhood::Four, 33);
+    CheckWithinBound(EPathFindingMode::FocalSearch, ENeighborhood::Eight, 34);
+    CheckWithinBound(EPathFindingMode::FocalSearch, ENeighborhood::Hex, 35);
+}
@@ -0,0 +1,118 @@
+#include "TestFramework.h"
+
+#include "CompactPath.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+/* Walk of straight stretches in all 8 directions, many of them longer than single run */
+static Path CreateRandomPath(std::mt19937& rng, size_t numStretches)
+{
+    static constexpr glm::ivec2 Directions[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+    std::uniform_int_distribution<int32_t> direction(0, 7);
+    std::uniform_int_distribution<int32_t> length(1, 80);
+
+    Path path{PathFindingPoint(rng() % 100, rng() % 100)};
+
+    for (size_t i = 0; i < numStretches; ++i)
+    {
+        glm::ivec2 offset = Directions[direction(rng)];
+        for (int32_t step = length(rng); step > 0; --step)
+        {
+            path.push_back(path.back() + offset);
+        }
+    }
+
+    return path;
+}
+
+static void CheckSamePath(const CompactPath& compactPath, const Path& path, std::mt19937& rng)
+{
+    CHECK(compactPath.size() == path.size());
+    CHECK(compactPath.Expand() == path);
+    CHECK(Path(compactPath.begin(), compactPath.end()) == path);
+
+    if (path.empty())
+    {
+        CHECK(compactPath.empty());
+        CHECK(compactPath.GetIteratorAt(0) == compactPath.end());
+        return;
+    }
+
+    CHECK(compactPath.front() == path.front());
+    CHECK(compactPath.back() == path.back());
+
+    /* Random access lands anywhere between checkpoints, including runs split by length limit */
+    std::uniform_int_distribution<size_t> index(0, path.size() - 1);
+    bool bSameAtIndex = true;
+    for (int32_t i = 0; i < 200; ++i)
+    {
+        size_t pointIndex = index(rng);
+        CompactPath::Iterator iterator = compactPath.GetIteratorAt(pointIndex);
+        bSameAtIndex = bSameAtIndex && compactPath[pointIndex] == path[pointIndex] && *iterator == path[pointIndex] &&
+            iterator.GetIndex() == pointIndex && Path(iterator, compactPath.end()) == Path(path.begin() + pointIndex, path.end());
+    }
+    CHECK(bSameAtIndex);
+    CHECK(compactPath.GetIteratorAt(path.size()) == compactPath.end());
+
+    /* Find returns first visit of point, walks may cross themselves */
+    std::unordered_map<PathFindingPoint, size_t> firstVisits;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        firstVisits.emplace(path[i], i);
+    }
+
+    bool bSameFind = true;
+    for (int32_t i = 0; i < 200; ++i)
+    {
+        PathFindingPoint point = path[index(rng)];
+        bSameFind = bSameFind && compactPath.Find(point) == firstVisits[point];
+
+        PathFindingPoint offPath = point + glm::ivec2(rng() % 5, rng() % 5);
+        auto found = firstVisits.find(offPath);
+        bSameFind = bSameFind && compactPath.Find(offPath) == (found == firstVisits.end() ? path.size() : found->second);
+    }
+    CHECK(bSameFind);
+}
+
+TEST(CompactPathRoundTrip)
+{
+    std::mt19937 rng(22);
+
+    /* Short paths stay below first checkpoint, long ones cross many of them */
+    for (size_t numStretches : {0, 1, 2, 5, 30, 100, 400})
+    {
+        for (int32_t i = 0; i < 5; ++i)
+        {
+            Path path = CreateRandomPath(rng, numStretches);
+            CheckSamePath(CompactPath(path), path, rng);
+
+            CompactPath pushed;
+            for (PathFindingPoint point : path)
+            {
+                pushed.push_back(point);
+
+                /* Repeated point is skipped */
+                pushed.push_back(point);
+            }
+            pushed.shrink_to_fit();
+            CheckSamePath(pushed, path, rng);
+
+            size_t parentIndex = path.size() - 1;
+            CompactPath chained = CompactPath::FromParentChain(path.back(), [&](PathFindingPoint, PathFindingPoint& outParent)
+            {
+                if (parentIndex == 0)
+                {
+                    return false;
+                }
+
+                outParent = path[--parentIndex];
+                return true;
+            });
+            CheckSamePath(chained, path, rng);
+        }
+    }
+
+    CheckSamePath(CompactPath(Path{}), Path{}, rng);
+}
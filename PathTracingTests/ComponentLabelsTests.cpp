@@ -0,0 +1,113 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include <random>
+#include <unordered_map>
+
+/* Components of cells that are not obstacles labeled by plain 4-connected flood fill */
+static std::vector<int32_t> FloodFillComponents(const TestMap& map)
+{
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+    std::vector<int32_t> components(static_cast<size_t>(width) * height, InvalidComponent);
+    std::vector<glm::ivec2> stack;
+    int32_t numComponents = 0;
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            if (map.GetFieldAt({x, y}) == EFieldType::Obstacle || components[x + y * width] != InvalidComponent)
+            {
+                continue;
+            }
+
+            components[x + y * width] = numComponents;
+            stack.assign(1, {x, y});
+
+            while (!stack.empty())
+            {
+                glm::ivec2 cell = stack.back();
+                stack.pop_back();
+
+                for (glm::ivec2 offset : {glm::ivec2(1, 0), glm::ivec2(-1, 0), glm::ivec2(0, 1), glm::ivec2(0, -1)})
+                {
+                    glm::ivec2 neighbor = cell + offset;
+                    if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height ||
+                        map.GetFieldAt(neighbor) == EFieldType::Obstacle || components[neighbor.x + neighbor.y * width] != InvalidComponent)
+                    {
+                        continue;
+                    }
+
+                    components[neighbor.x + neighbor.y * width] = numComponents;
+                    stack.push_back(neighbor);
+                }
+            }
+
+            ++numComponents;
+        }
+    }
+
+    return components;
+}
+
+/* Labels match flood fill when they split cells into the same sets, under any numbering */
+static bool HasSameComponents(const ComponentLabels& labels, const std::vector<int32_t>& expected, int32_t width)
+{
+    std::unordered_map<int32_t, int32_t> labelOf;
+    std::unordered_map<int32_t, int32_t> expectedOf;
+    std::vector<int32_t> components;
+    labels.GetComponents(components);
+
+    for (int32_t index = 0; index < static_cast<int32_t>(expected.size()); ++index)
+    {
+        int32_t label = labels.GetComponent({index % width, index / width});
+        if (label != components[index] || (label == InvalidComponent) != (expected[index] == InvalidComponent))
+        {
+            return false;
+        }
+
+        if (label == InvalidComponent)
+        {
+            continue;
+        }
+
+        if (labelOf.emplace(expected[index], label).first->second != label ||
+            expectedOf.emplace(label, expected[index]).first->second != expected[index])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST(ComponentLabelsMatchFloodFill)
+{
+    std::mt19937 rng(14);
+    std::shared_ptr<TestMap> map = TestMap::Create(12, 12);
+    std::uniform_int_distribution<int32_t> coordinate(0, 11);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    const ComponentLabels& labels = *map->GetComponentLabels();
+
+    /* Map stays around half obstacles, so openings join and closings split components all the time.
+       Every split and isolated opening makes new label, many thousands of edits make far more
+       labels than twice the cell count, so forest is rebuilt many times over */
+    for (int32_t edit = 0; edit < 20000; ++edit)
+    {
+        glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+        float roll = chance(rng);
+        map->SetField(cell, roll < 0.45f ? EFieldType::Obstacle : roll < 0.6f ? EFieldType::Player : EFieldType::Empty);
+
+        std::vector<int32_t> expected = FloodFillComponents(*map);
+        CHECK(HasSameComponents(labels, expected, 12));
+
+        for (int32_t i = 0; i < 8; ++i)
+        {
+            glm::ivec2 a{coordinate(rng), coordinate(rng)};
+            glm::ivec2 b{coordinate(rng), coordinate(rng)};
+            int32_t expectedA = expected[a.x + a.y * 12];
+            CHECK(map->AreConnected(a, b) == (expectedA != InvalidComponent && expectedA == expected[b.x + b.y * 12]));
+        }
+    }
+}
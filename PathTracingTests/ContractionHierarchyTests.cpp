@@ -0,0 +1,203 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "ContractionHierarchy.h"
+#include "PathFinder.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+static std::string GetTemporaryFilePath(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<char> ReadFile(const std::string& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static void WriteFile(const std::string& filePath, const std::vector<char>& bytes)
+{
+    std::ofstream file(filePath, std::ios::binary);
+    file.write(bytes.data(), bytes.size());
+}
+
+TEST(ContractionHierarchyLoadsSavedFile)
+{
+    std::mt19937 rng(18);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 32, 24, 0.25f, true);
+
+    ContractionHierarchy built;
+    built.Build(*map);
+
+    std::string filePath = GetTemporaryFilePath("PathTracingTests.ch");
+    CHECK(built.Save(filePath));
+
+    ContractionHierarchy loaded;
+    CHECK(loaded.Load(filePath, *map));
+    CHECK(loaded.GetNumShortcuts() == built.GetNumShortcuts());
+
+    PathFinder finder;
+    finder.SetContractionHierarchy(&loaded);
+
+    for (int32_t i = 0; i < 50; ++i)
+    {
+        PathFindingPoint start = map->GetRandomWalkableCell(rng);
+        PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+
+        PathFinder reference;
+        PathFindingResult expected = reference.FindPath(*map, start, goal);
+        PathFindingResult result = finder.FindPath(*map, start, goal, EPathFindingMode::ContractionHierarchy);
+
+        CHECK(result.Status == expected.Status);
+        if (result.Status == EPathFindingStatus::Found && expected.Status == EPathFindingStatus::Found)
+        {
+            CHECK(IsValidPath(*map, result.FoundPath, start, goal));
+            CHECK(GetPathCost(*map, result.FoundPath) == GetPathCost(*map, expected.FoundPath));
+        }
+    }
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(ContractionHierarchyRejectsShortcutWithoutHalves)
+{
+    std::mt19937 rng(19);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 32, 24, 0.2f, false);
+
+    ContractionHierarchy hierarchy;
+    hierarchy.Build(*map);
+    CHECK(hierarchy.GetNumShortcuts() > 0);
+
+    std::string filePath = GetTemporaryFilePath("PathTracingTests.ch");
+    CHECK(hierarchy.Save(filePath));
+
+    /* Point first upward shortcut at middle node that holds none of its halves. Upward
+       edges follow header, step costs, node cells and first edge indices in the file */
+    int32_t numNodes = static_cast<int32_t>(hierarchy.GetNumNodes());
+    size_t numCells = static_cast<size_t>(map->GetMapWidth()) * map->GetMapHeight();
+    size_t upwardEdgesOffset = 24 + (8 + numCells) + (8 + 4 * numNodes) + (8 + 4 * (numNodes + 1)) + 8;
+    const ContractionHierarchy::Edge* firstUpwardEdge = hierarchy.GetUpwardEdges(0).data();
+
+    size_t corruptedOffset = 0;
+
+    for (int32_t node = 0; node < numNodes && corruptedOffset == 0; ++node)
+    {
+        for (const ContractionHierarchy::Edge& edge : hierarchy.GetUpwardEdges(node))
+        {
+            if (edge.Middle == ContractionHierarchy::InvalidNode)
+            {
+                continue;
+            }
+
+            for (int32_t middle = 0; middle < node; ++middle)
+            {
+                if (!hierarchy.FindEdge(hierarchy.GetUpwardEdges(middle), edge.Target))
+                {
+                    std::vector<char> bytes = ReadFile(filePath);
+                    corruptedOffset = upwardEdgesOffset + (&edge - firstUpwardEdge) * sizeof(ContractionHierarchy::Edge) +
+                        offsetof(ContractionHierarchy::Edge, Middle);
+                    std::memcpy(bytes.data() + corruptedOffset, &middle, sizeof(middle));
+                    WriteFile(filePath, bytes);
+                    break;
+                }
+            }
+
+            break;
+        }
+    }
+
+    CHECK(corruptedOffset != 0);
+
+    /* Failed load leaves hierarchy built before untouched */
+    CHECK(!hierarchy.Load(filePath, *map));
+    CHECK(hierarchy.IsBuilt());
+
+    std::filesystem::remove(filePath);
+}
+
+static void CheckQueries(PathFinder& finder, std::mt19937& rng, const TestMap& map, int32_t numQueries)
+{
+    for (int32_t i = 0; i < numQueries; ++i)
+    {
+        PathFindingPoint start = map.GetRandomWalkableCell(rng);
+        PathFindingPoint goal = map.GetRandomWalkableCell(rng);
+
+        PathFinder reference;
+        PathFindingResult expected = reference.FindPath(map, start, goal);
+        PathFindingResult result = finder.FindPath(map, start, goal, EPathFindingMode::ContractionHierarchy);
+
+        CHECK(result.Status == expected.Status);
+        if (result.Status == EPathFindingStatus::Found && expected.Status == EPathFindingStatus::Found)
+        {
+            CHECK(IsValidPath(map, result.FoundPath, start, goal));
+            CHECK(GetPathCost(map, result.FoundPath) == GetPathCost(map, expected.FoundPath));
+        }
+    }
+}
+
+/* Calls Update until build started by it is taken over, false when it takes too long */
+static bool WaitForRebuild(ContractionHierarchy& hierarchy, const IMap& map)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    do
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        hierarchy.Update(map);
+    }
+    while (!hierarchy.IsUsable() && std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+
+    return hierarchy.IsUsable();
+}
+
+TEST(ContractionHierarchyRebuildsInBackground)
+{
+    std::mt19937 rng(20);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 32, 0.2f, true);
+
+    ContractionHierarchy hierarchy;
+    PathFinder finder;
+    finder.SetContractionHierarchy(&hierarchy);
+
+    /* First Update only starts build, queries fall back to AStar until it is taken over */
+    hierarchy.Update(*map);
+    CHECK(hierarchy.IsRebuilding());
+    CheckQueries(finder, rng, *map, 10);
+    CHECK(WaitForRebuild(hierarchy, *map));
+    CHECK(!hierarchy.IsRebuilding());
+
+    /* Agent standing on cell does not change its step cost */
+    PathFindingPoint agent = map->GetRandomWalkableCell(rng);
+    map->SetField(agent, EFieldType::Player);
+    hierarchy.Update(*map);
+    CHECK(hierarchy.IsUsable());
+    CHECK(!hierarchy.IsRebuilding());
+    map->SetField(agent, EFieldType::Empty);
+
+    std::uniform_int_distribution<int32_t> x(0, 39);
+    std::uniform_int_distribution<int32_t> y(0, 31);
+
+    for (int32_t round = 0; round < 3; ++round)
+    {
+        for (int32_t i = 0; i < 10; ++i)
+        {
+            glm::ivec2 cell{x(rng), y(rng)};
+            map->SetField(cell, map->GetFieldAt(cell) == EFieldType::Obstacle ? EFieldType::Empty : EFieldType::Obstacle);
+        }
+
+        hierarchy.Update(*map);
+        CHECK(!hierarchy.IsUsable());
+        CheckQueries(finder, rng, *map, 20);
+
+        CHECK(WaitForRebuild(hierarchy, *map));
+        CheckQueries(finder, rng, *map, 20);
+    }
+}
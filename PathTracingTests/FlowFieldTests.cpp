@@ -0,0 +1,139 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "FlowField.h"
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+
+static constexpr PathCost NoCost = std::numeric_limits<PathCost>::max();
+
+/* Cost from every cell to goal by Dijkstra run backwards from goal on 4-connected grid.
+   Step costs terrain cost of cell it enters, only obstacles block */
+static std::vector<PathCost> GetCostsToGoal(const TestMap& map, PathFindingPoint goal)
+{
+    int32_t width = map.GetMapWidth();
+    int32_t height = map.GetMapHeight();
+    std::vector<PathCost> costs(static_cast<size_t>(width) * height, NoCost);
+
+    typedef std::pair<PathCost, int32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    costs[goal.x + goal.y * width] = 0;
+    open.push({0, goal.x + goal.y * width});
+
+    while (!open.empty())
+    {
+        auto [cost, cell] = open.top();
+        open.pop();
+
+        if (cost != costs[cell])
+        {
+            continue;
+        }
+
+        PathFindingPoint point{cell % width, cell / width};
+        PathCost stepCost = map.GetTerrainCost(point);
+
+        for (glm::ivec2 offset : {glm::ivec2(1, 0), glm::ivec2(-1, 0), glm::ivec2(0, 1), glm::ivec2(0, -1)})
+        {
+            PathFindingPoint neighbor = point + offset;
+            if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height ||
+                map.GetFieldAt(neighbor) == EFieldType::Obstacle)
+            {
+                continue;
+            }
+
+            int32_t neighborCell = neighbor.x + neighbor.y * width;
+            if (cost + stepCost < costs[neighborCell])
+            {
+                costs[neighborCell] = cost + stepCost;
+                open.push({cost + stepCost, neighborCell});
+            }
+        }
+    }
+
+    return costs;
+}
+
+static bool MatchesCostsToGoal(const FlowField& field, const TestMap& map, PathFindingPoint goal)
+{
+    std::vector<PathCost> costs = GetCostsToGoal(map, goal);
+    int32_t width = map.GetMapWidth();
+
+    for (int32_t cell = 0; cell < static_cast<int32_t>(costs.size()); ++cell)
+    {
+        PathFindingPoint point{cell % width, cell / width};
+
+        if (field.IsReachable(point) != (costs[cell] != NoCost))
+        {
+            return false;
+        }
+
+        if (!field.IsReachable(point) || point == goal)
+        {
+            continue;
+        }
+
+        /* Next step is neighbor lying on cheapest path */
+        PathFindingPoint next = field.GetNextStep(point);
+        glm::ivec2 step = glm::abs(next - point);
+        if (step.x + step.y != 1 || map.GetFieldAt(next) == EFieldType::Obstacle ||
+            costs[next.x + next.y * width] + map.GetTerrainCost(next) != costs[cell])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST(FlowFieldFollowsEdits)
+{
+    std::mt19937 rng(16);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 40, 0.25f, true);
+    std::uniform_int_distribution<int32_t> coordinate(0, 39);
+    std::uniform_int_distribution<int32_t> numEdits(1, 24);
+    std::uniform_int_distribution<int32_t> cost(DefaultTerrainCost, 6);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+    FlowField field;
+    field.Build(*map, goal);
+    CHECK(MatchesCostsToGoal(field, *map, goal));
+
+    for (int32_t round = 0; round < 300; ++round)
+    {
+        for (int32_t edit = numEdits(rng); edit > 0; --edit)
+        {
+            glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+            if (cell == goal)
+            {
+                continue;
+            }
+
+            /* Agents are part of edits too, though they must not change field */
+            float roll = chance(rng);
+            if (roll < 0.3f)
+            {
+                map->SetField(cell, EFieldType::Obstacle);
+            }
+            else if (roll < 0.4f)
+            {
+                map->SetField(cell, EFieldType::Player);
+            }
+            else if (roll < 0.7f)
+            {
+                map->SetField(cell, EFieldType::Empty);
+            }
+            else
+            {
+                map->SetTerrainCost(cell, static_cast<uint8_t>(cost(rng)));
+            }
+        }
+
+        field.Update(*map);
+        CHECK(MatchesCostsToGoal(field, *map, goal));
+    }
+}
@@ -0,0 +1,51 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "GeneticPathFinder.h"
+#include "WorkerPool.h"
+
+#include <random>
+
+TEST(GeneticPathDoesNotDependOnWorkers)
+{
+    std::mt19937 rng(21);
+    WorkerPool singleWorker(1);
+    WorkerPool manyWorkers(8);
+    int32_t numFound = 0;
+
+    for (int32_t i = 0; i < 6; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 24, 24, 0.2f, i % 2 == 1);
+        PathFindingPoint start = map->GetRandomWalkableCell(rng);
+        PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+
+        GeneticSettings settings;
+        settings.PopulationSize = 512;
+        settings.MaxGenerations = 120;
+        settings.Seed = 100 + i;
+
+        GeneticPathFinder finder;
+        finder.SetSettings(settings);
+        GeneticStats singleStats;
+        GeneticStats manyStats;
+        PathFindingResult single = finder.FindPath(*map, start, goal, singleWorker, &singleStats);
+        PathFindingResult many = finder.FindPath(*map, start, goal, manyWorkers, &manyStats);
+
+        CHECK(single.Status == many.Status);
+        CHECK(single.FoundPath == many.FoundPath);
+        CHECK(singleStats.BestScores == manyStats.BestScores);
+        CHECK(singleStats.FoundCost == manyStats.FoundCost);
+
+        /* Returned path is valid and never cheaper than shortest one */
+        if (single.Status == EPathFindingStatus::Found)
+        {
+            ++numFound;
+            PathCost cost = GetPathCost(*map, single.FoundPath);
+            CHECK(IsValidPath(*map, single.FoundPath, start, goal));
+            CHECK(cost == singleStats.FoundCost);
+            CHECK(cost >= GetShortestPathCost(*map, start, goal));
+        }
+    }
+
+    CHECK(numFound > 0);
+}
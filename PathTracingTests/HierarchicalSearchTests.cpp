@@ -0,0 +1,107 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "HierarchicalMap.h"
+#include "PathFinder.h"
+
+/* Runs Hierarchical query and checks its path against AStar on the same map */
+static void CheckAgainstAStar(PathFinder& finder, const TestMap& map, PathFindingPoint start, PathFindingPoint goal)
+{
+    PathFinder reference;
+    PathFindingResult expected = reference.FindPath(map, start, goal);
+    PathFindingResult result = finder.FindPath(map, start, goal, EPathFindingMode::Hierarchical);
+
+    CHECK(result.Status == expected.Status);
+
+    if (result.Status == EPathFindingStatus::Found && expected.Status == EPathFindingStatus::Found)
+    {
+        CHECK(IsValidPath(map, result.FoundPath, start, goal));
+        CHECK(GetPathCost(map, result.FoundPath) >= GetPathCost(map, expected.FoundPath));
+    }
+}
+
+TEST(HierarchicalFreshFinderOnEmptyMap)
+{
+    std::shared_ptr<TestMap> map = TestMap::Create(12, 6);
+    HierarchicalMap graph(4);
+    graph.Build(*map);
+
+    /* First query of finder has to set map width up before start and goal are connected to graph */
+    PathFinder finder;
+    finder.SetHierarchicalMap(&graph);
+
+    PathFindingResult result = finder.FindPath(*map, {0, 0}, {11, 5}, EPathFindingMode::Hierarchical);
+    CHECK(result.Status == EPathFindingStatus::Found);
+    CHECK(IsValidPath(*map, result.FoundPath, {0, 0}, {11, 5}));
+    CHECK(GetPathCost(*map, result.FoundPath) == 16);
+}
+
+TEST(HierarchicalFreshFinderMatchesAStar)
+{
+    std::mt19937 rng(8);
+
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 30, 0.25f, i % 2 == 1);
+        HierarchicalMap graph(8);
+        graph.Build(*map);
+
+        for (int32_t j = 0; j < 10; ++j)
+        {
+            PathFinder finder;
+            finder.SetHierarchicalMap(&graph);
+            CheckAgainstAStar(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+        }
+    }
+}
+
+TEST(HierarchicalReusedFinderAcrossMapSizes)
+{
+    std::mt19937 rng(16);
+    PathFinder finder;
+
+    const glm::ivec2 sizes[] = {{24, 24}, {64, 20}, {17, 45}, {64, 20}};
+
+    for (glm::ivec2 size : sizes)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, size.x, size.y, 0.2f, false);
+        HierarchicalMap graph(8);
+        graph.Build(*map);
+        finder.SetHierarchicalMap(&graph);
+
+        for (int32_t j = 0; j < 25; ++j)
+        {
+            CheckAgainstAStar(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+        }
+    }
+}
+
+TEST(HierarchicalAfterMapUpdate)
+{
+    std::mt19937 rng(32);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 48, 48, 0.2f, true);
+
+    HierarchicalMap graph(8);
+    graph.Build(*map);
+
+    PathFinder finder;
+    finder.SetHierarchicalMap(&graph);
+
+    std::uniform_int_distribution<int32_t> coordinate(0, 47);
+
+    for (int32_t round = 0; round < 10; ++round)
+    {
+        for (int32_t i = 0; i < 30; ++i)
+        {
+            glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+            map->SetField(cell, map->GetFieldAt(cell) == EFieldType::Obstacle ? EFieldType::Empty : EFieldType::Obstacle);
+        }
+
+        graph.Update(*map);
+
+        for (int32_t j = 0; j < 20; ++j)
+        {
+            CheckAgainstAStar(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "LineOfSight.h"
+#include "PathFinder.h"
+
+#include <random>
+
+TEST(LinePointsMatchWalkLine)
+{
+    static constexpr int32_t Width = 64;
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int32_t> coordinate(0, Width - 1);
+
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        PathFindingPoint from{coordinate(rng), coordinate(rng)};
+        PathFindingPoint to{coordinate(rng), coordinate(rng)};
+
+        /* Every cell WalkLine asks about, in order, including cells diagonal steps pass by */
+        std::vector<PathFindingPoint> visited;
+        bool bWalked = WalkLine(from, to, Width, [&](int32_t index)
+        {
+            visited.push_back({index % Width, index / Width});
+            return true;
+        });
+
+        glm::ivec2 delta = to - from;
+        bool bXMajor = std::abs(delta.x) >= std::abs(delta.y);
+        glm::ivec2 sign{delta.x < 0 ? -1 : 1, delta.y < 0 ? -1 : 1};
+        glm::ivec2 majorStep = bXMajor ? glm::ivec2(sign.x, 0) : glm::ivec2(0, sign.y);
+        glm::ivec2 minorStep = bXMajor ? glm::ivec2(0, sign.y) : glm::ivec2(sign.x, 0);
+
+        std::vector<PathFindingPoint> expected;
+        int32_t length = GetLineLength(from, to);
+        for (int32_t step = 1; step <= length; ++step)
+        {
+            PathFindingPoint previous = GetLinePoint(from, to, step - 1);
+            PathFindingPoint point = GetLinePoint(from, to, step);
+
+            if (point - previous == majorStep + minorStep)
+            {
+                expected.push_back(previous + majorStep);
+                expected.push_back(previous + minorStep);
+            }
+
+            expected.push_back(point);
+        }
+
+        CHECK(bWalked);
+        CHECK(GetLinePoint(from, to, 0) == from);
+        CHECK(GetLinePoint(from, to, length) == to);
+        CHECK(visited == expected);
+    }
+}
+
+TEST(LazyThetaStarWaypointsSeeEachOther)
+{
+    std::mt19937 rng(24);
+
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        /* Any-angle search runs on uniform terrain only, weighted maps fall back to AStar */
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 48, 40, 0.2f, false);
+        PathFinder finder;
+
+        for (int32_t j = 0; j < 10; ++j)
+        {
+            PathFindingPoint start = map->GetRandomWalkableCell(rng);
+            PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+            PathFindingResult result = finder.FindPath(*map, start, goal, EPathFindingMode::LazyThetaStar);
+
+            CHECK((result.Status == EPathFindingStatus::Found) == (GetShortestPathCost(*map, start, goal) >= 0));
+            if (result.Status != EPathFindingStatus::Found)
+            {
+                continue;
+            }
+
+            const Path& waypoints = result.FoundPath;
+            CHECK(waypoints.front() == start);
+            CHECK(waypoints.back() == goal);
+
+            /* Agents walk lines between waypoints cell by cell, so every cell has to be walkable */
+            bool bSeeEachOther = true;
+            bool bLinesWalkable = true;
+            for (size_t k = 1; k < waypoints.size(); ++k)
+            {
+                bSeeEachOther = bSeeEachOther && HasLineOfSight(*map, waypoints[k - 1], waypoints[k]);
+
+                for (int32_t step = 1; step <= GetLineLength(waypoints[k - 1], waypoints[k]); ++step)
+                {
+                    bLinesWalkable = bLinesWalkable && IsWalkable(GetLinePoint(waypoints[k - 1], waypoints[k], step), map.get());
+                }
+            }
+
+            CHECK(bSeeEachOther);
+            CHECK(bLinesWalkable);
+        }
+    }
+}
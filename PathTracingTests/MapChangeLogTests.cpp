@@ -0,0 +1,65 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "MapChangeLog.h"
+
+TEST(MapChangeLogWrapsAround)
+{
+    static constexpr size_t Capacity = 5;
+    MapChangeLog changeLog(Capacity);
+    std::vector<glm::ivec2> logged;
+    std::vector<glm::ivec2> changes;
+
+    /* Several times around ring buffer, every revision still remembered is asked for */
+    for (int32_t i = 0; i < 23; ++i)
+    {
+        glm::ivec2 position{i, i * 3 % 7};
+        changeLog.LogChange(position);
+        logged.push_back(position);
+        CHECK(changeLog.GetRevision() == logged.size());
+
+        for (uint64_t revision = 0; revision <= logged.size(); ++revision)
+        {
+            changes.clear();
+            bool bRemembered = logged.size() - revision <= Capacity;
+            CHECK(changeLog.GetChangesSince(revision, changes) == bRemembered);
+
+            if (bRemembered)
+            {
+                CHECK(changes == std::vector<glm::ivec2>(logged.begin() + revision, logged.end()));
+            }
+        }
+
+        changes.clear();
+        CHECK(!changeLog.GetChangesSince(logged.size() + 1, changes));
+    }
+
+    /* Appends to positions already there */
+    changes.assign(1, glm::ivec2(-1, -1));
+    CHECK(changeLog.GetChangesSince(logged.size() - 1, changes));
+    CHECK(changes.size() == 2 && changes.back() == logged.back());
+}
+
+TEST(MapChangesSinceDetectsResize)
+{
+    std::shared_ptr<TestMap> map = TestMap::Create(8, 6);
+    std::vector<glm::ivec2> changes{{1, 1}};
+
+    map->SetField({2, 3}, EFieldType::Obstacle);
+    CHECK(GetMapChangesSince(*map, 8, 6, 0, changes));
+    CHECK(changes.size() == 1 && changes[0] == glm::ivec2(2, 3));
+
+    /* Data built for other size has to be rebuilt even when log reaches far enough */
+    CHECK(!GetMapChangesSince(*map, 8, 7, 0, changes));
+    CHECK(!GetMapChangesSince(*map, 9, 6, 0, changes));
+    CHECK(!GetMapChangesSince(*map, 8, 6, 2, changes));
+
+    /* Map log has default capacity, so edits beyond it force rebuild */
+    for (size_t i = 0; i < MapChangeLog::DefaultCapacity; ++i)
+    {
+        map->SetTerrainCost({static_cast<int32_t>(i % 8), 0}, static_cast<uint8_t>(DefaultTerrainCost + 1 + i / 8 % 2));
+    }
+    CHECK(!GetMapChangesSince(*map, 8, 6, 0, changes));
+    CHECK(GetMapChangesSince(*map, 8, 6, 1, changes));
+    CHECK(changes.size() == MapChangeLog::DefaultCapacity);
+}
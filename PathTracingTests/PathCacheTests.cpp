@@ -0,0 +1,104 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "PathCache.h"
+#include "PathFinder.h"
+
+#include <random>
+
+static void CheckCacheFollowsEdits(ENeighborhood neighborhood, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 32, 32, 0.2f, true);
+    std::uniform_int_distribution<int32_t> coordinate(0, 31);
+    std::uniform_int_distribution<int32_t> cost(DefaultTerrainCost, 6);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    /* Few queries asked over and over, so most lookups find entry made before some edits */
+    std::vector<std::pair<PathFindingPoint, PathFindingPoint>> queries;
+    for (int32_t i = 0; i < 12; ++i)
+    {
+        queries.emplace_back(map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+    }
+
+    auto isQueryEnd = [&](PathFindingPoint point)
+    {
+        for (const std::pair<PathFindingPoint, PathFindingPoint>& query : queries)
+        {
+            if (point == query.first || point == query.second)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    PathCache pathCache;
+    PathFinder pathFinder;
+    size_t numHits = 0;
+
+    for (int32_t step = 0; step < 3000; ++step)
+    {
+        /* Query ends stay walkable, cache does not track cells its keys start on */
+        glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+        if (!isQueryEnd(cell))
+        {
+            float roll = chance(rng);
+            if (roll < 0.25f)
+            {
+                map->SetField(cell, EFieldType::Obstacle);
+            }
+            else if (roll < 0.35f)
+            {
+                map->SetField(cell, EFieldType::Player);
+            }
+            else if (roll < 0.7f)
+            {
+                map->SetField(cell, EFieldType::Empty);
+            }
+            else
+            {
+                map->SetTerrainCost(cell, static_cast<uint8_t>(cost(rng)));
+            }
+        }
+
+        pathCache.Update(*map);
+
+        const std::pair<PathFindingPoint, PathFindingPoint>& query = queries[rng() % queries.size()];
+        PathFindingResult expected = pathFinder.FindPath(*map, query.first, query.second, EPathFindingMode::AStar, neighborhood);
+
+        if (const CompactPath* cachedPath = pathCache.Find(query.first, query.second, EPathFindingMode::AStar, neighborhood))
+        {
+            ++numHits;
+            Path path = cachedPath->Expand();
+
+            CHECK(expected.Status == EPathFindingStatus::Found);
+            CHECK(IsValidPath(*map, path, query.first, query.second, neighborhood));
+            CHECK(GetPathCost(*map, path, neighborhood) == GetPathCost(*map, expected.FoundPath, neighborhood));
+        }
+        else if (expected.Status == EPathFindingStatus::Found)
+        {
+            pathCache.Insert(*map, query.first, query.second, EPathFindingMode::AStar, neighborhood,
+                CompactPath(expected.FoundPath));
+        }
+    }
+
+    /* Test is only meaningful when cached paths outlive some edits */
+    CHECK(numHits > 300);
+}
+
+TEST(PathCacheFollowsEditsFour)
+{
+    CheckCacheFollowsEdits(ENeighborhood::Four, 15);
+}
+
+TEST(PathCacheFollowsEditsEight)
+{
+    CheckCacheFollowsEdits(ENeighborhood::Eight, 16);
+}
+
+TEST(PathCacheFollowsEditsHex)
+{
+    CheckCacheFollowsEdits(ENeighborhood::Hex, 17);
+}
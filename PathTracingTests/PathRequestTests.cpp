@@ -0,0 +1,311 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "MapSnapshot.h"
+#include "PathCache.h"
+#include "PathFinder.h"
+
+#include <future>
+#include <random>
+#include <thread>
+
+/* Sets up static interface for one test and tears it down afterwards */
+struct ScopedPathFinding
+{
+    ScopedPathFinding()
+    {
+        PathFindingAlgorithm::Initialize();
+    }
+
+    ~ScopedPathFinding()
+    {
+        PathFindingAlgorithm::Quit();
+    }
+};
+
+TEST(RequestResultGoesToPathCache)
+{
+    std::mt19937 rng(21);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 64, 64, 0.2f, true);
+    ScopedPathFinding pathFinding;
+    PathCache& pathCache = PathFindingAlgorithm::GetPathCache();
+
+    for (float suboptimalityBound : {1.0f, 1.5f})
+    {
+        PathFindingPoint start = map->GetRandomWalkableCell(rng);
+        PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+        while (!map->AreConnected(start, goal))
+        {
+            goal = map->GetRandomWalkableCell(rng);
+        }
+
+        pathCache.Clear();
+        pathCache.ResetStats();
+        PathFindingResult result = PathFindingAlgorithm::RequestPath(start, goal, ENeighborhood::Four,
+            EOpenList::BinaryHeap, suboptimalityBound).Get();
+        CHECK(result.Status == EPathFindingStatus::Found);
+        CHECK(pathCache.GetSize() == 1);
+
+        /* Same request is answered from cache without worker */
+        PathRequest request = PathFindingAlgorithm::RequestPath(start, goal, ENeighborhood::Four,
+            EOpenList::BinaryHeap, suboptimalityBound);
+        CHECK(request.IsReady());
+        CHECK(request.Get().FoundPath == result.FoundPath);
+        CHECK(pathCache.GetStats().Hits == 1);
+
+        /* Path found on map edited before it was taken is dropped */
+        pathCache.Clear();
+        request = PathFindingAlgorithm::RequestPath(start, goal, ENeighborhood::Four, EOpenList::BinaryHeap, suboptimalityBound);
+        PathFindingPoint editedCell = map->GetRandomWalkableCell(rng);
+        map->SetTerrainCost(editedCell, map->GetTerrainCost(editedCell) + 1);
+        CHECK(request.Get().Status == EPathFindingStatus::Found);
+        CHECK(pathCache.GetSize() == 0);
+    }
+}
+
+TEST(BoundedRequestCountsOneLookup)
+{
+    std::mt19937 rng(25);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 64, 64, 0.2f, false);
+    ScopedPathFinding pathFinding;
+    PathCache& pathCache = PathFindingAlgorithm::GetPathCache();
+
+    PathFindingPoint start = map->GetRandomWalkableCell(rng);
+    PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+    while (!map->AreConnected(start, goal))
+    {
+        goal = map->GetRandomWalkableCell(rng);
+    }
+
+    /* Bounded request tries optimal and weighted keys, both miss here */
+    pathCache.ResetStats();
+    PathFindingAlgorithm::RequestPath(start, goal, ENeighborhood::Four, EOpenList::BinaryHeap, 2.0f).Get();
+    CHECK(pathCache.GetStats().Misses == 1);
+    CHECK(pathCache.GetStats().Hits == 0);
+
+    /* Weighted key hits after optimal one missed */
+    PathFindingAlgorithm::RequestPath(start, goal, ENeighborhood::Four, EOpenList::BinaryHeap, 2.0f).Get();
+    CHECK(pathCache.GetStats().Misses == 1);
+    CHECK(pathCache.GetStats().Hits == 1);
+}
+
+TEST(MapSnapshotIgnoresLaterEdits)
+{
+    std::mt19937 rng(20);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 48, 40, 0.25f, true);
+    std::uniform_int_distribution<int32_t> x(0, 47);
+    std::uniform_int_distribution<int32_t> y(0, 39);
+    std::shared_ptr<MapSnapshot> snapshot = std::make_shared<MapSnapshot>(*map);
+
+    for (int32_t round = 0; round < 20; ++round)
+    {
+        std::shared_ptr<TestMap> copy = TestMap::Create(48, 40);
+        for (int32_t cellY = 0; cellY < 40; ++cellY)
+        {
+            for (int32_t cellX = 0; cellX < 48; ++cellX)
+            {
+                copy->SetField({cellX, cellY}, map->GetFieldAt({cellX, cellY}));
+                copy->SetTerrainCost({cellX, cellY}, map->GetTerrainCost({cellX, cellY}));
+            }
+        }
+
+        uint64_t revision = map->GetRevision();
+        for (int32_t i = 0; i < 30; ++i)
+        {
+            glm::ivec2 cell{x(rng), y(rng)};
+            map->SetField(cell, static_cast<EFieldType>(rng() % 3));
+            map->SetTerrainCost(cell, static_cast<uint8_t>(DefaultTerrainCost + rng() % 4));
+        }
+
+        /* Snapshot still shows map as it was, copy holds the same state */
+        CHECK(snapshot->GetRevision() == revision);
+        bool bSameCells = true;
+        for (int32_t i = 0; i < 200; ++i)
+        {
+            glm::ivec2 a{x(rng), y(rng)};
+            glm::ivec2 b{x(rng), y(rng)};
+            bSameCells = bSameCells && snapshot->GetFieldAt(a) == copy->GetFieldAt(a) &&
+                snapshot->GetTerrainCost(a) == copy->GetTerrainCost(a) && snapshot->AreConnected(a, b) == copy->AreConnected(a, b);
+        }
+        CHECK(bSameCells);
+
+        /* Snapshot sharing data with previous one equals snapshot taken from scratch */
+        std::shared_ptr<MapSnapshot> next = std::make_shared<MapSnapshot>(*map, snapshot.get());
+        MapSnapshot fresh(*map);
+        bool bSameAsFresh = next->HasUniformTerrainCost() == fresh.HasUniformTerrainCost();
+        for (int32_t cellY = 0; cellY < 40; ++cellY)
+        {
+            for (int32_t cellX = 0; cellX < 48; ++cellX)
+            {
+                glm::ivec2 a{cellX, cellY};
+                glm::ivec2 b{x(rng), y(rng)};
+                bSameAsFresh = bSameAsFresh && next->GetFieldAt(a) == fresh.GetFieldAt(a) &&
+                    next->GetTerrainCost(a) == fresh.GetTerrainCost(a) && next->AreConnected(a, b) == fresh.AreConnected(a, b);
+            }
+        }
+        CHECK(bSameAsFresh);
+
+        snapshot = next;
+    }
+}
+
+TEST(RequestMatchesSynchronousSearchWhileMapIsEdited)
+{
+    std::mt19937 rng(22);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 96, 96, 0.25f, true);
+    ScopedPathFinding pathFinding;
+    PathFindingAlgorithm::GetPathCache().Clear();
+
+    std::vector<std::pair<PathFindingPoint, PathFindingPoint>> queries;
+    for (int32_t i = 0; i < 60; ++i)
+    {
+        queries.emplace_back(map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+    }
+
+    /* Expected answers are searched on map as it was when requests were made */
+    MapSnapshot requestedMap(*map);
+    PathFinder reference;
+    std::vector<PathFindingResult> expected;
+    std::vector<PathRequest> requests;
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        ENeighborhood neighborhood = static_cast<ENeighborhood>(i % 3);
+        expected.push_back(reference.FindPath(requestedMap, queries[i].first, queries[i].second, EPathFindingMode::AStar,
+            neighborhood));
+        requests.push_back(PathFindingAlgorithm::RequestPath(queries[i].first, queries[i].second, neighborhood));
+    }
+
+    std::uniform_int_distribution<int32_t> coordinate(0, 95);
+    for (int32_t i = 0; i < 5000; ++i)
+    {
+        glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+        map->SetField(cell, static_cast<EFieldType>(rng() % 3));
+        map->SetTerrainCost(cell, static_cast<uint8_t>(DefaultTerrainCost + rng() % 4));
+    }
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        ENeighborhood neighborhood = static_cast<ENeighborhood>(i % 3);
+        PathFindingResult result = requests[i].Get();
+
+        CHECK(!requests[i].IsValid());
+        CHECK(result.Status == expected[i].Status);
+        if (result.Status == EPathFindingStatus::Found && expected[i].Status == EPathFindingStatus::Found)
+        {
+            CHECK(IsValidPath(requestedMap, result.FoundPath, queries[i].first, queries[i].second, neighborhood));
+            CHECK(GetPathCost(requestedMap, result.FoundPath, neighborhood) ==
+                GetPathCost(requestedMap, expected[i].FoundPath, neighborhood));
+        }
+    }
+}
+
+TEST(CancelledSearchEndsEarly)
+{
+    std::mt19937 rng(23);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 512, 512, 0.2f, false);
+    map->SetField({0, 0}, EFieldType::Empty);
+    map->SetField({511, 511}, EFieldType::Empty);
+    PathFindingResult expected = PathFinder().FindPath(*map, {0, 0}, {511, 511});
+
+    PathFinder pathFinder;
+    std::atomic<bool> bCancelled{true};
+    PathFindingResult result = pathFinder.FindPathCancellable(*map, {0, 0}, {511, 511}, ENeighborhood::Four,
+        EOpenList::BinaryHeap, 1.0f, bCancelled);
+    CHECK(result.Status == EPathFindingStatus::Cancelled);
+    CHECK(result.FoundPath.empty());
+    CHECK(result.NodesExpanded == 0);
+
+    /* Flag raised while search runs either stops it or comes after it found path */
+    bCancelled = false;
+    std::thread canceller([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        bCancelled = true;
+    });
+    result = pathFinder.FindPathCancellable(*map, {0, 0}, {511, 511}, ENeighborhood::Four, EOpenList::BinaryHeap,
+        1.0f, bCancelled);
+    canceller.join();
+
+    CHECK(result.Status == EPathFindingStatus::Cancelled || result.Status == expected.Status);
+    if (result.Status == EPathFindingStatus::Cancelled)
+    {
+        CHECK(result.FoundPath.empty());
+        CHECK(result.NodesExpanded < expected.NodesExpanded);
+    }
+
+    /* Searcher is usable again after cancelled query */
+    bCancelled = false;
+    result = pathFinder.FindPathCancellable(*map, {0, 0}, {511, 511}, ENeighborhood::Four, EOpenList::BinaryHeap,
+        1.0f, bCancelled);
+    CHECK(result.Status == expected.Status);
+    CHECK(result.NodesExpanded == expected.NodesExpanded);
+}
+
+TEST(CancelledRequestsFreeWorkers)
+{
+    std::mt19937 rng(24);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 512, 512, 0.2f, false);
+    map->SetField({0, 0}, EFieldType::Empty);
+    map->SetField({511, 511}, EFieldType::Empty);
+    ScopedPathFinding pathFinding;
+
+    /* Many more long requests than workers, all of them dropped before they finish */
+    for (int32_t i = 0; i < 64; ++i)
+    {
+        PathRequest request = PathFindingAlgorithm::RequestPath({0, 0}, {511, 511});
+        request.Cancel();
+        CHECK(!request.IsValid());
+    }
+
+    PathFindingPoint start = map->GetRandomWalkableCell(rng);
+    PathFindingResult expected = PathFinder().FindPath(*map, start, start);
+    PathRequest request = PathFindingAlgorithm::RequestPath(start, start);
+    CHECK(request.Get().Status == expected.Status);
+}
+
+TEST(QuitFulfilsPendingRequests)
+{
+    std::mt19937 rng(25);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 256, 256, 0.2f, true);
+    PathFindingAlgorithm::Initialize();
+
+    std::vector<std::pair<PathFindingPoint, PathFindingPoint>> queries;
+    std::vector<PathRequest> requests;
+    for (int32_t i = 0; i < 40; ++i)
+    {
+        queries.emplace_back(map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+        requests.push_back(PathFindingAlgorithm::RequestPath(queries.back().first, queries.back().second));
+    }
+
+    /* Some requests are dropped, workers must still finish them without anyone waiting */
+    for (size_t i = 0; i < requests.size(); i += 3)
+    {
+        requests[i].Cancel();
+    }
+
+    PathFindingAlgorithm::Quit();
+
+    PathFinder reference;
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        if (!requests[i].IsValid())
+        {
+            continue;
+        }
+
+        PathFindingResult expected = reference.FindPath(*map, queries[i].first, queries[i].second);
+        bool bBrokenPromise = false;
+
+        try
+        {
+            CHECK(requests[i].Get().Status == expected.Status);
+        }
+        catch (const std::future_error&)
+        {
+            bBrokenPromise = true;
+        }
+
+        CHECK(!bBrokenPromise);
+    }
+}
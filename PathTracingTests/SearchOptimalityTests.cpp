@@ -0,0 +1,266 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "ContractionHierarchy.h"
+#include "DStarLite.h"
+#include "JumpPointTable.h"
+#include "LandmarkTable.h"
+#include "PathFinder.h"
+#include "WorkerPool.h"
+
+/* Modes documented to return paths as short as AStar's are checked on random maps,
+   half of them with weighted terrain, against plain Dijkstra */
+static void CheckOptimal(PathFinder& finder, const TestMap& map, PathFindingPoint start, PathFindingPoint goal,
+    EPathFindingMode mode, EOpenList openList = EOpenList::BinaryHeap, ENeighborhood neighborhood = ENeighborhood::Four)
+{
+    PathCost expectedCost = GetShortestPathCost(map, start, goal, neighborhood);
+    PathFindingResult result = finder.FindPath(map, start, goal, mode, neighborhood, openList);
+
+    CHECK((result.Status == EPathFindingStatus::Found) == (expectedCost >= 0));
+
+    if (result.Status == EPathFindingStatus::Found)
+    {
+        CHECK(IsValidPath(map, result.FoundPath, start, goal, neighborhood));
+        CHECK(neighborhood != ENeighborhood::Eight || !CutsCorner(map, result.FoundPath));
+        CHECK(GetPathCost(map, result.FoundPath, neighborhood) == expectedCost);
+    }
+}
+
+static void CheckModeOnRandomMaps(EPathFindingMode mode, uint32_t seed, int32_t maxSize, int32_t numMaps,
+    EOpenList openList = EOpenList::BinaryHeap, WorkerPool* workerPool = nullptr, ENeighborhood neighborhood = ENeighborhood::Four)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> size(8, maxSize);
+
+    for (int32_t i = 0; i < numMaps; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, size(rng), size(rng), 0.25f, i % 2 == 1);
+        PathFinder finder;
+        finder.SetWorkerPool(workerPool);
+
+        for (int32_t j = 0; j < 10; ++j)
+        {
+            CheckOptimal(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng), mode, openList,
+                neighborhood);
+        }
+    }
+}
+
+TEST(AStarIsOptimalEight)
+{
+    CheckModeOnRandomMaps(EPathFindingMode::AStar, 26, 64, 30, EOpenList::BinaryHeap, nullptr, ENeighborhood::Eight);
+    CheckModeOnRandomMaps(EPathFindingMode::AStar, 27, 64, 30, EOpenList::Buckets, nullptr, ENeighborhood::Eight);
+}
+
+TEST(AStarIsOptimalHex)
+{
+    CheckModeOnRandomMaps(EPathFindingMode::AStar, 28, 64, 30, EOpenList::BinaryHeap, nullptr, ENeighborhood::Hex);
+    CheckModeOnRandomMaps(EPathFindingMode::AStar, 29, 64, 30, EOpenList::Buckets, nullptr, ENeighborhood::Hex);
+}
+
+TEST(BucketOpenListIsOptimal)
+{
+    CheckModeOnRandomMaps(EPathFindingMode::AStar, 13, 64, 30, EOpenList::Buckets);
+}
+
+TEST(JumpPointSearchIsOptimal)
+{
+    CheckModeOnRandomMaps(EPathFindingMode::JumpPointSearch, 6, 64, 30);
+}
+
+TEST(JumpPointSearchPlusIsOptimal)
+{
+    std::mt19937 rng(7);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 64, 48, 0.25f, false);
+
+    JumpPointTable table;
+    table.Build(*map);
+
+    PathFinder finder;
+    finder.SetJumpPointTable(&table);
+
+    std::uniform_int_distribution<int32_t> x(0, 63);
+    std::uniform_int_distribution<int32_t> y(0, 47);
+
+    for (int32_t round = 0; round < 10; ++round)
+    {
+        for (int32_t j = 0; j < 20; ++j)
+        {
+            CheckOptimal(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng),
+                EPathFindingMode::JumpPointSearchPlus);
+        }
+
+        /* Table repaired after edits has to give the same answers as freshly built one */
+        for (int32_t i = 0; i < 20; ++i)
+        {
+            glm::ivec2 cell{x(rng), y(rng)};
+            map->SetField(cell, map->GetFieldAt(cell) == EFieldType::Obstacle ? EFieldType::Empty : EFieldType::Obstacle);
+        }
+
+        table.Update(*map);
+    }
+}
+
+TEST(BidirectionalIsOptimal)
+{
+    CheckModeOnRandomMaps(EPathFindingMode::Bidirectional, 10, 64, 30);
+}
+
+TEST(BidirectionalParallelIsOptimal)
+{
+    WorkerPool workerPool(2);
+    CheckModeOnRandomMaps(EPathFindingMode::BidirectionalParallel, 11, 64, 30, EOpenList::BinaryHeap, &workerPool);
+    CheckModeOnRandomMaps(EPathFindingMode::BidirectionalParallel, 12, 64, 10);
+}
+
+TEST(BidirectionalParallelOnBusyPool)
+{
+    std::mt19937 rng(14);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 200, 200, 0.25f, true);
+
+    /* Every worker runs query of its own, so no worker is left to pick backward searches up */
+    WorkerPool workerPool(3);
+    std::vector<PathFinder> finders(workerPool.GetNumTaskSlots());
+    for (PathFinder& finder : finders)
+    {
+        finder.SetWorkerPool(&workerPool);
+    }
+
+    std::vector<std::pair<PathFindingPoint, PathFindingPoint>> queries;
+    for (int32_t i = 0; i < 60; ++i)
+    {
+        queries.emplace_back(map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng));
+    }
+
+    std::vector<PathFindingResult> results(queries.size());
+    workerPool.ParallelFor(queries.size(), [&](uint32_t workerIndex, size_t queryIndex)
+    {
+        results[queryIndex] = finders[workerIndex].FindPath(*map, queries[queryIndex].first, queries[queryIndex].second,
+            EPathFindingMode::BidirectionalParallel);
+    });
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        PathFinder reference;
+        PathFindingResult expected = reference.FindPath(*map, queries[i].first, queries[i].second);
+
+        CHECK(results[i].Status == expected.Status);
+        if (results[i].Status == EPathFindingStatus::Found && expected.Status == EPathFindingStatus::Found)
+        {
+            CHECK(IsValidPath(*map, results[i].FoundPath, queries[i].first, queries[i].second));
+            CHECK(GetPathCost(*map, results[i].FoundPath) == GetPathCost(*map, expected.FoundPath));
+        }
+    }
+}
+
+TEST(LandmarksAreOptimal)
+{
+    std::mt19937 rng(17);
+
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 48, 40, 0.3f, i % 2 == 1);
+
+        LandmarkTable table;
+        table.Build(*map);
+        CHECK(table.IsUsable());
+
+        PathFinder finder;
+        finder.SetLandmarkTable(&table);
+
+        for (int32_t j = 0; j < 20; ++j)
+        {
+            CheckOptimal(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng), EPathFindingMode::Landmarks);
+        }
+    }
+}
+
+TEST(ContractionHierarchyIsOptimal)
+{
+    std::mt19937 rng(18);
+
+    for (int32_t i = 0; i < 6; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 32, 0.25f, i % 2 == 1);
+
+        ContractionHierarchy hierarchy;
+        hierarchy.Build(*map);
+
+        PathFinder finder;
+        finder.SetContractionHierarchy(&hierarchy);
+
+        for (int32_t j = 0; j < 20; ++j)
+        {
+            CheckOptimal(finder, *map, map->GetRandomWalkableCell(rng), map->GetRandomWalkableCell(rng),
+                EPathFindingMode::ContractionHierarchy);
+        }
+    }
+}
+
+TEST(DStarLiteIsOptimalAfterEdits)
+{
+    std::mt19937 rng(9);
+    std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 40, 0.2f, true);
+    std::uniform_int_distribution<int32_t> coordinate(0, 39);
+
+    PathFindingPoint start = map->GetRandomWalkableCell(rng);
+    PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+
+    DStarLite planner;
+    planner.Initialize(*map, start, goal);
+
+    for (int32_t round = 0; round < 20; ++round)
+    {
+        PathFinder reference;
+        PathFindingResult expected = reference.FindPath(*map, start, goal);
+        Path path = planner.ExtractPath().Expand();
+
+        CHECK(path.empty() == (expected.Status != EPathFindingStatus::Found));
+
+        if (!path.empty() && expected.Status == EPathFindingStatus::Found)
+        {
+            CHECK(IsValidPath(*map, path, start, goal));
+            CHECK(GetPathCost(*map, path) == GetPathCost(*map, expected.FoundPath));
+
+            /* Agent walks few steps before map changes under it */
+            start = path[std::min<size_t>(3, path.size() - 1)];
+        }
+
+        for (int32_t i = 0; i < 15; ++i)
+        {
+            glm::ivec2 cell{coordinate(rng), coordinate(rng)};
+            if (cell == start || cell == goal)
+            {
+                continue;
+            }
+
+            map->SetField(cell, map->GetFieldAt(cell) == EFieldType::Obstacle ? EFieldType::Empty : EFieldType::Obstacle);
+        }
+
+        planner.Replan(*map, start);
+    }
+}
+
+TEST(MemoryBoundedSearchesAreOptimal)
+{
+    std::mt19937 rng(24);
+
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 14, 12, 0.2f, i % 2 == 1);
+
+        /* Budget holds every cell, so SMA* never has to settle for shorter path that fits */
+        PathFinder finder;
+        finder.SetSearchMemoryBudget(1 << 20);
+        finder.SetMemoryBoundedExpansionLimit(1'000'000);
+
+        for (int32_t j = 0; j < 5; ++j)
+        {
+            PathFindingPoint start = map->GetRandomWalkableCell(rng);
+            PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+
+            CheckOptimal(finder, *map, start, goal, EPathFindingMode::IterativeDeepening);
+            CheckOptimal(finder, *map, start, goal, EPathFindingMode::SMAStar);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "TestFramework.h"
+#include "TestMap.h"
+
+#include "PathFinder.h"
+
+#include <random>
+
+/* Sliced search stepped with tiny budgets has to end exactly like query run in one go */
+static void CheckSlicedMatchesOneShot(ENeighborhood neighborhood, EOpenList openList, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+
+    for (int32_t i = 0; i < 6; ++i)
+    {
+        std::shared_ptr<TestMap> map = TestMap::CreateRandom(rng, 40, 32, 0.3f, i % 2 == 1);
+        PathFinder oneShot;
+        PathFinder sliced;
+
+        for (int32_t j = 0; j < 10; ++j)
+        {
+            PathFindingPoint start = map->GetRandomWalkableCell(rng);
+            PathFindingPoint goal = map->GetRandomWalkableCell(rng);
+            PathFindingResult expected = oneShot.FindPath(*map, start, goal, EPathFindingMode::AStar, neighborhood, openList);
+
+            for (size_t maxExpansions = 1; maxExpansions <= 7; ++maxExpansions)
+            {
+                PathFindingResult result{sliced.StartSlicedSearch(*map, start, goal, neighborhood, openList)};
+                SearchBudget budget;
+                budget.MaxExpansions = maxExpansions;
+                size_t nodesExpanded = 0;
+                bool bWithinBudget = true;
+
+                while (result.Status == EPathFindingStatus::InProgress)
+                {
+                    result = sliced.ContinueSlicedSearch(*map, budget);
+                    bWithinBudget = bWithinBudget && result.NodesExpanded <= maxExpansions;
+                    nodesExpanded += result.NodesExpanded;
+                }
+
+                CHECK(bWithinBudget);
+                CHECK(result.Status == expected.Status);
+                CHECK(nodesExpanded == expected.NodesExpanded);
+
+                if (result.Status == EPathFindingStatus::Found && expected.Status == EPathFindingStatus::Found)
+                {
+                    CHECK(IsValidPath(*map, result.FoundPath, start, goal, neighborhood));
+                    CHECK(GetPathCost(*map, result.FoundPath, neighborhood) == GetPathCost(*map, expected.FoundPath, neighborhood));
+                }
+            }
+        }
+    }
+}
+
+TEST(SlicedSearchMatchesOneShotFour)
+{
+    CheckSlicedMatchesOneShot(ENeighborhood::Four, EOpenList::BinaryHeap, 19);
+    CheckSlicedMatchesOneShot(ENeighborhood::Four, EOpenList::Buckets, 20);
+}
+
+TEST(SlicedSearchMatchesOneShotEight)
+{
+    CheckSlicedMatchesOneShot(ENeighborhood::Eight, EOpenList::BinaryHeap, 21);
+    CheckSlicedMatchesOneShot(ENeighborhood::Eight, EOpenList::Buckets, 22);
+}
+
+TEST(SlicedSearchMatchesOneShotHex)
+{
+    CheckSlicedMatchesOneShot(ENeighborhood::Hex, EOpenList::BinaryHeap, 23);
+    CheckSlicedMatchesOneShot(ENeighborhood::Hex, EOpenList::Buckets, 24);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+/* Minimal registry of tests and benchmarks. TEST and BENCHMARK define function
+   TestMain.cpp runs, CHECK reports failed condition and lets test go on */
+struct TestCase
+{
+    const char* Name;
+    void (*Func)();
+};
+
+std::vector<TestCase>& GetTests();
+std::vector<TestCase>& GetBenchmarks();
+
+void ReportFailure(const char* file, int line, const char* condition);
+
+struct TestRegistrar
+{
+    TestRegistrar(std::vector<TestCase>& cases, const char* name, void (*func)())
+    {
+        cases.push_back({name, func});
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(GetTests(), #name, name); \
+    static void name()
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(GetBenchmarks(), #name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ReportFailure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
@@ -0,0 +1,54 @@
+#include "TestFramework.h"
+
+#include <cstdio>
+#include <cstring>
+
+static int s_NumFailures = 0;
+
+std::vector<TestCase>& GetTests()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+std::vector<TestCase>& GetBenchmarks()
+{
+    static std::vector<TestCase> benchmarks;
+    return benchmarks;
+}
+
+void ReportFailure(const char* file, int line, const char* condition)
+{
+    std::printf("    %s(%d): CHECK(%s) failed\n", file, line, condition);
+    ++s_NumFailures;
+}
+
+/* Runs every test, or every benchmark with --benchmark. Name given after that runs only cases containing it */
+int main(int argc, char** argv)
+{
+    bool bBenchmark = argc > 1 && std::strcmp(argv[1], "--benchmark") == 0;
+    const char* filter = argc > (bBenchmark ? 2 : 1) ? argv[bBenchmark ? 2 : 1] : nullptr;
+
+    int numRun = 0;
+    int numFailed = 0;
+
+    for (const TestCase& testCase : bBenchmark ? GetBenchmarks() : GetTests())
+    {
+        if (filter && !std::strstr(testCase.Name, filter))
+        {
+            continue;
+        }
+
+        std::printf("%s\n", testCase.Name);
+        std::fflush(stdout);
+
+        int failuresBefore = s_NumFailures;
+        testCase.Func();
+
+        ++numRun;
+        numFailed += s_NumFailures != failuresBefore;
+    }
+
+    std::printf("%d of %d %s passed\n", numRun - numFailed, numRun, bBenchmark ? "benchmarks" : "tests");
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+#include "TestMap.h"
+#include "Neighborhood.h"
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <queue>
+
+TestMap::TestMap(int32_t width, int32_t height) :
+    m_Fields(static_cast<size_t>(width) * height, EFieldType::Empty),
+    m_TerrainCosts(static_cast<size_t>(width) * height, DefaultTerrainCost),
+    m_Width(width),
+    m_Height(height)
+{
+    m_Components.Reset(width, height);
+}
+
+TestMap::~TestMap() noexcept
+{
+}
+
+std::shared_ptr<TestMap> TestMap::Create(int32_t width, int32_t height)
+{
+    std::shared_ptr<TestMap> map = std::make_shared<TestMap>(width, height);
+    s_Instance = map;
+    return map;
+}
+
+std::shared_ptr<TestMap> TestMap::CreateRandom(std::mt19937& rng, int32_t width, int32_t height,
+    float obstacleRatio, bool bWeighted)
+{
+    std::shared_ptr<TestMap> map = Create(width, height);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::uniform_int_distribution<int32_t> cost(DefaultTerrainCost + 1, 6);
+
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            if (chance(rng) < obstacleRatio)
+            {
+                map->SetField({x, y}, EFieldType::Obstacle);
+            }
+            else if (bWeighted && chance(rng) < 0.2f)
+            {
+                map->SetTerrainCost({x, y}, static_cast<uint8_t>(cost(rng)));
+            }
+        }
+    }
+
+    return map;
+}
+
+EFieldType TestMap::GetFieldAt(glm::ivec2 gridPosition) const
+{
+    return m_Fields[gridPosition.x + gridPosition.y * m_Width];
+}
+
+void TestMap::SetField(glm::ivec2 gridPosition, EFieldType field)
+{
+    EFieldType& current = m_Fields[gridPosition.x + gridPosition.y * m_Width];
+
+    if (current == field)
+    {
+        return;
+    }
+
+    bool bWasObstacle = current == EFieldType::Obstacle;
+    current = field;
+
+    if (bWasObstacle != (field == EFieldType::Obstacle))
+    {
+        m_Components.SetPassable(gridPosition, bWasObstacle);
+    }
+
+    m_ChangeLog.LogChange(gridPosition);
+}
+
+const EFieldType* TestMap::GetFieldData() const
+{
+    return m_Fields.data();
+}
+
+uint8_t TestMap::GetTerrainCost(glm::ivec2 gridPosition) const
+{
+    return m_TerrainCosts[gridPosition.x + gridPosition.y * m_Width];
+}
+
+void TestMap::SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost)
+{
+    assert(cost >= DefaultTerrainCost);
+    uint8_t& currentCost = m_TerrainCosts[gridPosition.x + gridPosition.y * m_Width];
+
+    if (currentCost == cost)
+    {
+        return;
+    }
+
+    m_NumWeightedCells += (cost != DefaultTerrainCost) - (currentCost != DefaultTerrainCost);
+    currentCost = cost;
+
+    m_ChangeLog.LogChange(gridPosition);
+}
+
+const uint8_t* TestMap::GetTerrainCostData() const
+{
+    return m_TerrainCosts.data();
+}
+
+bool TestMap::HasUniformTerrainCost() const
+{
+    return m_NumWeightedCells == 0;
+}
+
+bool TestMap::AreConnected(glm::ivec2 a, glm::ivec2 b) const
+{
+    return m_Components.AreConnected(a, b);
+}
+
+const ComponentLabels* TestMap::GetComponentLabels() const
+{
+    return &m_Components;
+}
+
+int32_t TestMap::GetMapWidth() const
+{
+    return m_Width;
+}
+
+int32_t TestMap::GetMapHeight() const
+{
+    return m_Height;
+}
+
+uint64_t TestMap::GetRevision() const
+{
+    return m_ChangeLog.GetRevision();
+}
+
+bool TestMap::GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const
+{
+    return m_ChangeLog.GetChangesSince(revision, outPositions);
+}
+
+FieldsByPositionIterator TestMap::begin() const
+{
+    return FieldsByPositionIterator{this, glm::ivec2(0, 0)};
+}
+
+FieldsByPositionIterator TestMap::end() const
+{
+    return FieldsByPositionIterator{this, glm::ivec2(0, m_Height)};
+}
+
+float TestMap::GetCellSize() const
+{
+    return 1.0f;
+}
+
+PathFindingPoint TestMap::GetRandomWalkableCell(std::mt19937& rng) const
+{
+    std::uniform_int_distribution<int32_t> x(0, m_Width - 1);
+    std::uniform_int_distribution<int32_t> y(0, m_Height - 1);
+
+    while (true)
+    {
+        PathFindingPoint point{x(rng), y(rng)};
+        if (IsWalkable(point, this))
+        {
+            return point;
+        }
+    }
+}
+
+template<typename TNeighborhood>
+static PathCost GetStepCost(const IMap& map, PathFindingPoint from, PathFindingPoint to)
+{
+    PathCost stepCost = -1;
+
+    ForEachNeighbor<TNeighborhood>(map, from, [&](PathFindingPoint neighbor, PathCost cost)
+    {
+        if (neighbor == to)
+        {
+            stepCost = cost;
+            return false;
+        }
+
+        return true;
+    });
+
+    return stepCost;
+}
+
+PathCost GetPathCost(const IMap& map, const Path& path, ENeighborhood neighborhood)
+{
+    if (path.empty())
+    {
+        return -1;
+    }
+
+    PathCost cost = 0;
+
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        PathCost stepCost = neighborhood == ENeighborhood::Eight ? GetStepCost<EightConnected>(map, path[i - 1], path[i]) :
+            neighborhood == ENeighborhood::Hex ? GetStepCost<HexConnected>(map, path[i - 1], path[i]) :
+            GetStepCost<FourConnected>(map, path[i - 1], path[i]);
+
+        if (stepCost < 0)
+        {
+            return -1;
+        }
+
+        cost += stepCost;
+    }
+
+    return cost;
+}
+
+bool IsValidPath(const IMap& map, const Path& path, PathFindingPoint start, PathFindingPoint goal, ENeighborhood neighborhood)
+{
+    return !path.empty() && path.front() == start && path.back() == goal && GetPathCost(map, path, neighborhood) >= 0;
+}
+
+/* Moves listed apart from Neighborhood.h, so reference does not share mistakes with searches */
+static std::span<const NeighborOffset> GetReferenceMoves(ENeighborhood neighborhood, int32_t row)
+{
+    static constexpr NeighborOffset FourMoves[] = {{-1, 0, 1}, {1, 0, 1}, {0, -1, 1}, {0, 1, 1}};
+    static constexpr NeighborOffset EightMoves[] = {
+        {-1, 0, 10}, {1, 0, 10}, {0, -1, 10}, {0, 1, 10}, {-1, -1, 14}, {1, -1, 14}, {-1, 1, 14}, {1, 1, 14}
+    };
+    static constexpr NeighborOffset EvenRowHexMoves[] = {{-1, 0, 1}, {1, 0, 1}, {-1, -1, 1}, {0, -1, 1}, {-1, 1, 1}, {0, 1, 1}};
+    static constexpr NeighborOffset OddRowHexMoves[] = {{-1, 0, 1}, {1, 0, 1}, {0, -1, 1}, {1, -1, 1}, {0, 1, 1}, {1, 1, 1}};
+
+    switch (neighborhood)
+    {
+    case ENeighborhood::Eight:
+        return EightMoves;
+    case ENeighborhood::Hex:
+        return row % 2 == 0 ? std::span<const NeighborOffset>(EvenRowHexMoves) : std::span<const NeighborOffset>(OddRowHexMoves);
+    case ENeighborhood::Four:
+    default:
+        return FourMoves;
+    }
+}
+
+PathCost GetShortestPathCost(const IMap& map, PathFindingPoint start, PathFindingPoint goal, ENeighborhood neighborhood)
+{
+    int32_t width = map.GetMapWidth();
+    std::vector<PathCost> costs(static_cast<size_t>(width) * map.GetMapHeight(), std::numeric_limits<PathCost>::max());
+
+    typedef std::pair<PathCost, int32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    costs[start.x + start.y * width] = 0;
+    open.push({0, start.x + start.y * width});
+
+    while (!open.empty())
+    {
+        auto [cost, cell] = open.top();
+        open.pop();
+
+        if (cost != costs[cell])
+        {
+            continue;
+        }
+
+        PathFindingPoint point{cell % width, cell / width};
+        if (point == goal)
+        {
+            return cost;
+        }
+
+        for (NeighborOffset move : GetReferenceMoves(neighborhood, point.y))
+        {
+            PathFindingPoint neighbor{point.x + move.X, point.y + move.Y};
+            if (!IsWalkable(neighbor, &map))
+            {
+                continue;
+            }
+
+            /* Diagonal move must not cut corner of obstacle or agent */
+            if (neighborhood == ENeighborhood::Eight && move.X != 0 && move.Y != 0 &&
+                (!IsWalkable({neighbor.x, point.y}, &map) || !IsWalkable({point.x, neighbor.y}, &map)))
+            {
+                continue;
+            }
+
+            int32_t neighborCell = neighbor.x + neighbor.y * width;
+            PathCost neighborCost = cost + move.Cost * map.GetTerrainCost(neighbor);
+            if (neighborCost < costs[neighborCell])
+            {
+                costs[neighborCell] = neighborCost;
+                open.push({neighborCost, neighborCell});
+            }
+        }
+    }
+
+    return -1;
+}
+
+bool CutsCorner(const IMap& map, const Path& path)
+{
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        PathFindingPoint from = path[i - 1];
+        PathFindingPoint to = path[i];
+
+        if (from.x != to.x && from.y != to.y && (!IsWalkable({to.x, from.y}, &map) || !IsWalkable({from.x, to.y}, &map)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "PathFindingAlgorithm.h"
+#include "ComponentLabels.h"
+#include "MapChangeLog.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+/* Map without rendering, so tests run without window or GL context. Keeps
+   fields, terrain costs, component labels and change log the way Map does */
+class TestMap : public IMap
+{
+public:
+    TestMap(int32_t width, int32_t height);
+    ~TestMap() noexcept;
+
+    /* Map becomes IMap::GetInstance(), replacing map created before */
+    static std::shared_ptr<TestMap> Create(int32_t width, int32_t height);
+
+    /* Obstacles cover about obstacleRatio of cells, weighted map gets random terrain on fifth of them */
+    static std::shared_ptr<TestMap> CreateRandom(std::mt19937& rng, int32_t width, int32_t height,
+        float obstacleRatio, bool bWeighted);
+
+public:
+    virtual EFieldType GetFieldAt(glm::ivec2 gridPosition) const override;
+    virtual void SetField(glm::ivec2 gridPosition, EFieldType field) override;
+    virtual const EFieldType* GetFieldData() const override;
+
+    virtual uint8_t GetTerrainCost(glm::ivec2 gridPosition) const override;
+    virtual void SetTerrainCost(glm::ivec2 gridPosition, uint8_t cost) override;
+    virtual const uint8_t* GetTerrainCostData() const override;
+    virtual bool HasUniformTerrainCost() const override;
+
+    virtual bool AreConnected(glm::ivec2 a, glm::ivec2 b) const override;
+    virtual const ComponentLabels* GetComponentLabels() const override;
+
+    virtual int32_t GetMapWidth() const override;
+    virtual int32_t GetMapHeight() const override;
+
+    virtual uint64_t GetRevision() const override;
+    virtual bool GetChangesSince(uint64_t revision, std::vector<glm::ivec2>& outPositions) const override;
+
+    virtual FieldsByPositionIterator begin() const override;
+    virtual FieldsByPositionIterator end() const override;
+
+    virtual float GetCellSize() const override;
+
+    /* Random cell agents can stand on, map must have at least one */
+    PathFindingPoint GetRandomWalkableCell(std::mt19937& rng) const;
+
+private:
+    std::vector<EFieldType> m_Fields;
+    std::vector<uint8_t> m_TerrainCosts;
+    size_t m_NumWeightedCells = 0;
+    ComponentLabels m_Components;
+    int32_t m_Width;
+    int32_t m_Height;
+    MapChangeLog m_ChangeLog;
+};
+
+/* Cost of path under costs of neighborhood, -1 when path is empty, leaves map or
+   makes step that is not allowed move of neighborhood */
+PathCost GetPathCost(const IMap& map, const Path& path, ENeighborhood neighborhood = ENeighborhood::Four);
+
+/* Path leads from start to goal and every step is allowed move of neighborhood */
+bool IsValidPath(const IMap& map, const Path& path, PathFindingPoint start, PathFindingPoint goal,
+    ENeighborhood neighborhood = ENeighborhood::Four);
+
+/* Cost of cheapest path by plain Dijkstra, -1 when goal can not be reached. Diagonal moves
+   of 8-connected grid need both cells they pass by walkable */
+PathCost GetShortestPathCost(const IMap& map, PathFindingPoint start, PathFindingPoint goal,
+    ENeighborhood neighborhood = ENeighborhood::Four);
+
+/* Path on 8-connected grid makes diagonal step past cell that is not walkable */
+bool CutsCorner(const IMap& map, const Path& path);
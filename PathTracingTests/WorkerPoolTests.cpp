@@ -0,0 +1,73 @@
+#include "TestFramework.h"
+
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+TEST(ParallelForRunsEveryItemOnce)
+{
+    WorkerPool workerPool(4);
+
+    /* Small batches back to back, so workers often wake up to batch that is already done */
+    for (size_t numItems = 1; numItems < 200; ++numItems)
+    {
+        std::vector<std::atomic<int32_t>> runs(numItems);
+        std::atomic<int32_t> numBadIndices{0};
+
+        workerPool.ParallelFor(numItems, [&](uint32_t workerIndex, size_t itemIndex)
+        {
+            if (workerIndex >= workerPool.GetNumTaskSlots())
+            {
+                ++numBadIndices;
+            }
+
+            ++runs[itemIndex];
+        });
+
+        CHECK(numBadIndices == 0);
+        for (const std::atomic<int32_t>& run : runs)
+        {
+            CHECK(run == 1);
+        }
+    }
+}
+
+TEST(ParallelForDoesNotWaitForJobs)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int32_t> numStarted{0};
+    std::atomic<int32_t> numTimedOut{0};
+    std::atomic<int32_t> numItemsRun{0};
+
+    {
+        WorkerPool workerPool(2);
+
+        /* Both workers are stuck in job until batch returns */
+        for (uint32_t i = 0; i < workerPool.GetNumWorkers(); ++i)
+        {
+            workerPool.Submit([&](uint32_t)
+            {
+                ++numStarted;
+                if (released.wait_for(std::chrono::seconds(5)) == std::future_status::timeout)
+                {
+                    ++numTimedOut;
+                }
+            });
+        }
+
+        while (numStarted < 2)
+        {
+            std::this_thread::yield();
+        }
+
+        workerPool.ParallelFor(4, [&](uint32_t, size_t) { ++numItemsRun; });
+        release.set_value();
+    }
+
+    CHECK(numItemsRun == 4);
+    CHECK(numTimedOut == 0);
+}